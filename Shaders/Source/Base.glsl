@@ -19,12 +19,15 @@ layout (set = 1, binding = 0) uniform PerView {
     mat4 projInv;
 } perView;
 
+/// Dynamic uniform buffer, every object is a slice of the per frame uniform ring
 layout (set = 2, binding = 0) uniform PerObj {
     mat4 meshToModel;
     mat4 meshToModelInv;
     mat4 modelToWorld;
     mat4 modelToWorldInv;
     vec4 color;
+    /// Bindless heap indices, x - diffuse, y - normals, z - metallic/roughness textures; w - sampler
+    uvec4 materialIndices;
 } perObj;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef BINDLESS_GLSL
+#define BINDLESS_GLSL
+
+/// Needs GL_EXT_nonuniform_qualifier enabled by the including shader
+/// Mirrors VK::BindlessHeap: the bindings are in EBindlessType order and are indexed with BindlessHandle::index
+
+#define SHIFT_BINDLESS_SET 3
+#define SHIFT_INVALID_BINDLESS_INDEX 0xFFFFFFFFu
+
+layout (set = SHIFT_BINDLESS_SET, binding = 0) uniform texture2D g_textures[];
+layout (set = SHIFT_BINDLESS_SET, binding = 1) uniform sampler g_samplers[];
+
+/// Raw storage, shaders reinterpret the words for the data they put there
+layout (set = SHIFT_BINDLESS_SET, binding = 2) readonly buffer BindlessBuffer {
+    uint words[];
+} g_buffers[];
+
+/// The indices can differ within a draw (e.g. material ids from a buffer), so they are always nonuniform
+vec4 SampleBindless(uint textureIdx, uint samplerIdx, vec2 uv) {
+    return texture(sampler2D(g_textures[nonuniformEXT(textureIdx)], g_samplers[nonuniformEXT(samplerIdx)]), uv);
+}
+
+#endif // BINDLESS_GLSL
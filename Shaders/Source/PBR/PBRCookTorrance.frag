@@ -1,9 +1,11 @@
 #version 450
 
 #extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_nonuniform_qualifier : require
 
 #include "../Base.glsl"
 #include "../Lights.glsl"
+#include "../Bindless.glsl"
 
 #include "CookTorrance.glsl"
 
@@ -14,19 +16,16 @@ layout(location = 3) in mat3 TBN;
 
 layout(location = 0) out vec4 outColor;
 
-layout(set = 2, binding = 1) uniform sampler2D TexDiffuse;
-layout(set = 2, binding = 2) uniform sampler2D TexNormals;
-layout(set = 2, binding = 3) uniform sampler2D TexMetallicRoughness;
-
 void main() {
-    vec4 colorTex = texture(TexDiffuse, fragTexCoord);
+    uint samplerIdx = perObj.materialIndices.w;
+    vec4 colorTex = SampleBindless(perObj.materialIndices.x, samplerIdx, fragTexCoord);
     vec3 albedo = colorTex.rgb;
-    vec3 micNorm = texture(TexNormals, fragTexCoord).rgb;
+    vec3 micNorm = SampleBindless(perObj.materialIndices.y, samplerIdx, fragTexCoord).rgb;
     micNorm = micNorm * 2.0 - 1.0;
     micNorm = normalize(TBN * micNorm);
     micNorm = normalize(outWorldNorm + micNorm);
     //micNorm = outWorldNorm;
-    vec3 MetRough = ToLinear(texture(TexMetallicRoughness, fragTexCoord).rgb);
+    vec3 MetRough = ToLinear(SampleBindless(perObj.materialIndices.z, samplerIdx, fragTexCoord).rgb);
 
     float metallic = clamp(MetRough.b, 0.05f, 0.99f);
     float roughness = clamp(MetRough.g, 0.05f, 0.99f);
@@ -10,6 +10,67 @@ namespace Shift {
         static constexpr uint32_t DIRECTIONAL_LIGHT_MAX_COUNT = 2;
         static constexpr uint32_t POINT_LIGHT_MAX_COUNT = 6;
         static constexpr uint32_t SHIFT_MAX_FRAMES_IN_FLIGHT = 2;
+        //! Threads that can record commands in parallel, each gets its own command pool per frame in flight
+        static constexpr uint32_t SHIFT_RECORDING_WORKER_COUNT = 4;
+        //! Draws the recording benchmark splits over 1..SHIFT_RECORDING_WORKER_COUNT workers at startup, 0 to skip it,
+        //! and the runs per worker count (the fastest is logged)
+        static constexpr uint32_t SHIFT_RECORDING_BENCHMARK_DRAWS = 0;
+        static constexpr uint32_t SHIFT_RECORDING_BENCHMARK_REPEATS = 5;
+        //! Every pipeline layout gets one push constant range of this size, 128 is the minimum the spec guarantees
+        static constexpr uint32_t SHIFT_PUSH_CONSTANT_SIZE = 128;
+
+        //! Uniform buffers of this set (PerObj in Base.glsl) are dynamic and come from the per frame uniform ring
+        static constexpr uint32_t SHIFT_PER_OBJECT_SET = 2;
+        //! Transient descriptor sets every frame pool fits at the start, a frame that needs more regrows its pool
+        static constexpr uint32_t SHIFT_TRANSIENT_SETS_PER_FRAME = 256;
+        //! Uniform ring bytes per frame in flight
+        static constexpr uint32_t SHIFT_UNIFORM_RING_SIZE = 4u * 1024u * 1024u;
+        //! Staging ring bytes of the frame uploads and of the async transfer queue
+        static constexpr uint32_t SHIFT_UPLOAD_RING_SIZE = 32u * 1024u * 1024u;
+        static constexpr uint32_t SHIFT_ASYNC_TRANSFER_RING_SIZE = 32u * 1024u * 1024u;
+        //! Texture readback ring bytes, shared by the frames in flight
+        static constexpr uint32_t SHIFT_READBACK_RING_SIZE = 32u * 1024u * 1024u;
+
+        //! The global bindless heap, bound at a set of its own after the per frame/view/object ones
+        static constexpr uint32_t SHIFT_BINDLESS_SET = 3;
+        static constexpr uint32_t SHIFT_BINDLESS_TEXTURE_COUNT = 16384;
+        static constexpr uint32_t SHIFT_BINDLESS_SAMPLER_COUNT = 256;
+        static constexpr uint32_t SHIFT_BINDLESS_BUFFER_COUNT = 8192;
+
+        //! GPU timer scopes a frame can record, the frame itself takes one
+        static constexpr uint32_t SHIFT_GPU_TIMER_COUNT = 128;
+        //! Pass statistics scopes a frame can record
+        static constexpr uint32_t SHIFT_GPU_PASS_QUERY_COUNT = 64;
+
+        //! Geometry arena: vertex layout every arena mesh shares (positions only until meshes get a common format),
+        //! and how many vertices and 32 bit indices the shared buffers fit
+        static constexpr uint32_t SHIFT_GEOMETRY_VERTEX_STRIDE = 3 * sizeof(float);
+        static constexpr uint32_t SHIFT_GEOMETRY_VERTEX_COUNT = 1u << 20;
+        static constexpr uint32_t SHIFT_GEOMETRY_INDEX_COUNT = 1u << 22;
+
+        //! Texture memory: images up to each size class limit are suballocated from that class's pool of blocks, bigger
+        //! ones get default VMA allocations, and render targets from SHIFT_TEXTURE_DEDICATED_SIZE up get memory of their own
+        static constexpr uint32_t SHIFT_TEXTURE_POOL_CLASS_COUNT = 3;
+        static constexpr uint64_t SHIFT_TEXTURE_POOL_MAX_SIZES[SHIFT_TEXTURE_POOL_CLASS_COUNT] = {256ull << 10, 4ull << 20, 32ull << 20};
+        static constexpr uint64_t SHIFT_TEXTURE_POOL_BLOCK_SIZES[SHIFT_TEXTURE_POOL_CLASS_COUNT] = {16ull << 20, 64ull << 20, 128ull << 20};
+        static constexpr uint64_t SHIFT_TEXTURE_DEDICATED_SIZE = 8ull << 20;
+        //! Texture defragmentation copies at most this much per frame
+        static constexpr uint64_t SHIFT_TEXTURE_DEFRAG_BYTES_PER_PASS = 32ull << 20;
+        static constexpr uint32_t SHIFT_TEXTURE_DEFRAG_MOVES_PER_PASS = 32;
+
+        //! Fractions of a device local heap budget where the memory pressure goes High (textures get demoted) and Critical
+        static constexpr float SHIFT_MEMORY_BUDGET_HIGH = 0.85f;
+        static constexpr float SHIFT_MEMORY_BUDGET_CRITICAL = 0.95f;
+        //! Textures demoted per round, a round waits for the frames in flight to free what the last one dropped
+        static constexpr uint32_t SHIFT_MEMORY_DEMOTIONS_PER_ROUND = 4;
+        //! Demotion doesn't take a texture below this many pixels on its shorter side
+        static constexpr uint32_t SHIFT_MEMORY_DEMOTION_MIN_SIZE = 128;
+
+        //! GPU culling: instances the culling buffers fit, draw buckets (one indirect draw each, e.g. per pipeline and
+        //! material) and the workgroup size of GpuCulling.comp, which has to match the shader
+        static constexpr uint32_t SHIFT_GPU_CULLING_MAX_INSTANCES = 1u << 18;
+        static constexpr uint32_t SHIFT_GPU_CULLING_BUCKET_COUNT = 64;
+        static constexpr uint32_t SHIFT_GPU_CULLING_GROUP_SIZE = 64;
     }
 } // shift
 
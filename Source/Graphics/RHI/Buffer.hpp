@@ -19,7 +19,22 @@ namespace Shift {
         Vertex,
         Index,
         Storage,
-        Indirect
+        Indirect,
+        //! Host visible destination of GPU copies that the CPU reads
+        Readback
+    };
+
+    //! How a buffer is accessed next, buffers have no layouts so their transitions are described with this instead
+    enum class EBufferAccess : uint8_t {
+        VertexRead,
+        IndexRead,
+        UniformRead,
+        IndirectRead,
+        ShaderRead,
+        ShaderWrite,
+        TransferRead,
+        TransferWrite,
+        HostRead
     };
 
     //! A buffer descriptor struct, buffer size SHOULD BE ALWAYS ALIGNED BY 16!
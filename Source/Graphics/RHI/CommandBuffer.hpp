@@ -6,11 +6,15 @@
 #define SHIFT_COMMANDBUFFER_HPP
 
 #include <concepts>
+#include <cstddef>
+#include <functional>
 #include <type_traits>
 #include <span>
+#include <string>
 
 #include "Base.hpp"
 #include "Types.hpp"
+#include "Handle.hpp"
 #include "Texture.hpp"
 #include "Sampler.hpp"
 
@@ -23,7 +27,8 @@ namespace Shift {
         uint32_t firstInstance = 0;
     };
 
-    //! With instanceCount = 1, it is regular draw, else it is instanced draw
+    //! With instanceCount = 1, it is regular draw, else it is instanced draw.
+    //! Laid out like VkDrawIndexedIndirectCommand, indirect buffers hold these as is
     struct DrawIndexedConfig{
         uint32_t indexCount = 0;
         uint32_t instanceCount = 1;
@@ -32,6 +37,25 @@ namespace Shift {
         uint32_t firstInstance = 0;
     };
 
+    //! Where a mesh lives in the geometry arena, in vertices and indices (not bytes), as DrawIndexedConfig takes them
+    struct MeshRange {
+        int32_t vertexOffset = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    using MeshHandle = Handle<MeshRange>;
+
+    //! Geometry arena fill, in vertices and indices
+    struct GeometryArenaStats {
+        uint32_t meshCount = 0;
+        uint64_t usedVertices = 0;
+        uint64_t vertexCapacity = 0;
+        uint64_t usedIndices = 0;
+        uint64_t indexCapacity = 0;
+    };
+
     //! Buffer data for a copy operation (based on Vulkan)
     struct BufferOpDescriptor {
         Buffer* buffer;
@@ -67,6 +91,72 @@ namespace Shift {
         EResourceLayout layout;
     };
 
+    //! Completion token of an asynchronous transfer, a default constructed token is invalid
+    struct TransferToken {
+        uint64_t value = 0;
+
+        [[nodiscard]] bool IsValid() const { return value != 0; }
+    };
+
+    //! A texture readback, a default constructed token is invalid
+    struct ReadbackToken {
+        uint64_t value = 0;
+
+        [[nodiscard]] bool IsValid() const { return value != 0; }
+    };
+
+    //! Called with the tightly packed texels once a readback is done, the data is only valid during the call
+    using ReadbackCallback = std::function<void(std::span<const std::byte> data)>;
+
+    //! Completion token of an async compute batch, the timeline value the batch signals
+    struct ComputeToken {
+        uint64_t value = 0;
+
+        [[nodiscard]] bool IsValid() const { return value != 0; }
+    };
+
+    //! GPU time of a timer scope, resolved a few frames after it was recorded
+    struct GpuTimerResult {
+        std::string name;
+        float ms = 0.0f;
+        //! Nesting depth, 0 for the outermost scopes of the frame
+        uint32_t depth = 0;
+    };
+
+    //! Pipeline statistics and occlusion counters of a pass, summed over every scope of the same name in the frame.
+    //! The statistics stay 0 on devices without pipelineStatisticsQuery
+    struct PassStatistics {
+        std::string name;
+        uint64_t inputVertices = 0;
+        uint64_t inputPrimitives = 0;
+        uint64_t vertexInvocations = 0;
+        uint64_t clippingInvocations = 0;
+        uint64_t clippingPrimitives = 0;
+        uint64_t fragmentInvocations = 0;
+        uint64_t computeInvocations = 0;
+        //! Samples that passed the depth and stencil tests, only non zero vs zero without occlusionQueryPrecise
+        uint64_t samplesPassed = 0;
+    };
+
+    //! How close the fullest device local heap is to its budget
+    enum class EMemoryPressure {
+        None,
+        //! Past Conf::SHIFT_MEMORY_BUDGET_HIGH, textures get demoted
+        High,
+        //! Past Conf::SHIFT_MEMORY_BUDGET_CRITICAL, new allocations may fail or land in slower memory
+        Critical
+    };
+
+    //! A memory heap against the budget the process has on it, in bytes
+    struct MemoryHeapBudget {
+        //! Everything the process uses, other APIs and implicit driver memory included
+        uint64_t usage = 0;
+        uint64_t budget = 0;
+        //! What the RHI allocated from the heap
+        uint64_t allocated = 0;
+        bool isDeviceLocal = false;
+    };
+
     enum class EPoolQueueType {
         Graphics,
         Transfer,
@@ -78,6 +168,12 @@ namespace Shift {
         Flight
     };
 
+    //! 1:1 with Vulkan, secondary buffers can only be executed from a primary one
+    enum class ECommandBufferLevel {
+        Primary,
+        Secondary
+    };
+
     template<typename CommandBuffer>
     concept ICommandBuffer =
         std::is_default_constructible_v<CommandBuffer> &&
@@ -99,7 +195,10 @@ namespace Shift {
             std::span<BufferOpDescriptor> InputBufferOpDescs,
             std::span<ResourceSet> InputResourceSets,
             uint32_t firstBindPosition,
+            uint32_t groupCount,
             uint32_t size,
+            uint32_t offset,
+            const void* InputData,
             EFilterMode filter,
             EIndexSize indexSize
     ) {
@@ -119,18 +218,23 @@ namespace Shift {
         //! Copies
         { InputBuffer.CopyBufferToBuffer(InputBufferOpDesc, InputBufferOpDesc, size) } -> std::same_as<void>;
         { InputBuffer.CopyBufferToTexture(InputBufferOpDesc, InputTextureCopyDesc) } -> std::same_as<void>;
-        //{ InputBuffer.CopyTextureToBuffer(InputTextureCopyDesc, InputBufferOpDesc, size) } -> std::same_as<void>; // TODO: [FEATURE] Check
+        { InputBuffer.CopyTextureToBuffer(InputTextureCopyDesc, InputBufferOpDesc) } -> std::same_as<void>;
         //{ InputBuffer.CopyTextureToTexture(InputTextureCopyDesc, InputTextureCopyDesc) } -> std::same_as<void>; // TODO: [FEATURE] Check
         //! Rendering
         { InputBuffer.BindGraphicsPipeline(InputPipeline) } -> std::same_as<void>;
         { InputBuffer.BindVertexBuffer(InputBufferOpDesc, firstBindPosition) } -> std::same_as<void>;
         { InputBuffer.BindVertexBuffers(InputBufferOpDescs, firstBindPosition) } -> std::same_as<void>;
         { InputBuffer.BindIndexBuffer(InputBufferOpDesc, indexSize) } -> std::same_as<void>;
+        { InputBuffer.PushConstants(InputPipeline, InputData, size, offset) } -> std::same_as<void>;
         // These will probably be per-backend specific too
         //!{ InputBuffer.BindResourceSet(InputResourceSet, firstBindPosition) } -> std::same_as<void>;     // Dynamic offsets will be pulled out of my fucking ass
         //!{ InputBuffer.BindResourceSets(InputResourceSets, firstBindPosition) } -> std::same_as<void>;
         { InputBuffer.Draw(InputDrawConfig) } -> std::same_as<void>;
         { InputBuffer.DrawIndexed(InputDrawIndexedConfig) } -> std::same_as<void>;
+        //! Compute
+        { InputBuffer.BindComputePipeline(InputPipeline) } -> std::same_as<void>;
+        { InputBuffer.Dispatch(groupCount, groupCount, groupCount) } -> std::same_as<void>;
+        { InputBuffer.DispatchIndirect(InputBufferOpDesc) } -> std::same_as<void>;
         //! Misc
         { InputBuffer.SetViewport(InputViewport) } -> std::same_as<void>;
         { InputBuffer.SetScissor(InputScissor) } -> std::same_as<void>;
@@ -0,0 +1,147 @@
+#ifndef SHIFT_HANDLE_HPP
+#define SHIFT_HANDLE_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace Shift {
+    //! A reference to an object in a HandlePool: slot index plus the generation the slot had when the object went in.
+    //! Destroying the object bumps the generation, so an old copy of the handle is detected instead of reading whatever
+    //! took the slot since
+    template<typename T>
+    struct Handle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool IsValid() const { return index != UINT32_MAX; }
+        bool operator==(const Handle&) const = default;
+    };
+
+    using BufferHandle = Handle<Buffer>;
+    using TextureHandle = Handle<Texture>;
+    using SamplerHandle = Handle<Sampler>;
+
+    //! Owns objects and hands out generational handles to them. The objects are packed densely (removal moves the last
+    //! one into the hole), so walking them or resolving a handle while recording touches contiguous memory. The slot
+    //! side lives in its own arrays, generation and dense position of a slot side by side so checking and resolving a
+    //! handle is one 8 byte load before the object itself. The objects stay whole, recording takes them as they are.
+    //! Not thread safe.
+    //! \tparam T stored object
+    //! \tparam Tag handle type, to hand out the handles of a public type while storing backend data
+    template<typename T, typename Tag = T>
+    class HandlePool {
+    public:
+        //! Take ownership of an object
+        //! \return handle to it
+        [[nodiscard]] Handle<Tag> Insert(T&& object) {
+            uint32_t index;
+            if (!m_freeIndices.empty()) {
+                index = m_freeIndices.back();
+                m_freeIndices.pop_back();
+            } else {
+                index = static_cast<uint32_t>(m_slots.size());
+                m_slots.push_back({});
+            }
+
+            m_slots[index].denseIndex = static_cast<uint32_t>(m_dense.size());
+            m_dense.push_back(std::move(object));
+            m_denseToIndex.push_back(index);
+
+            return {.index = index, .generation = m_slots[index].generation};
+        }
+
+        //! Whether the handle still refers to an object of this pool
+        [[nodiscard]] bool IsAlive(Handle<Tag> handle) const {
+            return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+                   m_slots[handle.index].denseIndex != UINT32_MAX;
+        }
+
+        //! Resolve a handle, the pointer is valid until the next Insert or Remove
+        //! \return nullptr if the handle is stale or invalid, asserts on stale ones in debug
+        [[nodiscard]] T* Get(Handle<Tag> handle) {
+            return const_cast<T*>(std::as_const(*this).Get(handle));
+        }
+
+        [[nodiscard]] const T* Get(Handle<Tag> handle) const {
+            if (!IsAlive(handle)) {
+                assert(!handle.IsValid() && "Stale handle, its object was removed from the pool");
+                return nullptr;
+            }
+            return &m_dense[m_slots[handle.index].denseIndex];
+        }
+
+        //! Give the object back to the caller and retire the handle, every copy of it goes stale
+        //! \return the object, std::nullopt if the handle is stale or invalid
+        [[nodiscard]] std::optional<T> Remove(Handle<Tag> handle) {
+            if (!IsAlive(handle)) {
+                assert(!handle.IsValid() && "Stale handle removed twice");
+                return std::nullopt;
+            }
+
+            uint32_t denseIdx = m_slots[handle.index].denseIndex;
+            std::optional<T> object = std::move(m_dense[denseIdx]);
+
+            //! Keep the objects packed, the last one takes the hole
+            uint32_t lastIdx = static_cast<uint32_t>(m_dense.size()) - 1;
+            if (denseIdx != lastIdx) {
+                m_dense[denseIdx] = std::move(m_dense[lastIdx]);
+                m_denseToIndex[denseIdx] = m_denseToIndex[lastIdx];
+                m_slots[m_denseToIndex[denseIdx]].denseIndex = denseIdx;
+            }
+            m_dense.pop_back();
+            m_denseToIndex.pop_back();
+
+            m_slots[handle.index].denseIndex = UINT32_MAX;
+            ++m_slots[handle.index].generation;
+            m_freeIndices.push_back(handle.index);
+
+            return object;
+        }
+
+        //! Every live object, in no particular order
+        [[nodiscard]] std::span<T> GetObjects() { return m_dense; }
+        [[nodiscard]] std::span<const T> GetObjects() const { return m_dense; }
+        [[nodiscard]] uint32_t GetCount() const { return static_cast<uint32_t>(m_dense.size()); }
+
+        //! Handle of an object from GetObjects
+        [[nodiscard]] Handle<Tag> GetHandle(const T& object) const {
+            auto denseIdx = static_cast<uint32_t>(&object - m_dense.data());
+            assert(denseIdx < m_dense.size() && "Object is not from this pool");
+            uint32_t index = m_denseToIndex[denseIdx];
+            return {.index = index, .generation = m_slots[index].generation};
+        }
+
+        //! Drop every object (the caller destroys them first) and retire every handle
+        void Clear() {
+            for (uint32_t index: m_denseToIndex) {
+                m_slots[index].denseIndex = UINT32_MAX;
+                ++m_slots[index].generation;
+                m_freeIndices.push_back(index);
+            }
+            m_dense.clear();
+            m_denseToIndex.clear();
+        }
+    private:
+        struct Slot {
+            uint32_t generation = 0;
+            //! UINT32_MAX while the slot is free
+            uint32_t denseIndex = UINT32_MAX;
+        };
+
+        //! Slot side, indexed by Handle::index
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeIndices;
+
+        //! Dense side, m_denseToIndex maps back to the slot for the swap on removal
+        std::vector<T> m_dense;
+        std::vector<uint32_t> m_denseToIndex;
+    };
+} // Shift
+
+#endif //SHIFT_HANDLE_HPP
@@ -95,6 +95,7 @@ namespace Shift {
 
     //! There are supposed to be 1:1 with Vulkan, but I will add them as I go
     enum class EVertexAttributeFormat {
+        R32_SignedFloat = 100,
         R32G32_SignedFloat = 103,
         R32G32B32_SignedFloat = 106,
         R32G32B32A32_SignedFloat = 109,
@@ -138,10 +139,10 @@ namespace Shift {
         Geometry = 1 << 3,
         Fragment = 1 << 4,
         Compute = 1 << 5,
-//        //! Shift custom
-//        VertexFragment = Vertex | Fragment,
-//        AllGraphics = Vertex | TesselationControl | TesselationEvaluation | Geometry | Fragment,
-//        All = Vertex | TesselationControl | TesselationEvaluation | Geometry | Fragment | Compute
+        //! Shift custom
+        VertexFragment = Vertex | Fragment,
+        AllGraphics = Vertex | TesselationControl | TesselationEvaluation | Geometry | Fragment,
+        All = Vertex | TesselationControl | TesselationEvaluation | Geometry | Fragment | Compute
     };
     DEFINE_ENUM_CLASS_BITWISE_OPERATORS(EBindingVisibility)
 
@@ -158,8 +159,13 @@ namespace Shift {
             bool writable = false;
         };
         std::vector<LayoutBindingDesc> bindings;
+    };
 
-        //! FEATURE: Add push constants support
+    //! A push constant range of the pipeline layout, 1:1 with Vulkan. Offset and size are multiples of 4
+    struct PushConstantRange {
+        EBindingVisibility stages = EBindingVisibility::AllGraphics;
+        uint32_t offset = 0;
+        uint32_t size = 0;
     };
 
     //! The pipeline offline description structures (default values for all except viewport and scissor)
@@ -265,8 +271,29 @@ namespace Shift {
         } depthStencilConfig;
 
         //! These "virtual" layouts will get picked up at pipeline creation by a
-        //! DescriptorManager/PipelineLayoutCache and get either created or pulled from cache
+        //! DescriptorManager/PipelineLayoutCache and get either created or pulled from cache.
+        //! Left empty, they are reflected from the shaders (same for an empty vertexConfig)
         std::vector<PipelineLayoutDescriptor> descriptorLayouts;
+
+        //! Left empty, the layout gets the canonical range of Conf::SHIFT_PUSH_CONSTANT_SIZE bytes visible to every stage,
+        //! which keeps bound sets compatible across pipelines. Explicit ranges can go up to maxPushConstantsSize
+        std::vector<PushConstantRange> pushConstantRanges;
+    };
+
+    //! State of a pipeline requested through the registry
+    enum class EPipelineStatus : uint8_t {
+        Compiling,
+        Ready,
+        Failed
+    };
+
+    //! Shared handle to a registry owned pipeline, identical requests get the same handle. Pipelines live as long as
+    //! the registry, the generation is the one of the registry so handles of a destroyed one are caught
+    struct PipelineHandle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool IsValid() const { return index != UINT32_MAX; }
     };
 
     template<typename Pipeline>
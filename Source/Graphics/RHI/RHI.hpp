@@ -5,10 +5,13 @@
 #ifndef SHIFT_SRHI_HPP
 #define SHIFT_SRHI_HPP
 
+#include <algorithm>
 #include <concepts>
 #include <array>
+#include <chrono>
 
 #include "Types.hpp"
+#include "Handle.hpp"
 #include "Texture.hpp"
 #include "Buffer.hpp"
 #include "Pipeline.hpp"
@@ -52,52 +55,351 @@ namespace Shift {
     template<ValidAPI API>
     class RenderHardwareInterface {
     public:
+        //! Initialize the RHI, a nullptr window makes it headless: no surface and no swapchain, a CPU device (lavapipe)
+        //! is taken if there is no GPU. Headless frames render into textures and SubmitCmds ignores the image index,
+        //! the swapchain functions and ImportBackbuffer fail. Width and height are the swapchain size, unused headless
         bool Init(GLFWwindow* window, uint32_t width, uint32_t height, const std::string& appName, const std::string& appVersion, const std::string& engineName, const std::string& engineVersion);
 
+        //! Whether the RHI was initialized without a window
+        [[nodiscard]] bool IsHeadless() const { return m_isHeadless; }
+
         //! Wait for GPU to complete work before deleting stuff
         void WaitForGPU();
         void Destroy();
 
         [[nodiscard]] Buffer CreateBuffer(const BufferDescriptor& desc);
         [[nodiscard]] Texture CreateTexture(const TextureDescriptor& desc);
+        //! Memory a texture of this description needs, to place it into a memory block
+        [[nodiscard]] TextureMemoryRequirements GetTextureMemoryRequirements(const TextureDescriptor& desc) const;
+        //! Allocate device local memory textures can be placed into, the caller destroys it after its textures
+        //! \param requirements size, alignment and memory types every texture placed into it accepts
+        [[nodiscard]] MemoryBlock CreateMemoryBlock(const TextureMemoryRequirements& requirements);
+        //! Create a texture in a memory block, textures whose lifetimes don't overlap can share the same bytes.
+        //! It starts undefined, DiscardTexture it with the textures that used the bytes before to order it after them
+        //! \param desc texture description
+        //! \param block memory block, outlives the texture
+        //! \param offset offset into the block, aligned to the texture memory requirements
+        [[nodiscard]] Texture CreatePlacedTexture(const TextureDescriptor& desc, const MemoryBlock& block, uint64_t offset);
+
+        ///! ------------------- Deferred Destruction ------------------- !///
+        //! Nothing is freed right away, the object goes once the frames in flight and the async transfers that could
+        //! use it are done on the GPU, so resources can be swapped at runtime without WaitForGPU. The passed object is
+        //! reset and can be reused for a new one. Objects go in the order they were destroyed in.
+
+        //! Destroy a buffer and drop its tracked state, buffers that went through TransitionBuffer have to die here
+        void DestroyBuffer(Buffer& buffer);
+        //! Destroy a texture and drop its tracked state, textures that went through TransitionTexture have to die here
+        void DestroyTexture(Texture& texture);
+        //! Destroy a memory block, destroy the textures placed into it first
+        void DestroyMemoryBlock(MemoryBlock& block);
+        void DestroySampler(Sampler& sampler);
+        //! Destroy a pipeline created with CreatePipeline, registry pipelines belong to the RHI
+        void DestroyPipeline(Pipeline& pipeline);
+        //! Destroy a shader, requested pipelines still compiling with it have to be waited for first
+        void DestroyShader(Shader& shader);
+
+        //! Objects still waiting for the GPU to let go of them
+        [[nodiscard]] uint32_t GetPendingDestroyCount() const { return m_local.deletionQueue.GetPendingCount(); }
+
+        ///! ------------------- Resource Handles ------------------- !///
+        //! Resources owned by the RHI and referred to by index + generation instead of copies of the objects. A handle
+        //! outliving its resource resolves to nullptr (and asserts in debug) instead of a destroyed or reused object.
+        //! Resolved pointers are valid until the next create or destroy of the same kind.
+
+        [[nodiscard]] BufferHandle CreateBufferHandle(const BufferDescriptor& desc);
+        [[nodiscard]] TextureHandle CreateTextureHandle(const TextureDescriptor& desc);
+        [[nodiscard]] SamplerHandle CreateSamplerHandle(const SamplerDescriptor& desc);
+
+        //! \return nullptr if the handle is stale
+        [[nodiscard]] Buffer* GetBuffer(BufferHandle handle) { return m_bufferPool.Get(handle); }
+        [[nodiscard]] Texture* GetTexture(TextureHandle handle) { return m_texturePool.Get(handle); }
+        [[nodiscard]] Sampler* GetSampler(SamplerHandle handle) { return m_samplerPool.Get(handle); }
+
+        //! Whether the resource is still there, for callers that expect handles to go stale
+        template<typename T>
+        [[nodiscard]] bool IsAlive(Handle<T> handle) const;
+
+        //! Retire the handle right away, the resource itself is destroyed like the ones above
+        void DestroyBuffer(BufferHandle handle);
+        void DestroyTexture(TextureHandle handle);
+        void DestroySampler(SamplerHandle handle);
+
+        //! Create a pipeline owned by the caller, compiled right away. Empty descriptor layouts and vertex input are
+        //! reflected from the shaders, the pipeline layout is shared with every pipeline of the same layouts.
+        //! A single compute stage makes a compute pipeline, only its layouts and push constants of desc matter then
         [[nodiscard]] Pipeline CreatePipeline(const PipelineDescriptor& desc, const std::vector<ShaderStageDesc>& shaders);
         [[nodiscard]] ResourceSet CreateResourceSet(const PipelineLayoutDescriptor& desc);
+        //! Create a set that is only valid for the current frame (per draw/per pass data), allocated between BeginCmds
+        //! and SubmitCmds. There is nothing to free, the frame pool is reset once the frame slot comes around again
+        [[nodiscard]] ResourceSet CreateTransientResourceSet(const PipelineLayoutDescriptor& desc);
+        //! Transient set allocation numbers of the last reset frame
+        [[nodiscard]] const TransientSetStats& GetTransientSetStats() const { return m_local.frameDescAllocator.GetStats(); }
+        //! Apply the pending updates of many sets at once, what can't go through the set layout update template is
+        //! written in a single batched call. Same as calling Apply on each, meant for big scenes
+        void ApplyResourceSets(std::span<ResourceSet* const> sets);
         [[nodiscard]] Sampler CreateSampler(const SamplerDescriptor& desc);
+        //! Create a shader, its descriptor sets, push constants and vertex inputs are reflected for the pipelines using it
         [[nodiscard]] Shader CreateShader(const ShaderDescriptor& desc);
 
+        ///! ------------------- Pipeline Registry ------------------- !///
+        //! Shared pipelines: identical descriptor + shaders requests get the same handle. New ones compile in the background,
+        //! the frame keeps going with a fallback (or skips the draw) until they are ready. The RHI owns them.
+
+        //! Get the shared pipeline handle, queues the compilation if it is new. Shaders must outlive the compilation
+        //! \param desc pipeline descriptor
+        //! \param shaders shader stages
+        //! \return pipeline handle
+        [[nodiscard]] PipelineHandle RequestPipeline(const PipelineDescriptor& desc, const std::vector<ShaderStageDesc>& shaders);
+
+        [[nodiscard]] EPipelineStatus GetPipelineStatus(PipelineHandle handle) const;
+
+        //! Get a ready pipeline, never blocks
+        //! \param handle requested pipeline
+        //! \param fallback used while the requested one is not ready
+        //! \return nullptr if neither is ready
+        [[nodiscard]] const Pipeline* GetPipeline(PipelineHandle handle, PipelineHandle fallback = {}) const;
+
+        //! Block until the pipeline is compiled (or failed), meant for load time
+        void WaitForPipeline(PipelineHandle handle) const;
+
+        ///! ------------------- Uniform Ring ------------------- !///
+        //! Per object/per view constants of the frame go into one mapped buffer. A single set with a dynamic uniform
+        //! binding pointing at GetUniformRingBuffer() (range = the block size) serves every object, each draw binds it
+        //! with the offset its push returned. Reflected pipelines make the uniforms of Conf::SHIFT_PER_OBJECT_SET dynamic.
+
+        //! Copy the constants into the current frame region, valid until this frame slot comes around again
+        //! \param data the whole shader block
+        //! \param size block size
+        //! \return dynamic offset to bind with, UINT32_MAX if the ring is full
+        [[nodiscard]] uint32_t PushUniform(const void* data, uint32_t size);
+        template<typename T>
+        [[nodiscard]] uint32_t PushUniform(const T& data) { return PushUniform(&data, static_cast<uint32_t>(sizeof(T))); }
+
+        //! The buffer to point the dynamic uniform descriptors at
+        [[nodiscard]] const Buffer& GetUniformRingBuffer() const { return m_local.uniformRing.GetBuffer(); }
+
+        ///! ------------------- Bindless Heap ------------------- !///
+        //! One global set of texture, sampler and storage buffer arrays (Shaders/Source/Bindless.glsl). Shaders index it
+        //! with BindlessHandle::index, it is bound with every pipeline that declares the bindless set.
+
+        //! Put a texture in the heap, shaders sample it in ShaderReadOnlyOptimal, transition it there before the reads
+        //! \return invalid handle if the heap is full
+        [[nodiscard]] BindlessHandle AddBindlessTexture(const Texture& texture);
+        //! Put a handle texture in the heap, the texture gets a new slot when defragmentation or demotion replace it
+        //! (GetBindlessMoves)
+        //! \return invalid handle if the heap is full or the handle is stale
+        [[nodiscard]] BindlessHandle AddBindlessTexture(TextureHandle handle);
+        [[nodiscard]] BindlessHandle AddBindlessSampler(const Sampler& sampler);
+        //! \param buffer storage buffer
+        //! \param offset range offset
+        //! \param size range size, 0 for the rest of the buffer
+        [[nodiscard]] BindlessHandle AddBindlessBuffer(const Buffer& buffer, uint64_t offset = 0, uint64_t size = 0);
+
+        //! Point a texture slot at another texture
+        void UpdateBindlessTexture(BindlessHandle handle, const Texture& texture);
+
+        //! Free the slot, it is reused once the frames in flight can't read it anymore
+        void RemoveBindless(BindlessHandle handle);
+
+        //! Slots of handle textures that were replaced in this frame, from BeginCmds on. Slots the frames in flight
+        //! sample can't be rewritten, so the replacement goes in a new one and the old one points at the old image until
+        //! this frame is done: whatever feeds the indices to shaders has to switch to the new ones before recording.
+        [[nodiscard]] std::span<const BindlessMove> GetBindlessMoves() const { return m_bindlessMoves; }
+
+        ///! ------------------- Texture Defragmentation ------------------- !///
+        //! Textures are suballocated from size class pools (Conf::SHIFT_TEXTURE_POOL_*), only big render targets get
+        //! memory of their own. Defragmentation compacts the pools a pass per frame: a handle texture that moves gets a new
+        //! image and view, its contents are copied in the frame command buffer and the bindless slots added through its
+        //! handle move to new ones (GetBindlessMoves). Copies of the moved Texture and resource sets written with it go stale, so textures bound
+        //! that way should be created with CreateTexture, those never move.
+
+        //! Start compacting the texture pools, runs over the next frames until nothing more can be moved
+        void DefragmentTextures() { m_local.textureAllocator.BeginDefragmentation(); }
+        [[nodiscard]] bool IsDefragmentingTextures() const { return m_local.textureAllocator.IsDefragmenting(); }
+
+        ///! ------------------- Memory Budget ------------------- !///
+        //! Heap usage against the budget the process has (VK_EXT_memory_budget where supported, estimated otherwise), read
+        //! every BeginCmds. Past Conf::SHIFT_MEMORY_BUDGET_HIGH on a device local heap the biggest handle textures that are
+        //! only sampled lose their top mip, a few per round, and the render graph lets go of transients it isn't using.
+        //! Demoted textures keep their handle and move bindless slots like defragmented ones, copies of them go stale.
+
+        [[nodiscard]] std::span<const MemoryHeapBudget> GetMemoryBudgets() const { return m_local.memoryBudget.GetHeaps(); }
+        [[nodiscard]] EMemoryPressure GetMemoryPressure() const { return m_local.memoryBudget.GetPressure(); }
+
         [[nodiscard]] Swapchain& GetSwapchain() { return m_local.swapchain; }
         [[nodiscard]] uint32_t SwapchainAquireImage(bool* wasChanged);
         [[nodiscard]] uint32_t SwapchainPresent(uint32_t imageIdx, bool* isOld);
+        //! Recreate the swapchain without idling the device, the old one is destroyed once the frames that used it retire
+        //! \return false if failed
+        [[nodiscard]] bool SwapchainRecreate(uint32_t width, uint32_t height);
         void NextFrame() { m_currentFrame = (++m_currentFrame) % Conf::SHIFT_MAX_FRAMES_IN_FLIGHT; }
         uint32_t GetCurrentFrame() { return m_currentFrame; }
+        //! Frames begun since Init, the frame being recorded included
+        [[nodiscard]] uint64_t GetFrameNumber() const { return m_frameNumber; }
+        //! Number of the last frame that was submitted, 0 if none
+        [[nodiscard]] uint64_t GetSubmittedFrameNumber() const { return m_submittedFrame; }
 
-        //! TODO: [FEATURE] Here we would have additional parameters for multicommand-buffer concurrency handling (probably)
-        [[nodiscard]] bool BeginCmds() const;
+        [[nodiscard]] bool BeginCmds();
 
-        [[nodiscard]] bool EndCmds() const;
+        //! Flushes the transitions still queued (e.g. to present) before ending
+        [[nodiscard]] bool EndCmds();
 
         void ResetCmds() const;
 
-        bool SubmitCmds(uint32_t imageIdx) const;
-        bool SubmitCmdsAndWait(uint32_t imageIdx) const;
+        //! Submit the frame, the batched uploads of the frame get submitted right before
+        bool SubmitCmds(uint32_t imageIdx);
+        bool SubmitCmdsAndWait(uint32_t imageIdx);
 
         void BeginRenderPass(const RenderPassDescriptor& desc, std::span<Texture*> colorTextures, std::optional<Texture*> depthTexture);
         void BeginRenderPassToSwapchain(const RenderPassDescriptor& desc, uint32_t imageIdx, std::optional<Texture*> depthTexture);
 
         void EndRenderPass();
 
+        ///! ------------------- Parallel Recording ------------------- !///
+        //! Every worker records from its own per frame pools, a worker index must only be used by one thread at a time.
+        //! Workers can start after BeginCmds and have to end their buffers before the main thread stitches them in.
+
+        [[nodiscard]] uint32_t GetRecordingWorkerCount() const;
+
+        //! Begin a worker secondary buffer for a pass begun with secondaryContents, executed with ExecuteSecondaryCmds.
+        //! Viewport and scissor are not inherited, set them in the secondary.
+        //! \param workerIdx recording worker index
+        //! \param colorFormats formats of the pass color attachments
+        //! \param depthFormat format of the pass depth attachment if any
+        //! \return begun command buffer, nullptr if failed
+        [[nodiscard]] CommandBuffer* BeginSecondaryCmds(uint32_t workerIdx, std::span<const ETextureFormat> colorFormats, std::optional<ETextureFormat> depthFormat);
+
+        //! Begin an independent worker primary buffer. It is submitted in the same batch as the frame, right before the
+        //! frame command buffer, so it suits whole passes whose results the frame consumes (e.g. shadow maps)
+        //! \param workerIdx recording worker index
+        //! \return begun command buffer, nullptr if failed
+        [[nodiscard]] CommandBuffer* BeginWorkerCmds(uint32_t workerIdx);
+
+        //! Execute ended worker secondaries in the current render pass
+        //! \param cmds secondaries in the order they should execute
+        void ExecuteSecondaryCmds(std::span<CommandBuffer* const> cmds) const;
+
         ///! ------------------- Copy Buffer Commands ------------------- !///
+        //! All the copies and uploads are batched into one command buffer and submitted once with the frame (or at FlushUploads)
 
-        //! Copy buffer data to another buffer
+        //! Copy buffer data to another buffer, the source has to stay alive until the batch is done
         //! \param srcBuf buffer + offset into the buffer
         //! \param dstBuf buffer + offset into the buffer
         //! \param size size to copy
-        void CopyBufferToBuffer(const BufferOpDescriptor& srcBuf, const BufferOpDescriptor& dstBuf, uint32_t size) const;
+        void CopyBufferToBuffer(const BufferOpDescriptor& srcBuf, const BufferOpDescriptor& dstBuf, uint32_t size);
 
-        //! Copy buffer data to a texture
+        //! Copy buffer data to a texture, the source has to stay alive until the batch is done
         //! \param srcBuf buffer + offset into the buffer
         //! \param dstTex texture + size to copy + offset + subresource range
-        void CopyBufferToTexture(const BufferOpDescriptor& srcBuf, const TextureCopyDescriptor& dstTex) const;
+        void CopyBufferToTexture(const BufferOpDescriptor& srcBuf, const TextureCopyDescriptor& dstTex);
+
+        //! Upload host data into a buffer through the staging ring, the data can be freed right after the call
+        //! \param data source data
+        //! \param size data size
+        //! \param dstBuf buffer + offset into the buffer
+        //! \return false if failed
+        bool UploadToBuffer(const void* data, uint64_t size, const BufferOpDescriptor& dstBuf);
+
+        //! Upload host data into a texture through the staging ring, the data can be freed right after the call.
+        //! The uploads run before the frame commands, don't use the texture in the frame before this
+        //! \param data tightly packed texel data
+        //! \param size data size
+        //! \param dstTex texture + size to copy + offset + subresource range
+        //! \param finalLayout layout to leave the texture in
+        //! \return false if failed
+        bool UploadToTexture(const void* data, uint64_t size, const TextureCopyDescriptor& dstTex, EResourceLayout finalLayout = EResourceLayout::ShaderReadOnlyOptimal);
+
+        //! Submit the batched uploads now instead of with the frame
+        //! \param wait block until they are done (load time)
+        //! \return false if failed
+        bool FlushUploads(bool wait);
+
+        ///! ------------------- Async Transfer Commands ------------------- !///
+        //! These go through the dedicated transfer queue and never block the frame. A resource can be used in a frame
+        //! once IsTransferReady() returns true after BeginCmds, the ownership transfer to graphics is handled internally.
+
+        //! Upload host data into a buffer asynchronously, the data can be freed right after the call
+        //! \param data source data
+        //! \param size data size
+        //! \param dstBuf buffer + offset into the buffer
+        //! \return completion token, invalid if failed
+        [[nodiscard]] TransferToken UploadToBufferAsync(const void* data, uint64_t size, const BufferOpDescriptor& dstBuf);
+
+        //! Upload host data into a texture asynchronously, the previous contents are discarded
+        //! \param data tightly packed texel data
+        //! \param size data size
+        //! \param dstTex texture + size to copy + offset + subresource range
+        //! \param finalLayout layout the texture will be in once ready
+        //! \return completion token, invalid if failed
+        [[nodiscard]] TransferToken UploadToTextureAsync(const void* data, uint64_t size, const TextureCopyDescriptor& dstTex, EResourceLayout finalLayout = EResourceLayout::ShaderReadOnlyOptimal);
+
+        //! Kick the pending async uploads to the transfer queue now, otherwise they go at SubmitCmds
+        //! \return false if failed
+        bool SubmitAsyncUploads();
+
+        //! Poll whether the resources of the token can be used by the frame, never blocks
+        [[nodiscard]] bool IsTransferReady(TransferToken token) const;
+
+        //! Block until the transfer is done on the GPU, the resources become usable at the next BeginCmds
+        void WaitForTransfer(TransferToken token);
+
+        ///! ------------------- Async Compute Commands ------------------- !///
+        //! Compute recorded here runs on the compute queue next to the frames. It is ordered with graphics only through
+        //! the frame a batch waits for at submission and the batches a frame waits for with AddAsyncComputeWait, the
+        //! storage/indirect buffers and storage images are shared between the queues so nothing else is needed. E.g.
+        //! culling for frame N+1 submitted with graphicsWaitFrame N-1 overlaps the raster of frame N, as long as it
+        //! writes buffers frame N doesn't read. Record with the CommandBuffer overloads of BindComputePipeline,
+        //! BindResourceSets and PushConstants, and Dispatch on the command buffer itself. A resource used by a batch
+        //! must not be destroyed before a frame that waited for it.
+
+        //! Whether there is a compute queue family of its own, otherwise the batches run on the graphics queue
+        [[nodiscard]] bool HasAsyncCompute() const { return m_local.device.HasAsyncCompute(); }
+
+        //! Get the command buffer of the current async compute batch, a batch starts if none is recording
+        //! \return nullptr if failed, else valid until SubmitAsyncCompute
+        [[nodiscard]] const CommandBuffer* BeginAsyncCompute();
+
+        //! Make the shader writes recorded so far in the batch visible to the dispatches and indirect reads after them
+        void AsyncComputeBarrier();
+
+        //! Submit the current async compute batch, never blocks
+        //! \param graphicsWaitFrame frame number the batch waits for on the GPU before it starts, 0 for none. Frames
+        //! that were not submitted yet become the last submitted one, a wait on an unsubmitted frame could never end
+        //! \return completion token, invalid if nothing was recorded or the submission failed
+        [[nodiscard]] ComputeToken SubmitAsyncCompute(uint64_t graphicsWaitFrame = 0);
+
+        //! Make the submission of the current frame wait for an async compute batch
+        //! \param token async compute token
+        //! \param stages the stages of the frame that use what the batch wrote, NoneBit for the whole frame
+        void AddAsyncComputeWait(ComputeToken token, EPipelineStageFlags stages);
+
+        //! Poll whether the batch is done on the GPU, never blocks
+        [[nodiscard]] bool IsAsyncComputeDone(ComputeToken token) const { return m_local.asyncCompute.IsDone(token); }
+
+        //! Block until the batch is done on the GPU
+        void WaitForAsyncCompute(ComputeToken token) const { m_local.asyncCompute.Wait(token); }
+
+        ///! ------------------- Texture Readback ------------------- !///
+        //! Texture regions are copied into a host visible ring (Conf::SHIFT_READBACK_RING_SIZE) in the frame command
+        //! buffer, outside of render passes. A readback resolves at the BeginCmds after its frame is done on the GPU,
+        //! about SHIFT_MAX_FRAMES_IN_FLIGHT frames later, nothing ever waits for it. Either pass a callback, or poll
+        //! IsReadbackReady and ReleaseReadback once the data was read, the ring space goes back in readback order.
+
+        //! Copy a texture region back to the host, the texture needs TransferSrc usage and is left in TransferSrcOptimal
+        //! \param srcTex texture + size to copy + offset + subresource range, a single mip and aspect
+        //! \param callback called in BeginCmds with the tightly packed texels, the readback is released after it
+        //! \return readback token, invalid if the format can't be read back or the ring is full
+        ReadbackToken ReadbackTexture(const TextureCopyDescriptor& srcTex, ReadbackCallback callback = {});
+
+        //! Poll whether the data of a readback is there, never blocks
+        [[nodiscard]] bool IsReadbackReady(ReadbackToken token) const { return m_local.readbackRing.IsReady(token); }
+
+        //! The tightly packed texels of a readback
+        //! \return empty until ready, else valid until ReleaseReadback
+        [[nodiscard]] std::span<const std::byte> GetReadbackData(ReadbackToken token) { return m_local.readbackRing.GetData(token); }
+
+        //! Let go of a readback without a callback, ready or not
+        void ReleaseReadback(ReadbackToken token) { m_local.readbackRing.Release(token); }
 
         ///! ------------------- Rendering Buffer Commands ------------------- !///
 
@@ -115,16 +417,122 @@ namespace Shift {
         //! \param buffer buffer + offset into the buffer
         void BindIndexBuffer(const BufferOpDescriptor& buffer, EIndexSize indexSize) const;
 
-        //! Bind the graphics pipeline
+        ///! ------------------- Geometry Arena ------------------- !///
+        //! Vertices and indices of every mesh share one buffer pair, Conf::SHIFT_GEOMETRY_VERTEX_STRIDE bytes per vertex
+        //! and 32 bit indices. Bind the pair once with BindGeometryArena, then each mesh is a DrawMesh (or a DrawIndexed
+        //! with its range) without any rebinds in between.
+
+        //! Reserve a mesh and upload its data with the frame uploads
+        //! \param vertices vertex data, vertexCount * Conf::SHIFT_GEOMETRY_VERTEX_STRIDE bytes
+        //! \param vertexCount vertices of the mesh
+        //! \param indices indices relative to the first vertex of the mesh, empty for a non indexed mesh
+        //! \return invalid handle if the arena is full or the upload failed
+        [[nodiscard]] MeshHandle CreateMesh(const void* vertices, uint32_t vertexCount, std::span<const uint32_t> indices);
+
+        //! \return nullptr if the handle is stale
+        [[nodiscard]] const MeshRange* GetMeshRange(MeshHandle handle) const { return m_local.geometryArena.Get(handle); }
+
+        //! Retire the handle now, the ranges are reused once the frames in flight are done drawing from them
+        void DestroyMesh(MeshHandle handle);
+
+        //! Bind the arena vertex buffer at binding 0 and its index buffer
+        void BindGeometryArena();
+
+        //! Draw a mesh from the bound arena, indexed if it has indices
+        void DrawMesh(MeshHandle handle, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+
+        [[nodiscard]] GeometryArenaStats GetGeometryArenaStats() const { return m_local.geometryArena.GetStats(); }
+
+        //! Bind a pooled vertex buffer, nothing is bound for a stale handle
+        void BindVertexBuffer(BufferHandle buffer, uint32_t bindIdx, uint32_t offset = 0);
+        //! Bind a pooled index buffer, nothing is bound for a stale handle
+        void BindIndexBuffer(BufferHandle buffer, EIndexSize indexSize, uint32_t offset = 0);
+
+        //! Bind the graphics pipeline, the bindless heap goes along if the pipeline uses it
         //! \param pipeline The Pipeline wrapper
         void BindGraphicsPipeline(const Pipeline& pipeline) const;
 
+        //! Bind the graphics pipeline into a worker command buffer
+        //! \param cmd recording worker command buffer
+        //! \param pipeline The Pipeline wrapper
+        void BindGraphicsPipeline(const CommandBuffer& cmd, const Pipeline& pipeline) const;
+
+        //! Bind resource sets for the graphics or compute pipeline
+        //! \param pipeline pipeline the sets are laid out for
+        //! \param sets sets to bind, in set order
+        //! \param firstSet set index of the first one
+        //! \param dynamicOffsets one per dynamic binding of the sets, in set then binding order (e.g. PushUniform results)
+        void BindResourceSets(const Pipeline& pipeline, std::span<const ResourceSet* const> sets, uint32_t firstSet, std::span<const uint32_t> dynamicOffsets = {}) const;
+
+        //! Bind resource sets for the graphics pipeline into a worker command buffer
+        void BindResourceSets(const CommandBuffer& cmd, const Pipeline& pipeline, std::span<const ResourceSet* const> sets, uint32_t firstSet, std::span<const uint32_t> dynamicOffsets = {}) const;
+
+        //! Push small per draw data (object index, material id) straight into the command buffer, no buffer or set writes
+        //! \param pipeline the bound pipeline, its push constant ranges have to cover [offset, offset + sizeof(T))
+        //! \param data constants, copied as is
+        //! \param offset offset into the push constant block
+        template<typename T>
+        void PushConstants(const Pipeline& pipeline, const T& data, uint32_t offset = 0) const {
+            PushConstants(m_cmdBuffersFlight[m_currentFrame], pipeline, data, offset);
+        }
+
+        //! Push constants into a worker command buffer
+        template<typename T>
+        void PushConstants(const CommandBuffer& cmd, const Pipeline& pipeline, const T& data, uint32_t offset = 0) const {
+            static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % 4 == 0, "Push constants are copied as is, in multiples of 4 bytes");
+            cmd.PushConstants(pipeline, &data, static_cast<uint32_t>(sizeof(T)), offset);
+        }
+
         void DrawIndexed(const DrawIndexedConfig& drawConf) const;
 
         //! Draw/Draw instanced
         //! \param drawConf draw configuration
         void Draw(const DrawConfig& drawConf) const;
 
+        //! Draw indexed with DrawIndexedConfig commands a previous pass wrote, transition the buffer to IndirectRead at
+        //! DrawIndirectBit after the writes. Without SupportsMultiDrawIndirect every command is an indirect draw of its own
+        //! \param args buffer + offset of the first command
+        //! \param drawCount commands to draw, zeroed commands draw nothing
+        void DrawIndexedIndirect(const BufferOpDescriptor& args, uint32_t drawCount) const;
+
+        //! Draw indexed with the draw count read from a buffer too, only with SupportsDrawIndirectCount and
+        //! SupportsMultiDrawIndirect
+        //! \param args buffer + offset of the first command
+        //! \param count buffer + offset of the uint32_t count, same transition as args
+        //! \param maxDrawCount upper bound of the count
+        void DrawIndexedIndirectCount(const BufferOpDescriptor& args, const BufferOpDescriptor& count, uint32_t maxDrawCount) const;
+
+        [[nodiscard]] bool SupportsDrawIndirectCount() const { return m_local.device.HasDrawIndirectCount(); }
+        //! Whether one indirect draw can take more than one command (multiDrawIndirect)
+        [[nodiscard]] bool SupportsMultiDrawIndirect() const { return m_local.device.GetEnabledFeatures().multiDrawIndirect == VK_TRUE; }
+
+        ///! ------------------- Compute ------------------- !///
+        //! Compute pipelines come from CreatePipeline/RequestPipeline with a single compute stage and take their sets
+        //! through BindResourceSets like graphics ones. Storage buffers and images that compute writes and graphics
+        //! reads (or the other way around) get a TransitionBuffer/TransitionTexture with the stages of the next user,
+        //! storage images go through EResourceLayout::General. Dispatches happen outside of render passes
+
+        //! Bind the compute pipeline, the bindless heap goes along if the pipeline uses it
+        //! \param pipeline compute pipeline
+        void BindComputePipeline(const Pipeline& pipeline) const;
+        //! Bind the compute pipeline to a command buffer, an async compute one included
+        //! \param cmd a recording command buffer
+        //! \param pipeline compute pipeline
+        void BindComputePipeline(const CommandBuffer& cmd, const Pipeline& pipeline) const;
+
+        //! Run the bound compute pipeline, the queued transitions go out first
+        //! \param groupCountX workgroups in x
+        //! \param groupCountY workgroups in y
+        //! \param groupCountZ workgroups in z
+        void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
+
+        //! Run the bound compute pipeline with the workgroup counts a previous pass wrote, the queued transitions go out first
+        //! \param buffer Indirect buffer + offset of the three uint32_t counts (multiple of 4), transition it to IndirectRead
+        //! at DrawIndirectBit after the writes
+        void DispatchIndirect(const BufferOpDescriptor& buffer);
+        //! Indirect dispatch from a pooled buffer, nothing runs for a stale handle
+        void DispatchIndirect(BufferHandle buffer, uint32_t offset = 0);
+
         ///! ------------------- Mics Buffer Commands ------------------- !///
 
         //! Blit the texture into the other texture
@@ -132,7 +540,14 @@ namespace Shift {
         //! \param dstTexture destination texture with sizes and extents
         //! \param blitRegion blit operation description
         //! \param filter blit filter
-        void BlitTexture(const TextureBlitData& srcTexture, const TextureBlitData& dstTexture, const TextureBlitRegion& blitRegion, EFilterMode filter) const;
+        void BlitTexture(const TextureBlitData& srcTexture, const TextureBlitData& dstTexture, const TextureBlitRegion& blitRegion, EFilterMode filter);
+
+        //! Fill a buffer range with a 32 bit value in the frame command buffer (clearing counters), transition the buffer to
+        //! TransferWrite at TransferBit first. The queued transitions go out before it
+        //! \param dstBuf buffer + offset into the buffer, multiple of 4
+        //! \param size bytes to fill, multiple of 4
+        //! \param value the value
+        void FillBuffer(const BufferOpDescriptor& dstBuf, uint64_t size, uint32_t value = 0);
 
         //! Set viewport, we don't support multiple
         //! \param viewport Viewport struct
@@ -142,21 +557,136 @@ namespace Shift {
         //! \param scissor scissor structure
         void SetScissor(const Rect2D& scissor) const;
 
-        void TransitionTexture(const Texture& texture, EResourceLayout newLayout, EPipelineStageFlags newStageFlags);
+        ///! ------------------- Resource Transitions ------------------- !///
+        //! Transitions are tracked per subresource and only queued, the queued ones go out as one barrier batch right
+        //! before the next render pass, blit, dispatch or EndCmds. Don't transition inside a render pass, nothing is flushed there
+
+        //! Transition a texture for the next stages, reads of the same layout don't get a barrier
+        //! \param texture texture to transition
+        //! \param newLayout layout it has to be in
+        //! \param newStageFlags stages that are going to use it
+        //! \param range subresources, the whole texture if empty
+        void TransitionTexture(const Texture& texture, EResourceLayout newLayout, EPipelineStageFlags newStageFlags, std::optional<TextureSubresourceRange> range = std::nullopt);
 
         void TransitionSwapchainTexture(uint32_t imageIdx, EResourceLayout newLayout, EPipelineStageFlags newStageFlags);
 
+        //! Make the previous writes of a buffer visible to the next access
+        //! \param buffer buffer to transition
+        //! \param access how it's going to be accessed
+        //! \param newStageFlags stages that are going to access it
+        void TransitionBuffer(const Buffer& buffer, EBufferAccess access, EPipelineStageFlags newStageFlags);
+
+        //! Throw away the contents of a texture, its next transition starts from undefined (no copy of old data)
+        //! \param texture texture to discard
+        //! \param aliased textures that used its memory before, its next transition waits for them
+        void DiscardTexture(const Texture& texture, std::span<const Texture* const> aliased = {});
+
+        ///! ------------------- GPU Timers ------------------- !///
+        //! Timestamps around scopes of the frame command buffer, resolved without waiting once the frame slot comes
+        //! around again. Scopes nest and have to be closed in the frame they were opened in.
+
+        //! Open a timer scope
+        //! \param name scope name, copied
+        void BeginGpuTimer(const char* name);
+        //! Close the innermost timer scope
+        void EndGpuTimer();
+
+        //! Times the C++ scope it lives in
+        class GpuTimerScope {
+        public:
+            GpuTimerScope(RenderHardwareInterface& rhi, const char* name): m_rhi{rhi} { m_rhi.BeginGpuTimer(name); }
+            GpuTimerScope(const GpuTimerScope&) = delete;
+            GpuTimerScope& operator=(const GpuTimerScope&) = delete;
+            ~GpuTimerScope() { m_rhi.EndGpuTimer(); }
+        private:
+            RenderHardwareInterface& m_rhi;
+        };
+
+        //! Swap the scopes of the last resolved frame, SHIFT_MAX_FRAMES_IN_FLIGHT frames old, into out. The vector handed
+        //! in is reused for the next results
+        //! \return false if nothing was resolved since the last take, out is left alone then
+        bool TakeGpuTimerResults(std::vector<GpuTimerResult>* out) { return m_local.gpuProfiler.TakeResults(out); }
+        //! GPU time of the whole frame command buffer of the last resolved frame
+        [[nodiscard]] float GetGpuFrameTimeMs() const { return m_local.gpuProfiler.GetFrameTimeMs(); }
+
+        ///! ------------------- Pass Statistics ------------------- !///
+        //! Vertex, primitive and invocation counts plus passed samples of a pass, read back like the GPU timers.
+        //! Pass scopes don't nest, begin and end them outside of render passes
+
+        //! Start counting a pass
+        //! \param name pass name, scopes of the same name are summed per frame
+        void BeginPassStatistics(const char* name);
+        void EndPassStatistics();
+
+        //! Swap the passes of the last resolved frame into out, the vector handed in is reused for the next results
+        //! \return false if nothing was resolved since the last take, out is left alone then
+        bool TakePassStatistics(std::vector<PassStatistics>* out) { return m_local.passQueries.TakeResults(out); }
+
     private:
+        //! Submit the frame together with everything that has to go before it
+        bool SubmitFrame(uint32_t imageIdx);
+        //! A handle texture and what takes its place
+        struct TextureReplacement {
+            TextureHandle handle;
+            //! The new texture, holds the old one after ReplaceTextures
+            Texture texture;
+            //! Mip of the old texture that goes into mip 0 of the new one
+            uint32_t srcBaseMip = 0;
+        };
+        //! Whether handle textures can be swapped in this frame
+        [[nodiscard]] bool CanReplaceTextures() const;
+        //! Copy handle textures into their replacements in the frame command buffer and swap them in behind the handles,
+        //! the bindless slots of the handles move to new ones. Callers keep the moved slots within GetFreeTextureCount
+        void ReplaceTextures(std::span<TextureReplacement> replacements);
+        //! Copy the textures of the next defragmentation pass into their new memory, in the frame command buffer
+        void RecordTextureMoves();
+        //! Drop the top mip of the biggest sampled handle textures while the memory pressure is up
+        void DemoteTextures();
+        //! End the open defragmentation pass once the frame that copied it is done
+        //! \param completedFrame every frame up to this one is done on the GPU
+        void RetireTextureMoves(uint64_t completedFrame);
+
         RHILocal<API> m_local;
 
+        HandlePool<Buffer> m_bufferPool;
+        HandlePool<Texture> m_texturePool;
+        HandlePool<Sampler> m_samplerPool;
+
         std::array<CommandBuffer, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> m_cmdBuffersFlight;
-        std::vector<CommandBuffer> m_cmdBuffersTransfer;
+        //! Async transfer acquires go first in the frame batch, so worker primaries already see the resources
+        std::array<CommandBuffer, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> m_cmdBuffersAcquire;
         //! TODO [DX12] My ass has a feeling that DX12 does not do this
         std::array<Semaphore, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> m_imgAvailableSemaphores;
         //! Since the new VK validation layer spec you now have to ensure that the submit semaphores are per swapchain image
         std::vector<Semaphore> m_renderFinishedSemaphores;
 
+        //! No window, surface and swapchain, frames only render into textures
+        bool m_isHeadless = false;
+
         uint32_t m_currentFrame = 0;
+        //! Frames begun since Init, the deletion queue tags with it
+        uint64_t m_frameNumber = 0;
+        //! Frame number last recorded into each frame slot
+        std::array<uint64_t, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> m_slotFrames{};
+        //! Async transfer timeline value the current frame has to wait for, 0 if none
+        uint64_t m_transferWaitValue = 0;
+        //! Last frame number the frame timeline got signaled with
+        uint64_t m_submittedFrame = 0;
+        //! Async compute batch the current frame has to wait for and the stages that wait, 0 if none
+        uint64_t m_computeWaitValue = 0;
+        EPipelineStageFlags m_computeWaitStages = EPipelineStageFlags::NoneBit;
+
+        //! Old images of the open defragmentation pass, they go once the frame copying out of them is done
+        struct TextureMove {
+            TextureHandle handle;
+            Texture old;
+        };
+        std::vector<TextureMove> m_textureMoves;
+        uint64_t m_textureMoveFrame = 0;
+        //! Bindless slots moved by the texture replacements of this frame
+        std::vector<BindlessMove> m_bindlessMoves;
+        //! Frame the next demotion round can start at
+        uint64_t m_nextDemotionFrame = 0;
     };
 
     template<ValidAPI API>
@@ -194,28 +724,52 @@ namespace Shift {
 #endif
 
 #ifdef SHIFT_VULKAN_BACKEND
-        CheckCritical(m_local.instance.Init(appName, uAppVersion, engineName, uEngVersion), "Failed to create VK instance!");
-        CheckCritical(m_local.surface.Init(m_local.instance.Get(), window), "Failed to create VK surface!");
+        m_isHeadless = window == nullptr;
+        CheckCritical(m_local.instance.Init(appName, uAppVersion, engineName, uEngVersion, m_isHeadless), "Failed to create VK instance!");
+        if (!m_isHeadless) {
+            CheckCritical(m_local.surface.Init(m_local.instance.Get(), window), "Failed to create VK surface!");
+        }
         //! TODO: Features (features could be pulled from API template arg, for now they are just default
-        CheckCritical(m_local.device.Init(m_local.instance, m_local.surface.Get()), "Failed to create VK device!");
-        m_local.cmdPoolStorage.Init(&m_local.device, &m_local.instance);
+        CheckCritical(m_local.device.Init(m_local.instance, (m_isHeadless) ? VK_NULL_HANDLE : m_local.surface.Get()), "Failed to create VK device!");
+        CheckCritical(m_local.textureAllocator.Init(&m_local.device), "Failed to create VK texture allocator!");
+        m_local.memoryBudget.Init(&m_local.device);
+        m_local.cmdPoolStorage.Init(&m_local.device, &m_local.instance, Conf::SHIFT_RECORDING_WORKER_COUNT);
         m_local.descLayoutCache.Init(&m_local.device);
+        m_local.descWriteBatcher.Init(&m_local.device);
+        CheckCritical(m_local.uniformRing.Init(&m_local.device, Conf::SHIFT_UNIFORM_RING_SIZE), "Failed to create VK uniform ring!");
+        m_local.pipelineLayoutCache.Init(&m_local.device, &m_local.descLayoutCache);
+        CheckCritical(m_local.bindlessHeap.Init(&m_local.device, &m_local.descLayoutCache), "Failed to create VK bindless heap!");
+        m_local.pipelineLayoutCache.SetBindlessLayout(m_local.bindlessHeap.GetLayoutDescriptor());
         CheckCritical(m_local.descAllocator.Init(&m_local.device), "Failed to create VK descriptor allocator!");
-        CheckCritical(m_local.swapchain.Init(&m_local.device, &m_local.surface, width, height), "Failed to create VK swapchain!");
+        CheckCritical(m_local.frameDescAllocator.Init(&m_local.device, Conf::SHIFT_TRANSIENT_SETS_PER_FRAME), "Failed to create VK frame descriptor allocator!");
+        CheckCritical(m_local.pipelineCache.Init(&m_local.device, Util::GetShiftRoot() + "Cache/PipelineCache.bin"), "Failed to create VK pipeline cache!");
+        CheckCritical(m_local.pipelineRegistry.Init(&m_local.device, &m_local.pipelineCache), "Failed to create VK pipeline registry!");
+        if (!m_isHeadless) {
+            CheckCritical(m_local.swapchain.Init(&m_local.device, &m_local.surface, width, height), "Failed to create VK swapchain!");
+        }
         for (uint32_t i = 0; i < Conf::SHIFT_MAX_FRAMES_IN_FLIGHT; ++i) {
             CheckCritical(m_cmdBuffersFlight[i].Init(&m_local.device, &m_local.instance, m_local.cmdPoolStorage.GetGraphics(), EPoolQueueType::Graphics), "Failed to create VK command buffer in flight!");
+            CheckCritical(m_cmdBuffersAcquire[i].Init(&m_local.device, &m_local.instance, m_local.cmdPoolStorage.GetGraphics(), EPoolQueueType::Graphics), "Failed to create VK acquire command buffer!");
         }
-
-        // Only 1 transfer queue for now
-        CommandBuffer b;
-        CheckCritical(b.Init(&m_local.device, &m_local.instance, m_local.cmdPoolStorage.GetTransfer(), EPoolQueueType::Transfer), "Failed to create VK command buffer for tranfer!");
-        m_cmdBuffersTransfer.push_back(b);
-
-        CommandBuffer b2;
-        CheckCritical(b2.Init(&m_local.device, &m_local.instance, m_local.cmdPoolStorage.GetTransfer(), EPoolQueueType::Transfer), "Failed to create VK command buffer for tranfer 2!");
-        m_cmdBuffersTransfer.push_back(b2);
+        CheckCritical(m_local.parallelRecorder.Init(&m_local.device, &m_local.instance, &m_local.cmdPoolStorage), "Failed to create VK parallel recorder!");
+
+        //! Uploads go through the graphics queue, so they are ordered with the frame without extra sync
+        CheckCritical(m_local.uploadManager.Init(&m_local.device, &m_local.instance, m_local.cmdPoolStorage.GetGraphics(), &m_local.stateTracker, Conf::SHIFT_UPLOAD_RING_SIZE), "Failed to create VK upload manager!");
+        CheckCritical(m_local.readbackRing.Init(&m_local.device, Conf::SHIFT_READBACK_RING_SIZE), "Failed to create VK readback ring!");
+        CheckCritical(m_local.asyncTransfer.Init(&m_local.device, &m_local.instance, m_local.cmdPoolStorage.GetTransfer(), Conf::SHIFT_ASYNC_TRANSFER_RING_SIZE), "Failed to create VK async transfer queue!");
+        CheckCritical(m_local.asyncCompute.Init(&m_local.device, &m_local.instance, m_local.cmdPoolStorage.GetCompute()), "Failed to create VK async compute queue!");
+        CheckCritical(m_local.frameTimeline.Init(&m_local.device, 0), "Failed to create VK frame timeline semaphore!");
+        CheckCritical(m_local.geometryArena.Init(&m_local.device, Conf::SHIFT_GEOMETRY_VERTEX_STRIDE, Conf::SHIFT_GEOMETRY_VERTEX_COUNT, Conf::SHIFT_GEOMETRY_INDEX_COUNT), "Failed to create VK geometry arena!");
+        CheckCritical(m_local.gpuProfiler.Init(&m_local.device), "Failed to create VK GPU profiler!");
+        CheckCritical(m_local.passQueries.Init(&m_local.device), "Failed to create VK pass queries!");
+        m_local.deletionQueue.Init(&m_local.asyncTransfer.GetTimeline(), &m_local.asyncCompute.GetTimeline());
+        m_local.swapchain.VK_SetDeletionQueue(&m_local.deletionQueue);
 #endif
 
+        if (m_isHeadless) {
+            Log(Info, "Running headless, frames render into textures only");
+            return true;
+        }
         for (uint32_t i = 0; i < Conf::SHIFT_MAX_FRAMES_IN_FLIGHT; ++i) {
             CheckCritical(m_imgAvailableSemaphores[i].Init(&m_local.device), "Failed to create image available semaphore!");
         }
@@ -230,29 +784,74 @@ namespace Shift {
 
     template<ValidAPI API>
     void RenderHardwareInterface<API>::Destroy() {
+        //! The caller waited for the GPU, the copies of an open pass are done
+        RetireTextureMoves(UINT64_MAX);
 
-        m_local.swapchain.Destroy();
-
-        for (auto& sem: m_imgAvailableSemaphores) {
-            sem.Destroy();
+        if (uint32_t leaked = m_bufferPool.GetCount() + m_texturePool.GetCount() + m_samplerPool.GetCount(); leaked > 0) {
+            Log(Warning, "{} pooled resources were never destroyed, destroying them with the RHI", leaked);
         }
-        for (auto& sem: m_renderFinishedSemaphores) {
-            sem.Destroy();
+        for (auto& buffer: m_bufferPool.GetObjects()) { DestroyBuffer(buffer); }
+        for (auto& texture: m_texturePool.GetObjects()) { DestroyTexture(texture); }
+        for (auto& sampler: m_samplerPool.GetObjects()) { DestroySampler(sampler); }
+        m_bufferPool.Clear();
+        m_texturePool.Clear();
+        m_samplerPool.Clear();
+
+        //! The caller waited for the GPU, whatever was deferred goes before the things it may depend on
+        m_local.deletionQueue.Destroy();
+        m_local.swapchain.VK_SetDeletionQueue(nullptr);
+
+        if (!m_isHeadless) {
+            m_local.swapchain.Destroy();
+
+            for (auto& sem: m_imgAvailableSemaphores) {
+                sem.Destroy();
+            }
+            for (auto& sem: m_renderFinishedSemaphores) {
+                sem.Destroy();
+            }
+            m_renderFinishedSemaphores.clear();
         }
 
         //! cmd Destroy just destroys the fence
         for (auto& cmd: m_cmdBuffersFlight) {
             cmd.Destroy();
         }
-        for (auto& cmd: m_cmdBuffersTransfer) {
+        for (auto& cmd: m_cmdBuffersAcquire) {
             cmd.Destroy();
         }
-
+        m_local.parallelRecorder.Destroy();
+        m_local.uploadManager.Destroy();
+        m_local.readbackRing.Destroy();
+        m_local.asyncTransfer.Destroy();
+        m_local.asyncCompute.Destroy();
+        m_local.frameTimeline.Destroy();
+        m_local.geometryArena.Destroy();
+        //! Every pooled texture is gone with the deletion queue
+        m_local.textureAllocator.Destroy();
+        m_local.memoryBudget.Destroy();
+
+        m_local.pipelineRegistry.Destroy();
+        m_local.pipelineLayoutCache.Destroy();
+        m_local.bindlessHeap.Destroy();
         m_local.descLayoutCache.Destroy();
         m_local.descAllocator.Destroy();
+        m_local.frameDescAllocator.Destroy();
+        m_local.uniformRing.Destroy();
+        m_local.stateTracker.Destroy();
+        m_local.gpuProfiler.Destroy();
+        m_local.passQueries.Destroy();
+
+        m_local.pipelineCache.ReportStats();
+        if (!m_local.pipelineCache.Save()) {
+            Log(Warning, "Failed to save the pipeline cache, next start is going to be cold");
+        }
+        m_local.pipelineCache.Destroy();
 
         m_local.cmdPoolStorage.Destroy();
-        m_local.surface.Destroy();
+        if (!m_isHeadless) {
+            m_local.surface.Destroy();
+        }
 
         m_local.device.Destroy();
         m_local.instance.Destroy();
@@ -268,10 +867,68 @@ namespace Shift {
     template<ValidAPI API>
     Texture RenderHardwareInterface<API>::CreateTexture(const TextureDescriptor &desc) {
         Texture t;
-        t.Init(&m_local.device, desc);
+        t.Init(&m_local.device, desc, &m_local.textureAllocator);
+        return t;
+    }
+
+    template<ValidAPI API>
+    MemoryBlock RenderHardwareInterface<API>::CreateMemoryBlock(const TextureMemoryRequirements &requirements) {
+        MemoryBlock b;
+        if (!b.Init(&m_local.device, requirements)) {
+            Log(Error, "Failed to create a memory block!");
+        }
+        return b;
+    }
+
+    template<ValidAPI API>
+    Texture RenderHardwareInterface<API>::CreatePlacedTexture(const TextureDescriptor &desc, const MemoryBlock &block, uint64_t offset) {
+        Texture t;
+        t.InitPlaced(&m_local.device, desc, block, offset);
         return t;
     }
 
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroyBuffer(Buffer &buffer) {
+        //! The state goes now, a new buffer may get the same handle before the old one is freed
+        m_local.stateTracker.Forget(buffer);
+        m_local.deletionQueue.Push([buffer]() mutable { buffer.Destroy(); }, m_local.asyncTransfer.GetLastValue(), m_local.asyncCompute.GetLastValue());
+        buffer = {};
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroyTexture(Texture &texture) {
+        m_local.stateTracker.Forget(texture);
+        //! Defragmentation passes opened before the free leave the allocation where it is
+        m_local.textureAllocator.MarkPendingDestroy(texture.GetAlloc());
+        m_local.deletionQueue.Push([this, texture]() mutable { m_local.textureAllocator.DestroyTexture(texture); },
+            m_local.asyncTransfer.GetLastValue(), m_local.asyncCompute.GetLastValue());
+        texture = {};
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroyMemoryBlock(MemoryBlock &block) {
+        m_local.deletionQueue.Push([block]() mutable { block.Destroy(); }, 0, m_local.asyncCompute.GetLastValue());
+        block = {};
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroySampler(Sampler &sampler) {
+        m_local.deletionQueue.Push([sampler]() mutable { sampler.Destroy(); }, 0, m_local.asyncCompute.GetLastValue());
+        sampler = {};
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroyPipeline(Pipeline &pipeline) {
+        m_local.deletionQueue.Push([pipeline]() mutable { pipeline.Destroy(); }, 0, m_local.asyncCompute.GetLastValue());
+        pipeline = {};
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroyShader(Shader &shader) {
+        m_local.deletionQueue.Push([shader]() mutable { shader.Destroy(); });
+        shader = {};
+    }
+
     template<ValidAPI API>
     Sampler RenderHardwareInterface<API>::CreateSampler(const SamplerDescriptor &desc) {
         Sampler s;
@@ -281,34 +938,203 @@ namespace Shift {
     }
 
     template<ValidAPI API>
-    Shader RenderHardwareInterface<API>::CreateShader(const ShaderDescriptor &desc) {
-        Shader s;
-        s.Init(&m_local.device, desc);
+    BufferHandle RenderHardwareInterface<API>::CreateBufferHandle(const BufferDescriptor &desc) {
+        Buffer b = CreateBuffer(desc);
+        if (!b.IsValid()) { return {}; }
+        return m_bufferPool.Insert(std::move(b));
+    }
 
-        return s;
+    template<ValidAPI API>
+    TextureHandle RenderHardwareInterface<API>::CreateTextureHandle(const TextureDescriptor &desc) {
+        Texture t = CreateTexture(desc);
+        if (!t.IsValid()) { return {}; }
+        TextureHandle handle = m_texturePool.Insert(std::move(t));
+        //! Behind a handle the texture can be swapped for its moved copy, so defragmentation may move it
+        m_local.textureAllocator.SetOwner(m_texturePool.Get(handle)->GetAlloc(), handle);
+        return handle;
+    }
+
+    template<ValidAPI API>
+    SamplerHandle RenderHardwareInterface<API>::CreateSamplerHandle(const SamplerDescriptor &desc) {
+        Sampler s = CreateSampler(desc);
+        if (!s.IsValid()) { return {}; }
+        return m_samplerPool.Insert(std::move(s));
+    }
+
+    template<ValidAPI API>
+    template<typename T>
+    bool RenderHardwareInterface<API>::IsAlive(Handle<T> handle) const {
+        if constexpr (std::same_as<T, Buffer>) {
+            return m_bufferPool.IsAlive(handle);
+        } else if constexpr (std::same_as<T, Texture>) {
+            return m_texturePool.IsAlive(handle);
+        } else {
+            static_assert(std::same_as<T, Sampler>, "No pool for this resource type");
+            return m_samplerPool.IsAlive(handle);
+        }
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroyBuffer(BufferHandle handle) {
+        if (std::optional<Buffer> b = m_bufferPool.Remove(handle)) {
+            DestroyBuffer(*b);
+        }
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroyTexture(TextureHandle handle) {
+        if (std::optional<Texture> t = m_texturePool.Remove(handle)) {
+            DestroyTexture(*t);
+        }
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroySampler(SamplerHandle handle) {
+        if (std::optional<Sampler> s = m_samplerPool.Remove(handle)) {
+            DestroySampler(*s);
+        }
+    }
+
+    template<ValidAPI API>
+    EPipelineStatus RenderHardwareInterface<API>::GetPipelineStatus(PipelineHandle handle) const {
+        return m_local.pipelineRegistry.GetStatus(handle);
+    }
+
+    template<ValidAPI API>
+    const Pipeline* RenderHardwareInterface<API>::GetPipeline(PipelineHandle handle, PipelineHandle fallback) const {
+        const Pipeline* pipeline = m_local.pipelineRegistry.Get(handle);
+        return (pipeline != nullptr) ? pipeline : m_local.pipelineRegistry.Get(fallback);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::WaitForPipeline(PipelineHandle handle) const {
+        m_local.pipelineRegistry.Wait(handle);
+    }
+
+    template<ValidAPI API>
+    BindlessHandle RenderHardwareInterface<API>::AddBindlessTexture(const Texture &texture) {
+        return m_local.bindlessHeap.AddTexture(texture);
+    }
+
+    template<ValidAPI API>
+    BindlessHandle RenderHardwareInterface<API>::AddBindlessTexture(TextureHandle handle) {
+        const Texture* texture = m_texturePool.Get(handle);
+        if (texture == nullptr) { return {}; }
+        return m_local.bindlessHeap.AddTexture(*texture, handle);
+    }
+
+    template<ValidAPI API>
+    BindlessHandle RenderHardwareInterface<API>::AddBindlessSampler(const Sampler &sampler) {
+        return m_local.bindlessHeap.AddSampler(sampler);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::UpdateBindlessTexture(BindlessHandle handle, const Texture &texture) {
+        m_local.bindlessHeap.UpdateTexture(handle, texture);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::RemoveBindless(BindlessHandle handle) {
+        m_local.bindlessHeap.Remove(handle);
+    }
+
+    template<ValidAPI API>
+    uint32_t RenderHardwareInterface<API>::PushUniform(const void *data, uint32_t size) {
+        return m_local.uniformRing.Push(data, size);
     }
 
     template<ValidAPI API>
     uint32_t RenderHardwareInterface<API>::SwapchainAquireImage(bool *wasChanged) {
+        if (m_isHeadless) {
+            Log(Error, "There is no swapchain to acquire from when headless!");
+            return UINT32_MAX;
+        }
         return m_local.swapchain.AquireNextImage(m_imgAvailableSemaphores[m_currentFrame], wasChanged);
     }
 
     template<ValidAPI API>
     uint32_t RenderHardwareInterface<API>::SwapchainPresent(uint32_t imageIdx, bool *isOld) {
+        if (m_isHeadless) {
+            Log(Error, "There is no swapchain to present to when headless!");
+            return false;
+        }
         return m_local.swapchain.Present(m_renderFinishedSemaphores[imageIdx], imageIdx, isOld);
     }
 
     template<ValidAPI API>
-    bool RenderHardwareInterface<API>::BeginCmds() const {
+    bool RenderHardwareInterface<API>::SwapchainRecreate(uint32_t width, uint32_t height) {
+        if (m_isHeadless) { return false; }
+        if (!m_local.swapchain.Recreate(width, height)) { return false; }
+
+        //! The image count can grow with the new surface capabilities, every image needs its own submit semaphore
+        for (size_t i = m_renderFinishedSemaphores.size(); i < m_local.swapchain.GetImages().size(); ++i) {
+            Semaphore& sem = m_renderFinishedSemaphores.emplace_back();
+            if (!sem.Init(&m_local.device)) {
+                Log(Error, "Failed to create submit semaphore!");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<ValidAPI API>
+    bool RenderHardwareInterface<API>::BeginCmds() {
         if (!m_cmdBuffersFlight[m_currentFrame].IsAvailable()) {
             m_cmdBuffersFlight[m_currentFrame].Wait();
         }
+
+        //! The slot fence has signaled, so every frame before this one is done, except the ones other slots still run
+        m_slotFrames[m_currentFrame] = ++m_frameNumber;
+        uint64_t completedFrame = m_frameNumber - 1;
+        for (uint32_t i = 0; i < Conf::SHIFT_MAX_FRAMES_IN_FLIGHT; ++i) {
+            if (i != m_currentFrame && m_slotFrames[i] != 0 && !m_cmdBuffersFlight[i].IsAvailable()) {
+                completedFrame = std::min(completedFrame, m_slotFrames[i] - 1);
+            }
+        }
+        //! Before the deletion queue, moved textures destroyed since their pass began keep their memory until it ends
+        RetireTextureMoves(completedFrame);
+        m_local.deletionQueue.BeginFrame(m_frameNumber, completedFrame);
+        //! Readback callbacks run here, before anything of the new frame is recorded
+        m_local.readbackRing.BeginFrame(completedFrame);
+        //! After the frees, so the usage has what the retired frames gave back
+        m_local.memoryBudget.BeginFrame(m_frameNumber);
+
+        //! Uploads of this slot were submitted before the frame we just waited for, so this won't block
+        m_local.uploadManager.BeginFrame(m_currentFrame);
+        m_local.parallelRecorder.BeginFrame(m_currentFrame);
+        m_local.bindlessHeap.BeginFrame(m_currentFrame);
+        m_local.frameDescAllocator.BeginFrame(m_currentFrame);
+        m_local.uniformRing.BeginFrame(m_currentFrame);
+
+        //! Take ownership of whatever finished streaming in since the last frame
+        CommandBuffer& acquireCmd = m_cmdBuffersAcquire[m_currentFrame];
+        acquireCmd.Reset();
+        if (!acquireCmd.Begin()) { return false; }
+        m_transferWaitValue = m_local.asyncTransfer.RecordAcquires(acquireCmd);
+        if (!acquireCmd.End()) { return false; }
+
         m_cmdBuffersFlight[m_currentFrame].Reset();
-        return m_cmdBuffersFlight[m_currentFrame].Begin();
+        if (!m_cmdBuffersFlight[m_currentFrame].Begin()) { return false; }
+        m_local.stateTracker.Begin(&m_cmdBuffersFlight[m_currentFrame]);
+        //! The fence above has signaled, so the timers this slot recorded last time are read back without waiting
+        m_local.gpuProfiler.BeginFrame(m_currentFrame, m_cmdBuffersFlight[m_currentFrame]);
+        m_local.passQueries.BeginFrame(m_currentFrame, m_cmdBuffersFlight[m_currentFrame]);
+        m_bindlessMoves.clear();
+        DemoteTextures();
+        RecordTextureMoves();
+        return true;
     }
 
     template<ValidAPI API>
-    bool RenderHardwareInterface<API>::EndCmds() const {
+    bool RenderHardwareInterface<API>::EndCmds() {
+        //! The host reads the copies once the frame fence signaled, that alone doesn't make them visible to it
+        if (m_local.readbackRing.HasFrameCopies()) {
+            TransitionBuffer(m_local.readbackRing.GetBuffer(), EBufferAccess::HostRead, EPipelineStageFlags::HostBit);
+            m_local.readbackRing.EndFrame();
+        }
+        m_local.stateTracker.Flush();
+        m_local.passQueries.EndFrame();
+        m_local.gpuProfiler.EndFrame();
         return m_cmdBuffersFlight[m_currentFrame].End();
     }
 
@@ -318,16 +1144,38 @@ namespace Shift {
     }
 
     template<ValidAPI API>
-    bool RenderHardwareInterface<API>::SubmitCmds(uint32_t imageIdx) const {
-        return m_cmdBuffersFlight[m_currentFrame].Submit(m_imgAvailableSemaphores[m_currentFrame], m_renderFinishedSemaphores[imageIdx]);
+    bool RenderHardwareInterface<API>::SubmitCmds(uint32_t imageIdx) {
+        return SubmitFrame(imageIdx);
     }
 
     template<ValidAPI API>
-    bool RenderHardwareInterface<API>::SubmitCmdsAndWait(uint32_t imageIdx) const {
-        return m_cmdBuffersFlight[m_currentFrame].SubmitAndWait(m_imgAvailableSemaphores[m_currentFrame], m_renderFinishedSemaphores[imageIdx]);
+    bool RenderHardwareInterface<API>::SubmitCmdsAndWait(uint32_t imageIdx) {
+        bool res = SubmitFrame(imageIdx);
+        m_cmdBuffersFlight[m_currentFrame].Wait();
+        return res;
     }
 
 
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::BeginGpuTimer(const char *name) {
+        m_local.gpuProfiler.BeginTimer(name);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::EndGpuTimer() {
+        m_local.gpuProfiler.EndTimer();
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::BeginPassStatistics(const char *name) {
+        m_local.passQueries.BeginPass(name);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::EndPassStatistics() {
+        m_local.passQueries.EndPass();
+    }
+
     template<ValidAPI API>
     void RenderHardwareInterface<API>::EndRenderPass() {
 #ifdef SHIFT_VULKAN_BACKEND
@@ -336,24 +1184,105 @@ namespace Shift {
     }
 
     template<ValidAPI API>
-    void RenderHardwareInterface<API>::CopyBufferToBuffer(const BufferOpDescriptor &srcBuf,
-        const BufferOpDescriptor &dstBuf, uint32_t size) const {
+    uint32_t RenderHardwareInterface<API>::GetRecordingWorkerCount() const {
+        return m_local.parallelRecorder.GetWorkerCount();
+    }
+
+    template<ValidAPI API>
+    CommandBuffer* RenderHardwareInterface<API>::BeginWorkerCmds(uint32_t workerIdx) {
+        return m_local.parallelRecorder.BeginPrimary(workerIdx);
+    }
 
-        m_cmdBuffersTransfer[m_currentFrame].Reset();
-        m_cmdBuffersTransfer[m_currentFrame].Begin();
-        m_cmdBuffersTransfer[m_currentFrame].CopyBufferToBuffer(srcBuf, dstBuf, size);
-        m_cmdBuffersTransfer[m_currentFrame].End();
-        m_cmdBuffersTransfer[m_currentFrame].SubmitAndWait();
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::ExecuteSecondaryCmds(std::span<CommandBuffer* const> cmds) const {
+        m_cmdBuffersFlight[m_currentFrame].ExecuteCommands(cmds);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::CopyBufferToBuffer(const BufferOpDescriptor &srcBuf,
+        const BufferOpDescriptor &dstBuf, uint32_t size) {
+        if (!m_local.uploadManager.CopyBufferToBuffer(srcBuf, dstBuf, size)) {
+            Log(Error, "Failed to record a buffer to buffer copy!");
+        }
     }
 
     template<ValidAPI API>
     void RenderHardwareInterface<API>::CopyBufferToTexture(const BufferOpDescriptor &srcBuf,
-        const TextureCopyDescriptor &dstTex) const {
-        m_cmdBuffersTransfer[m_currentFrame].Reset();
-        m_cmdBuffersTransfer[m_currentFrame].Begin();
-        m_cmdBuffersTransfer[m_currentFrame].CopyBufferToTexture(srcBuf, dstTex);
-        m_cmdBuffersTransfer[m_currentFrame].End();
-        m_cmdBuffersTransfer[m_currentFrame].SubmitAndWait();
+        const TextureCopyDescriptor &dstTex) {
+        if (!m_local.uploadManager.CopyBufferToTexture(srcBuf, dstTex)) {
+            Log(Error, "Failed to record a buffer to texture copy!");
+        }
+    }
+
+    template<ValidAPI API>
+    bool RenderHardwareInterface<API>::UploadToBuffer(const void *data, uint64_t size, const BufferOpDescriptor &dstBuf) {
+        return m_local.uploadManager.UploadToBuffer(data, size, dstBuf);
+    }
+
+    template<ValidAPI API>
+    bool RenderHardwareInterface<API>::UploadToTexture(const void *data, uint64_t size,
+        const TextureCopyDescriptor &dstTex, EResourceLayout finalLayout) {
+        return m_local.uploadManager.UploadToTexture(data, size, dstTex, finalLayout);
+    }
+
+    template<ValidAPI API>
+    bool RenderHardwareInterface<API>::FlushUploads(bool wait) {
+        return (wait) ? m_local.uploadManager.FlushAndWait() : m_local.uploadManager.Flush();
+    }
+
+    template<ValidAPI API>
+    TransferToken RenderHardwareInterface<API>::UploadToBufferAsync(const void *data, uint64_t size, const BufferOpDescriptor &dstBuf) {
+        return m_local.asyncTransfer.UploadToBuffer(data, size, dstBuf);
+    }
+
+    template<ValidAPI API>
+    TransferToken RenderHardwareInterface<API>::UploadToTextureAsync(const void *data, uint64_t size,
+        const TextureCopyDescriptor &dstTex, EResourceLayout finalLayout) {
+        TransferToken token = m_local.asyncTransfer.UploadToTexture(data, size, dstTex, finalLayout);
+        if (token.IsValid()) {
+            //! The layout is what the graphics queue sees once the token is ready
+            m_local.stateTracker.AssumeTextureState(*dstTex.texture, VK::Util::ShiftToVKSubresourceRange(dstTex.subresourceRange),
+                VK::Util::ShiftToVKResourceLayout(finalLayout), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+        }
+        return token;
+    }
+
+    template<ValidAPI API>
+    bool RenderHardwareInterface<API>::SubmitAsyncUploads() {
+        return m_local.asyncTransfer.Submit();
+    }
+
+    template<ValidAPI API>
+    bool RenderHardwareInterface<API>::IsTransferReady(TransferToken token) const {
+        return m_local.asyncTransfer.IsReady(token);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::WaitForTransfer(TransferToken token) {
+        m_local.asyncTransfer.Wait(token);
+    }
+
+    template<ValidAPI API>
+    const CommandBuffer* RenderHardwareInterface<API>::BeginAsyncCompute() {
+        return m_local.asyncCompute.Begin();
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::AsyncComputeBarrier() {
+        m_local.asyncCompute.Barrier();
+    }
+
+    template<ValidAPI API>
+    ComputeToken RenderHardwareInterface<API>::SubmitAsyncCompute(uint64_t graphicsWaitFrame) {
+        return m_local.asyncCompute.Submit(m_local.frameTimeline, std::min(graphicsWaitFrame, m_submittedFrame));
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::AddAsyncComputeWait(ComputeToken token, EPipelineStageFlags stages) {
+        if (!token.IsValid()) { return; }
+
+        m_computeWaitValue = std::max(m_computeWaitValue, token.value);
+        m_computeWaitStages |= (stages == EPipelineStageFlags::NoneBit) ? EPipelineStageFlags::AllCommandsBit : stages;
     }
 
     template<ValidAPI API>
@@ -372,9 +1301,77 @@ namespace Shift {
         m_cmdBuffersFlight[m_currentFrame].BindIndexBuffer(buffer, indexSize);
     }
 
+    template<ValidAPI API>
+    MeshHandle RenderHardwareInterface<API>::CreateMesh(const void *vertices, uint32_t vertexCount, std::span<const uint32_t> indices) {
+        auto indexCount = static_cast<uint32_t>(indices.size());
+        MeshHandle handle = m_local.geometryArena.Allocate(vertexCount, indexCount);
+        const MeshRange* range = m_local.geometryArena.Get(handle);
+        if (range == nullptr) { return {}; }
+
+        uint32_t stride = m_local.geometryArena.GetVertexStride();
+        bool uploaded = m_local.uploadManager.UploadToBuffer(vertices, static_cast<uint64_t>(vertexCount) * stride,
+            {&m_local.geometryArena.GetVertexBuffer(), static_cast<uint32_t>(range->vertexOffset) * stride});
+        if (uploaded && indexCount > 0) {
+            uploaded = m_local.uploadManager.UploadToBuffer(indices.data(), indices.size_bytes(),
+                {&m_local.geometryArena.GetIndexBuffer(), range->firstIndex * static_cast<uint32_t>(sizeof(uint32_t))});
+        }
+        if (!uploaded) {
+            Log(Error, "Failed to upload the mesh data!");
+            DestroyMesh(handle);
+            return {};
+        }
+        return handle;
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DestroyMesh(MeshHandle handle) {
+        if (auto allocation = m_local.geometryArena.Remove(handle)) {
+            m_local.deletionQueue.Push([this, allocation = *allocation]() { m_local.geometryArena.Free(allocation); });
+        }
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::BindGeometryArena() {
+        const CommandBuffer& cmd = m_cmdBuffersFlight[m_currentFrame];
+        cmd.BindVertexBuffer({&m_local.geometryArena.GetVertexBuffer(), 0}, 0);
+        cmd.BindIndexBuffer({&m_local.geometryArena.GetIndexBuffer(), 0}, EIndexSize::UInt32);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DrawMesh(MeshHandle handle, uint32_t instanceCount, uint32_t firstInstance) const {
+        const MeshRange* range = m_local.geometryArena.Get(handle);
+        if (range == nullptr) { return; }
+
+        const CommandBuffer& cmd = m_cmdBuffersFlight[m_currentFrame];
+        if (range->indexCount > 0) {
+            cmd.DrawIndexed({range->indexCount, instanceCount, range->firstIndex, range->vertexOffset, firstInstance});
+        } else {
+            cmd.Draw({range->vertexCount, instanceCount, static_cast<uint32_t>(range->vertexOffset), firstInstance});
+        }
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::BindVertexBuffer(BufferHandle buffer, uint32_t bindIdx, uint32_t offset) {
+        Buffer* b = m_bufferPool.Get(buffer);
+        if (b == nullptr) { return; }
+        m_cmdBuffersFlight[m_currentFrame].BindVertexBuffer({b, offset}, bindIdx);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::BindIndexBuffer(BufferHandle buffer, EIndexSize indexSize, uint32_t offset) {
+        Buffer* b = m_bufferPool.Get(buffer);
+        if (b == nullptr) { return; }
+        m_cmdBuffersFlight[m_currentFrame].BindIndexBuffer({b, offset}, indexSize);
+    }
+
     template<ValidAPI API>
     void RenderHardwareInterface<API>::BindGraphicsPipeline(const Pipeline &pipeline) const {
-        m_cmdBuffersFlight[m_currentFrame].BindGraphicsPipeline(pipeline);
+        BindGraphicsPipeline(m_cmdBuffersFlight[m_currentFrame], pipeline);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::BindResourceSets(const Pipeline &pipeline, std::span<const ResourceSet* const> sets, uint32_t firstSet, std::span<const uint32_t> dynamicOffsets) const {
+        BindResourceSets(m_cmdBuffersFlight[m_currentFrame], pipeline, sets, firstSet, dynamicOffsets);
     }
 
     template<ValidAPI API>
@@ -387,13 +1384,56 @@ namespace Shift {
         m_cmdBuffersFlight[m_currentFrame].Draw(drawConf);
     }
 
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DrawIndexedIndirect(const BufferOpDescriptor &args, uint32_t drawCount) const {
+        if (drawCount > 1 && !SupportsMultiDrawIndirect()) {
+            for (uint32_t draw = 0; draw < drawCount; ++draw) {
+                m_cmdBuffersFlight[m_currentFrame].DrawIndexedIndirect({args.buffer, args.offset + draw * static_cast<uint32_t>(sizeof(DrawIndexedConfig))},
+                                                                       1, sizeof(DrawIndexedConfig));
+            }
+            return;
+        }
+        m_cmdBuffersFlight[m_currentFrame].DrawIndexedIndirect(args, drawCount, sizeof(DrawIndexedConfig));
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DrawIndexedIndirectCount(const BufferOpDescriptor &args, const BufferOpDescriptor &count, uint32_t maxDrawCount) const {
+        m_cmdBuffersFlight[m_currentFrame].DrawIndexedIndirectCount(args, count, maxDrawCount, sizeof(DrawIndexedConfig));
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+        m_local.stateTracker.Flush();
+        m_cmdBuffersFlight[m_currentFrame].Dispatch(groupCountX, groupCountY, groupCountZ);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DispatchIndirect(const BufferOpDescriptor &buffer) {
+        m_local.stateTracker.Flush();
+        m_cmdBuffersFlight[m_currentFrame].DispatchIndirect(buffer);
+    }
+
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::DispatchIndirect(BufferHandle buffer, uint32_t offset) {
+        Buffer* b = m_bufferPool.Get(buffer);
+        if (b == nullptr) { return; }
+        DispatchIndirect({b, offset});
+    }
+
     template<ValidAPI API>
     void RenderHardwareInterface<API>::BlitTexture(const TextureBlitData &srcTexture, const TextureBlitData &dstTexture,
-        const TextureBlitRegion &blitRegion, EFilterMode filter) const
+        const TextureBlitRegion &blitRegion, EFilterMode filter)
     {
+        m_local.stateTracker.Flush();
         m_cmdBuffersFlight[m_currentFrame].BlitTexture(srcTexture, dstTexture, blitRegion, filter);
     }
 
+    template<ValidAPI API>
+    void RenderHardwareInterface<API>::FillBuffer(const BufferOpDescriptor &dstBuf, uint64_t size, uint32_t value) {
+        m_local.stateTracker.Flush();
+        m_cmdBuffersFlight[m_currentFrame].FillBuffer(dstBuf, size, value);
+    }
+
     template<ValidAPI API>
     void RenderHardwareInterface<API>::SetViewport(const Viewport& viewport) const {
         m_cmdBuffersFlight[m_currentFrame].SetViewport(viewport);
@@ -413,71 +1453,196 @@ namespace Shift {
         vkDeviceWaitIdle(m_local.device.Get());
     }
 
+    template<>
+    inline bool RenderHardwareInterface<RHI::Vulkan>::SubmitFrame(uint32_t imageIdx) {
+        if (!m_local.asyncTransfer.Submit()) {
+            Log(Error, "Failed to submit the async uploads!");
+        }
+        if (!m_local.uploadManager.Flush()) {
+            Log(Error, "Failed to submit the frame uploads!");
+            return false;
+        }
+        //! Update after bind, the heap writes only have to land before the submit
+        m_local.bindlessHeap.Flush();
+        m_local.uniformRing.Flush();
+
+        //! One batch: acquires, worker primaries, frame buffer. The frame fence covers all of them
+        std::vector<VkCommandBuffer> precedingBuffers;
+        if (m_transferWaitValue != 0) {
+            precedingBuffers.push_back(m_cmdBuffersAcquire[m_currentFrame].VK_Get());
+        }
+        m_local.parallelRecorder.GatherPrimaries(&precedingBuffers);
+
+        std::array<VkSemaphore, 3> waitSemaphores{};
+        std::array<VkPipelineStageFlags, 3> waitStages{};
+        std::array<uint64_t, 3> waitValues{};
+        size_t waitCount = 0;
+        //! Headless frames only render into textures, there is no swapchain image to wait for or to present
+        if (!m_isHeadless) {
+            waitSemaphores[waitCount] = m_imgAvailableSemaphores[m_currentFrame].Get();
+            waitStages[waitCount] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            waitValues[waitCount++] = 0;
+        }
+        //! The acquired batches are complete already, the timeline wait is there to satisfy the release->acquire ordering
+        if (m_transferWaitValue != 0) {
+            waitSemaphores[waitCount] = m_local.asyncTransfer.GetTimeline().Get();
+            waitStages[waitCount] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            waitValues[waitCount++] = m_transferWaitValue;
+        }
+        //! Only the stages that use the compute results wait, the rest of the frame overlaps the batch
+        if (m_computeWaitValue != 0) {
+            waitSemaphores[waitCount] = m_local.asyncCompute.GetTimeline().Get();
+            waitStages[waitCount] = VK::Util::ShiftToVKPipelineStageFlags(m_computeWaitStages);
+            waitValues[waitCount++] = m_computeWaitValue;
+        }
+
+        //! The frame timeline is what async compute batches wait for, the binary value is ignored
+        std::array<VkSemaphore, 2> sigSemaphores{m_local.frameTimeline.Get()};
+        std::array<uint64_t, 2> sigValues{m_frameNumber};
+        size_t sigCount = 1;
+        if (!m_isHeadless) {
+            sigSemaphores[sigCount] = m_renderFinishedSemaphores[imageIdx].Get();
+            sigValues[sigCount++] = 0;
+        }
+
+        const CommandBuffer& cmd = m_cmdBuffersFlight[m_currentFrame];
+        bool res = cmd.VK_Submit(
+            std::span{waitSemaphores.data(), waitCount},
+            std::span{waitStages.data(), waitCount},
+            std::span{waitValues.data(), waitCount},
+            std::span{sigSemaphores.data(), sigCount},
+            std::span{sigValues.data(), sigCount},
+            precedingBuffers
+        );
+        if (res) {
+            m_local.asyncTransfer.ConfirmAcquires();
+            m_transferWaitValue = 0;
+            m_submittedFrame = m_frameNumber;
+        }
+        //! A failed submission drops the waits too, the batches are still there for the next frame to wait on
+        m_computeWaitValue = 0;
+        m_computeWaitStages = EPipelineStageFlags::NoneBit;
+        return res;
+    }
+
     template<>
     inline Pipeline RenderHardwareInterface<RHI::Vulkan>::CreatePipeline(const PipelineDescriptor &desc,
         const std::vector<ShaderStageDesc> &shaders)
     {
         Pipeline p;
 
-        std::vector<VkDescriptorSetLayout> setLayouts;
-        setLayouts.reserve(desc.descriptorLayouts.size());
-
-        // For each layout, create the descriptor set layout
-        for (const auto& layoutDesc : desc.descriptorLayouts) {
-            std::vector<VkDescriptorSetLayoutBinding> vkBindings;
-            vkBindings.reserve(layoutDesc.bindings.size());
-
-            for (const auto& b : layoutDesc.bindings) {
-                VkDescriptorSetLayoutBinding binding{};
-                binding.binding = b.binding;
-                binding.descriptorCount = b.count;
-                binding.stageFlags = VK::Util::ShiftToVKBindingVisibility(b.stageFlags);
-                binding.descriptorType = VK::Util::ShiftToVKBindingType(b.type);
-                binding.pImmutableSamplers = nullptr; // handle immutable samplers if needed
-                vkBindings.push_back(binding);
-            }
+        PipelineDescriptor resolved = desc;
+        VkPipelineLayout layout = m_local.pipelineLayoutCache.Resolve(shaders, &resolved);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        p.Init(&m_local.device, resolved, shaders, layout, m_local.pipelineCache.Get());
+        std::chrono::duration<double, std::milli> creationTime = std::chrono::high_resolution_clock::now() - start;
+        m_local.pipelineCache.RecordCreation(creationTime.count());
 
-            VkDescriptorSetLayoutCreateInfo layoutInfo{};
-            layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-            layoutInfo.bindingCount = static_cast<uint32_t>(vkBindings.size());
-            layoutInfo.pBindings = vkBindings.data();
+        return p;
+    }
 
-            setLayouts.push_back(m_local.descLayoutCache.CreateDescriptorLayout(layoutInfo));
+    template<>
+    inline PipelineHandle RenderHardwareInterface<RHI::Vulkan>::RequestPipeline(const PipelineDescriptor &desc,
+        const std::vector<ShaderStageDesc> &shaders)
+    {
+        //! The layout caches are not thread safe, so layouts are resolved here and not on the compile workers.
+        //! Resolving first also puts the reflected state into the registry key
+        PipelineDescriptor resolved = desc;
+        VkPipelineLayout layout = m_local.pipelineLayoutCache.Resolve(shaders, &resolved);
+        if (layout == VK_NULL_HANDLE) {
+            Log(Error, "Failed to resolve the pipeline layout!");
+            return {};
         }
 
-        p.Init(&m_local.device, desc, shaders, setLayouts);
+        return m_local.pipelineRegistry.Request(resolved, shaders, layout);
+    }
 
-        return p;
+    template<>
+    inline Shader RenderHardwareInterface<RHI::Vulkan>::CreateShader(const ShaderDescriptor &desc) {
+        Shader s;
+
+        auto code = Util::ReadFile(desc.path);
+        s.VK_Init(&m_local.device, desc, code);
+        if (s.IsValid() && !m_local.pipelineLayoutCache.RegisterShader(s.GetHash(), desc.type, code)) {
+            Log(Warning, "Failed to reflect shader {}, its pipelines need explicit layouts", desc.path);
+        }
+
+        return s;
+    }
+
+    template<>
+    inline BindlessHandle RenderHardwareInterface<RHI::Vulkan>::AddBindlessBuffer(const Buffer &buffer, uint64_t offset, uint64_t size) {
+        return m_local.bindlessHeap.AddBuffer(buffer, offset, (size == 0) ? VK_WHOLE_SIZE : size);
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::BindGraphicsPipeline(const CommandBuffer &cmd, const Pipeline &pipeline) const {
+        cmd.BindGraphicsPipeline(pipeline);
+
+        //! Pipeline switches are rare next to draws, so the heap simply rides along with every one that uses it
+        if (pipeline.UsesBindless()) {
+            VkDescriptorSet heapSet = m_local.bindlessHeap.VK_GetSet();
+            cmd.VK_BindDescriptorSets({&heapSet, 1}, {}, pipeline.VK_GetLayout(), VK_PIPELINE_BIND_POINT_GRAPHICS, Conf::SHIFT_BINDLESS_SET);
+        }
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::BindComputePipeline(const Pipeline &pipeline) const {
+        BindComputePipeline(m_cmdBuffersFlight[m_currentFrame], pipeline);
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::BindComputePipeline(const CommandBuffer &cmd, const Pipeline &pipeline) const {
+        cmd.BindComputePipeline(pipeline);
+
+        //! Compute has bind points of its own, the heap bound for graphics doesn't carry over
+        if (pipeline.UsesBindless()) {
+            VkDescriptorSet heapSet = m_local.bindlessHeap.VK_GetSet();
+            cmd.VK_BindDescriptorSets({&heapSet, 1}, {}, pipeline.VK_GetLayout(), VK_PIPELINE_BIND_POINT_COMPUTE, Conf::SHIFT_BINDLESS_SET);
+        }
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::BindResourceSets(const CommandBuffer &cmd, const Pipeline &pipeline, std::span<const ResourceSet* const> sets, uint32_t firstSet, std::span<const uint32_t> dynamicOffsets) const {
+        //! Nothing is laid out past the bindless set, so a fixed array fits any bind
+        std::array<VkDescriptorSet, Conf::SHIFT_BINDLESS_SET + 1> vkSets{};
+        assert(sets.size() <= vkSets.size());
+        for (size_t i = 0; i < sets.size(); ++i) {
+            vkSets[i] = sets[i]->VK_Get();
+        }
+
+        cmd.VK_BindDescriptorSets({vkSets.data(), sets.size()}, dynamicOffsets, pipeline.VK_GetLayout(), pipeline.VK_GetBindPoint(), firstSet);
     }
 
     template<>
     inline ResourceSet RenderHardwareInterface<RHI::Vulkan>::CreateResourceSet(const PipelineLayoutDescriptor &desc) {
         ResourceSet rs;
 
-        //! TODO [CLEANUP] create a shared function for set pulling of set layout between this and pipeline creation
-        std::vector<VkDescriptorSetLayoutBinding> vkBindings;
-        vkBindings.reserve(desc.bindings.size());
+        VkDescriptorSetLayout layout = m_local.descLayoutCache.CreateDescriptorLayout(desc);
+        rs.Init(&m_local.device, m_local.descAllocator.Allocate(layout), m_local.descLayoutCache.GetUpdateTemplate(layout));
 
-        for (const auto& b : desc.bindings) {
-            VkDescriptorSetLayoutBinding binding{};
-            binding.binding = b.binding;
-            binding.descriptorCount = b.count;
-            binding.stageFlags = VK::Util::ShiftToVKBindingVisibility(b.stageFlags);
-            binding.descriptorType = VK::Util::ShiftToVKBindingType(b.type);
-            binding.pImmutableSamplers = nullptr; // handle immutable samplers if needed
-            vkBindings.push_back(binding);
-        }
+        return rs;
+    }
 
-        VkDescriptorSetLayoutCreateInfo layoutInfo{};
-        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        layoutInfo.bindingCount = static_cast<uint32_t>(vkBindings.size());
-        layoutInfo.pBindings = vkBindings.data();
+    template<>
+    inline ResourceSet RenderHardwareInterface<RHI::Vulkan>::CreateTransientResourceSet(const PipelineLayoutDescriptor &desc) {
+        ResourceSet rs;
 
-        rs.Init(&m_local.device, m_local.descAllocator.Allocate(m_local.descLayoutCache.CreateDescriptorLayout(layoutInfo)));
+        VkDescriptorSetLayout layout = m_local.descLayoutCache.CreateDescriptorLayout(desc);
+        rs.Init(&m_local.device, m_local.frameDescAllocator.Allocate(layout), m_local.descLayoutCache.GetUpdateTemplate(layout));
 
         return rs;
     }
 
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::ApplyResourceSets(std::span<ResourceSet* const> sets) {
+        for (ResourceSet* set: sets) {
+            set->VK_Apply(&m_local.descWriteBatcher);
+        }
+        m_local.descWriteBatcher.Flush();
+    }
+
 
     template<>
     inline void RenderHardwareInterface<RHI::Vulkan>::BeginRenderPass(const RenderPassDescriptor& desc, std::span<Texture*> colorTextures, std::optional<Texture*> depthTexture) {
@@ -485,6 +1650,9 @@ namespace Shift {
         assert(desc.colorAttachments.size() == colorTextures.size());
         assert(desc.depthAttachment.has_value() == depthTexture.has_value());
 
+        //! Attachment transitions have to land before rendering begins
+        m_local.stateTracker.Flush();
+
         std::vector<VkRenderingAttachmentInfo> colorInfo;
         std::optional<VkRenderingAttachmentInfo> depthInfo;
         for (uint32_t i = 0; i < desc.colorAttachments.size(); i++) {
@@ -492,7 +1660,7 @@ namespace Shift {
             const RenderPassDescriptor::RenderPassAttachmentInfo& att = desc.colorAttachments[i];
             colorInfo.push_back(VK::Util::CreateRenderingAttachmentInfo(
                     colTex->GetView(),
-                    VK::Util::ShiftToVKResourceLayout(colTex->GetResourceLayout()),
+                    m_local.stateTracker.GetLayout(*colTex),
                     VK::Util::ShiftToVKClearColor(att.clearValue),
                     VK::Util::ShiftToVKAttachmentLoadOperation(att.loadOperation),
                     VK::Util::ShiftToVKAttachmentStoreOperation(att.storeOperation)
@@ -502,9 +1670,9 @@ namespace Shift {
 
         if (desc.depthAttachment.has_value()) {
             const RenderPassDescriptor::RenderPassAttachmentInfo& att = desc.depthAttachment.value();
-            *depthInfo = VK::Util::CreateRenderingAttachmentInfo(
+            depthInfo = VK::Util::CreateRenderingAttachmentInfo(
                     (*depthTexture)->GetView(),
-                    VK::Util::ShiftToVKResourceLayout((*depthTexture)->GetResourceLayout()),
+                    m_local.stateTracker.GetLayout(**depthTexture),
                     VK::Util::ShiftToVKClearDepthStencil(att.clearValue),
                     VK::Util::ShiftToVKAttachmentLoadOperation(att.loadOperation),
                     VK::Util::ShiftToVKAttachmentStoreOperation(att.storeOperation)
@@ -515,11 +1683,15 @@ namespace Shift {
         renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
         renderInfo.renderArea = {.offset = VK::Util::ShiftToVKOffset2D(desc.offset), .extent = VK::Util::ShiftToVKExtent2D(desc.extent)};
         renderInfo.layerCount = 1;
-        renderInfo.colorAttachmentCount = 1;
-        renderInfo.pColorAttachments = colorInfo.data();
+        //! Every color target of an MRT pass, none for depth only passes
+        renderInfo.colorAttachmentCount = static_cast<uint32_t>(colorInfo.size());
+        renderInfo.pColorAttachments = (colorInfo.empty()) ? nullptr : colorInfo.data();
         if (depthInfo.has_value()) {
             renderInfo.pDepthAttachment = &depthInfo.value();
         }
+        if (desc.secondaryContents) {
+            renderInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR;
+        }
 
         m_cmdBuffersFlight[m_currentFrame].VK_BeginRenderPass(renderInfo);
     }
@@ -529,6 +1701,8 @@ namespace Shift {
 
         assert(desc.depthAttachment.has_value() == depthTexture.has_value());
 
+        m_local.stateTracker.Flush();
+
         std::vector<VkRenderingAttachmentInfo> colorInfo;
         std::optional<VkRenderingAttachmentInfo> depthInfo;
         const RenderPassDescriptor::RenderPassAttachmentInfo& att = desc.colorAttachments[0];
@@ -543,9 +1717,9 @@ namespace Shift {
 
         if (desc.depthAttachment.has_value()) {
             const RenderPassDescriptor::RenderPassAttachmentInfo& att = desc.depthAttachment.value();
-            *depthInfo = VK::Util::CreateRenderingAttachmentInfo(
+            depthInfo = VK::Util::CreateRenderingAttachmentInfo(
                     (*depthTexture)->GetView(),
-                    VK::Util::ShiftToVKResourceLayout((*depthTexture)->GetResourceLayout()),
+                    m_local.stateTracker.GetLayout(**depthTexture),
                     VK::Util::ShiftToVKClearDepthStencil(att.clearValue),
                     VK::Util::ShiftToVKAttachmentLoadOperation(att.loadOperation),
                     VK::Util::ShiftToVKAttachmentStoreOperation(att.storeOperation)
@@ -561,58 +1735,284 @@ namespace Shift {
         if (depthInfo.has_value()) {
             renderInfo.pDepthAttachment = &depthInfo.value();
         }
+        if (desc.secondaryContents) {
+            renderInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR;
+        }
 
         m_cmdBuffersFlight[m_currentFrame].VK_BeginRenderPass(renderInfo);
 
     }
 
+    template<>
+    inline CommandBuffer* RenderHardwareInterface<RHI::Vulkan>::BeginSecondaryCmds(uint32_t workerIdx,
+        std::span<const ETextureFormat> colorFormats, std::optional<ETextureFormat> depthFormat)
+    {
+        std::vector<VkFormat> vkColorFormats;
+        vkColorFormats.reserve(colorFormats.size());
+        for (ETextureFormat format: colorFormats) {
+            vkColorFormats.push_back(VK::Util::ShiftToVKTextureFormat(format));
+        }
+
+        VkCommandBufferInheritanceRenderingInfoKHR renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(vkColorFormats.size());
+        renderingInfo.pColorAttachmentFormats = vkColorFormats.data();
+        renderingInfo.depthAttachmentFormat = (depthFormat.has_value()) ? VK::Util::ShiftToVKTextureFormat(*depthFormat): VK_FORMAT_UNDEFINED;
+        renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+        renderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        return m_local.parallelRecorder.BeginSecondary(workerIdx, renderingInfo);
+    }
+
 
     //! Big TODO for now: This only works for the graphics queue
     template<>
     inline void RenderHardwareInterface<RHI::Vulkan>::TransitionTexture(const Texture &texture, EResourceLayout newLayout,
-        EPipelineStageFlags newStageFlags)
+        EPipelineStageFlags newStageFlags, std::optional<TextureSubresourceRange> range)
     {
-
         VkImageSubresourceRange subresourceRange{};
         subresourceRange.aspectMask = VK::Util::ShiftToVKTextureAspect(texture.GetAspect());
         subresourceRange.baseMipLevel = 0;
-        subresourceRange.levelCount = 1;
+        subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
         subresourceRange.baseArrayLayer = 0;
-        subresourceRange.layerCount = 1;
+        subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        if (range.has_value()) {
+            subresourceRange.baseMipLevel = range->baseMipLevel;
+            subresourceRange.levelCount = range->levelCount;
+            subresourceRange.baseArrayLayer = range->baseArrayLayer;
+            subresourceRange.layerCount = range->layerCount;
+        }
 
-        m_cmdBuffersFlight[m_currentFrame].VK_TransferImageLayout(
-            texture.GetImage(),
-            VK::Util::ShiftToVKResourceLayout(texture.GetResourceLayout()),
+        m_local.stateTracker.TransitionTexture(
+            texture,
+            subresourceRange,
             VK::Util::ShiftToVKResourceLayout(newLayout),
-            texture.VK_GetStageFlags(),
-            VK::Util::ShiftToVKPipelineStageFlags(newStageFlags)
+            VK::Util::ShiftToVKPipelineStageFlags2(newStageFlags)
         );
-
-        texture.SetResourceLayout(newLayout);
-        texture.VK_SetStageFlags(VK::Util::ShiftToVKPipelineStageFlags(newStageFlags));
     }
 
     template<>
     inline void RenderHardwareInterface<RHI::Vulkan>::TransitionSwapchainTexture(uint32_t imageIdx, EResourceLayout newLayout,
         EPipelineStageFlags newStageFlags)
     {
-        VkImageSubresourceRange subresourceRange{};
-        subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        subresourceRange.baseMipLevel = 0;
-        subresourceRange.levelCount = 1;
-        subresourceRange.baseArrayLayer = 0;
-        subresourceRange.layerCount = 1;
+        VkImageLayout& layout = m_local.swapchain.GetImageLayouts()[imageIdx];
+        VkPipelineStageFlags& stageFlags = m_local.swapchain.GetImageStageFlags()[imageIdx];
+
+        //! The image available semaphore is waited for at the color output stage, the transition has to chain from it
+        if (layout == VK_IMAGE_LAYOUT_UNDEFINED || layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR) {
+            stageFlags = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        }
 
-        m_cmdBuffersFlight[m_currentFrame].VK_TransferImageLayout(
+        m_local.stateTracker.TransitionExternalImage(
             m_local.swapchain.GetImages()[imageIdx],
-            m_local.swapchain.GetImageLayouts()[imageIdx],
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            &layout,
+            &stageFlags,
             VK::Util::ShiftToVKResourceLayout(newLayout),
-            m_local.swapchain.GetImageStageFlags()[imageIdx],
-            VK::Util::ShiftToVKPipelineStageFlags(newStageFlags)
+            VK::Util::ShiftToVKPipelineStageFlags2(newStageFlags)
         );
+    }
 
-        m_local.swapchain.GetImageLayouts()[imageIdx] = VK::Util::ShiftToVKResourceLayout(newLayout);
-        m_local.swapchain.GetImageStageFlags()[imageIdx] = VK::Util::ShiftToVKPipelineStageFlags(newStageFlags);
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::TransitionBuffer(const Buffer &buffer, EBufferAccess access,
+        EPipelineStageFlags newStageFlags)
+    {
+        m_local.stateTracker.TransitionBuffer(
+            buffer,
+            VK::Util::ShiftToVKBufferAccess(access),
+            VK::Util::ShiftToVKPipelineStageFlags2(newStageFlags)
+        );
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::DiscardTexture(const Texture &texture, std::span<const Texture* const> aliased) {
+        m_local.stateTracker.Discard(texture, aliased);
+    }
+
+    template<>
+    inline ReadbackToken RenderHardwareInterface<RHI::Vulkan>::ReadbackTexture(const TextureCopyDescriptor &srcTex, ReadbackCallback callback) {
+        VkImageSubresourceRange range = VK::Util::ShiftToVKSubresourceRange(srcTex.subresourceRange);
+        range.aspectMask = VK::Util::ShiftToVKTextureAspect(srcTex.texture->GetAspect());
+        range.levelCount = 1;
+        m_local.stateTracker.TransitionTexture(*srcTex.texture, range, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+        //! Once per frame, the copies of one frame write different ranges of the ring
+        if (!m_local.readbackRing.HasFrameCopies()) {
+            m_local.stateTracker.TransitionBuffer(m_local.readbackRing.GetBuffer(), VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+        }
+        m_local.stateTracker.Flush();
+
+        return m_local.readbackRing.Record(m_cmdBuffersFlight[m_currentFrame], srcTex, m_frameNumber, std::move(callback));
+    }
+
+    template<>
+    inline TextureMemoryRequirements RenderHardwareInterface<RHI::Vulkan>::GetTextureMemoryRequirements(const TextureDescriptor &desc) const {
+        return VK::Texture::VK_GetMemoryRequirements(&m_local.device, desc);
+    }
+
+    template<>
+    inline bool RenderHardwareInterface<RHI::Vulkan>::CanReplaceTextures() const {
+        //! Async uploads write the old images and acquire them behind the frame's back, replacing waits them out
+        return m_transferWaitValue == 0 && m_local.asyncTransfer.GetLastValue() <= m_local.asyncTransfer.GetTimeline().GetValue();
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::ReplaceTextures(std::span<TextureReplacement> replacements) {
+        //! Layout of every subresource of the old textures that goes into the replacements, layer major
+        std::vector<std::vector<VkImageLayout>> layouts(replacements.size());
+        for (size_t i = 0; i < replacements.size(); ++i) {
+            const TextureReplacement& replacement = replacements[i];
+            const Texture& texture = *m_texturePool.Get(replacement.handle);
+            for (uint32_t layer = 0; layer < std::max(replacement.texture.GetLevels(), 1u); ++layer) {
+                for (uint32_t mip = 0; mip < std::max(replacement.texture.GetMipCount(), 1u); ++mip) {
+                    layouts[i].push_back(m_local.stateTracker.GetLayout(texture, replacement.srcBaseMip + mip, layer));
+                }
+            }
+
+            VkImageSubresourceRange range{VK::Util::ShiftToVKTextureAspect(texture.GetAspect()), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+            m_local.stateTracker.TransitionTexture(texture, range, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+            m_local.stateTracker.TransitionTexture(replacement.texture, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+        }
+        m_local.stateTracker.Flush();
+
+        const CommandBuffer& cmd = m_cmdBuffersFlight[m_currentFrame];
+        for (const TextureReplacement& replacement: replacements) {
+            const Texture& texture = *m_texturePool.Get(replacement.handle);
+            const Texture& dst = replacement.texture;
+            cmd.VK_CopyImage(texture.GetImage(), dst.GetImage(), VK::Util::ShiftToVKTextureAspect(texture.GetAspect()),
+                {dst.GetWidth(), dst.GetHeight(), dst.GetDepth()}, std::max(dst.GetMipCount(), 1u), std::max(dst.GetLevels(), 1u), replacement.srcBaseMip);
+        }
+
+        for (size_t i = 0; i < replacements.size(); ++i) {
+            TextureReplacement& replacement = replacements[i];
+            Texture& texture = *m_texturePool.Get(replacement.handle);
+            VkImageAspectFlags aspect = VK::Util::ShiftToVKTextureAspect(texture.GetAspect());
+            uint32_t mipCount = std::max(replacement.texture.GetMipCount(), 1u);
+
+            //! Back to the layouts of the old texture, who uses it next is unknown so the scope is all commands.
+            //! Subresources that were never written stay in the copy layout
+            const std::vector<VkImageLayout>& oldLayouts = layouts[i];
+            bool isUniform = std::ranges::all_of(oldLayouts, [&](VkImageLayout layout) { return layout == oldLayouts.front(); });
+            for (uint32_t j = 0; j < oldLayouts.size(); ++j) {
+                if (oldLayouts[j] == VK_IMAGE_LAYOUT_UNDEFINED) { continue; }
+
+                VkImageSubresourceRange range = isUniform ?
+                    VkImageSubresourceRange{aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS} :
+                    VkImageSubresourceRange{aspect, j % mipCount, 1, j / mipCount, 1};
+                m_local.stateTracker.TransitionTexture(replacement.texture, range, oldLayouts[j], VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+                if (isUniform) { break; }
+            }
+
+            //! The old texture's state goes now like on a destroy, the caller decides when its image goes
+            m_local.stateTracker.Forget(texture);
+            std::swap(texture, replacement.texture);
+            m_local.bindlessHeap.MoveOwnedTexture(replacement.handle, texture, &m_bindlessMoves);
+        }
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::RecordTextureMoves() {
+        VK::TextureAllocator& allocator = m_local.textureAllocator;
+        if (!allocator.IsDefragmenting() || allocator.IsPassOpen() || !CanReplaceTextures()) { return; }
+
+        std::span<VmaDefragmentationMove> moves = allocator.BeginPass();
+        if (moves.empty()) { return; }
+        m_textureMoveFrame = m_frameNumber;
+
+        std::vector<TextureReplacement> replacements;
+        replacements.reserve(moves.size());
+        uint32_t freeSlots = m_local.bindlessHeap.GetFreeTextureCount();
+        for (VmaDefragmentationMove& move: moves) {
+            //! Raw textures have no live owner and stay where they are, so do the ones waiting in the deletion queue
+            TextureHandle handle = allocator.GetOwner(move.srcAllocation);
+            const Texture* texture = (m_texturePool.IsAlive(handle) && !allocator.IsPendingDestroy(move.srcAllocation)) ? m_texturePool.Get(handle) : nullptr;
+            //! Neither do textures whose bindless slots have nowhere to move to
+            uint32_t slots = (texture != nullptr) ? m_local.bindlessHeap.GetOwnedTextureCount(handle) : 0;
+            Texture moved = (texture != nullptr && slots <= freeSlots) ? texture->VK_CreateMoved(move.dstTmpAllocation) : Texture{};
+            if (!moved.IsValid()) {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+            freeSlots -= slots;
+            replacements.push_back({.handle = handle, .texture = moved});
+        }
+
+        ReplaceTextures(replacements);
+        //! The old images keep their memory until the pass ends
+        for (const TextureReplacement& replacement: replacements) {
+            m_textureMoves.push_back({.handle = replacement.handle, .old = replacement.texture});
+        }
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::DemoteTextures() {
+        if (m_local.memoryBudget.GetPressure() == EMemoryPressure::None || m_frameNumber < m_nextDemotionFrame) { return; }
+        if (m_local.textureAllocator.IsPassOpen() || !CanReplaceTextures()) { return; }
+
+        //! Only sampled textures with mips to spare, render targets and storage images need their full size
+        constexpr ETextureUsageFlags fixedSizeUsage = ETextureUsageFlags::ColorAttachment | ETextureUsageFlags::DepthStencilAttachment | ETextureUsageFlags::Storage;
+        std::vector<const Texture*> candidates;
+        for (const Texture& texture: m_texturePool.GetObjects()) {
+            bool isDemotable = (texture.GetUsageFlags() & fixedSizeUsage) == ETextureUsageFlags::None && texture.GetMipCount() > 1 &&
+                texture.GetDepth() == 1 && std::min(texture.GetWidth(), texture.GetHeight()) / 2 >= Conf::SHIFT_MEMORY_DEMOTION_MIN_SIZE;
+            if (isDemotable) {
+                candidates.push_back(&texture);
+            }
+        }
+        //! Biggest first, they give back the most per copy
+        std::ranges::sort(candidates, std::greater{}, [](const Texture* texture) { return texture->GetAllocInfo().size; });
+
+        uint64_t excess = m_local.memoryBudget.GetExcess();
+        uint64_t freed = 0;
+        std::vector<TextureReplacement> replacements;
+        uint32_t freeSlots = m_local.bindlessHeap.GetFreeTextureCount();
+        for (const Texture* texture: candidates) {
+            if (replacements.size() == Conf::SHIFT_MEMORY_DEMOTIONS_PER_ROUND || freed >= excess) { break; }
+            TextureHandle handle = m_texturePool.GetHandle(*texture);
+            uint32_t slots = m_local.bindlessHeap.GetOwnedTextureCount(handle);
+            if (slots > freeSlots) { continue; }
+
+            TextureDescriptor desc = texture->GetDescriptor();
+            desc.width /= 2;
+            desc.height /= 2;
+            desc.mips -= 1;
+            desc.resourceLayout = EResourceLayout::Undefined;
+
+            Texture demoted = CreateTexture(desc);
+            if (!demoted.IsValid()) { continue; }
+
+            freeSlots -= slots;
+            freed += texture->GetAllocInfo().size - std::min(texture->GetAllocInfo().size, demoted.GetAllocInfo().size);
+            replacements.push_back({.handle = handle, .texture = demoted, .srcBaseMip = 1});
+        }
+
+        //! What was dropped only comes back once the frames in flight let go of it, the next round waits for that
+        m_nextDemotionFrame = m_frameNumber + Conf::SHIFT_MAX_FRAMES_IN_FLIGHT + 1;
+        if (replacements.empty()) { return; }
+
+        ReplaceTextures(replacements);
+        for (TextureReplacement& replacement: replacements) {
+            m_local.textureAllocator.SetOwner(m_texturePool.Get(replacement.handle)->GetAlloc(), replacement.handle);
+            DestroyTexture(replacement.texture);
+        }
+        Log(Info, "Dropped the top mip of {} textures under memory pressure, about {} MiB", replacements.size(), freed >> 20);
+    }
+
+    template<>
+    inline void RenderHardwareInterface<RHI::Vulkan>::RetireTextureMoves(uint64_t completedFrame) {
+        if (!m_local.textureAllocator.IsPassOpen() || completedFrame < m_textureMoveFrame) { return; }
+
+        for (TextureMove& move: m_textureMoves) {
+            move.old.VK_DestroyImage();
+        }
+        m_local.textureAllocator.EndPass();
+
+        //! VMA swapped the new memory in behind the allocations, the cached infos still describe the old one
+        for (const TextureMove& move: m_textureMoves) {
+            if (m_texturePool.IsAlive(move.handle)) {
+                m_texturePool.Get(move.handle)->VK_RefreshAllocationInfo();
+            }
+        }
+        m_textureMoves.clear();
     }
 } // Shift
 
@@ -11,7 +11,26 @@
 #include "Graphics/RHI/Vulkan/VKSwapchain.hpp"
 #include "Graphics/RHI/Vulkan/Assistants/CommandPoolStorage.hpp"
 #include "Graphics/RHI/Vulkan/Assistants/DescriptorLayoutCache.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/PipelineLayoutCache.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/BindlessHeap.hpp"
 #include "Graphics/RHI/Vulkan/Assistants/DescriptorAllocator.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/FrameDescriptorAllocator.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/DescriptorUpdate.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/UniformRing.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/UploadManager.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/ReadbackRing.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/AsyncTransferQueue.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/AsyncComputeQueue.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/ParallelRecorder.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/PipelineCache.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/PipelineRegistry.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/ResourceStateTracker.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/GpuProfiler.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/PassQueries.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/DeletionQueue.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/GeometryArena.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/TextureAllocator.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/MemoryBudget.hpp"
 
 namespace Shift {
     //! Note, this should be included only after both RHI Data and RHI::VUlkan have been defined
@@ -22,8 +41,29 @@ namespace Shift {
         VK::Swapchain swapchain{};
 
         VK::DescriptorAllocator descAllocator;
+        VK::FrameDescriptorAllocator frameDescAllocator;
+        VK::DescriptorWriteBatcher descWriteBatcher;
+        VK::UniformRing uniformRing;
         VK::DescriptorLayoutCache descLayoutCache;
+        VK::PipelineLayoutCache pipelineLayoutCache;
+        VK::BindlessHeap bindlessHeap;
         VK::CommandPoolStorage cmdPoolStorage;
+        VK::UploadManager uploadManager;
+        VK::ReadbackRing readbackRing;
+        VK::AsyncTransferQueue asyncTransfer;
+        VK::AsyncComputeQueue asyncCompute;
+        //! Signaled with the frame number by every frame submission, async compute waits on it
+        VK::TimelineSemaphore frameTimeline;
+        VK::ParallelRecorder parallelRecorder;
+        VK::PipelineCache pipelineCache;
+        VK::PipelineRegistry pipelineRegistry;
+        VK::ResourceStateTracker stateTracker;
+        VK::GpuProfiler gpuProfiler;
+        VK::PassQueries passQueries;
+        VK::DeletionQueue deletionQueue;
+        VK::GeometryArena geometryArena;
+        VK::TextureAllocator textureAllocator;
+        VK::MemoryBudget memoryBudget;
     };
 } // Shift
 
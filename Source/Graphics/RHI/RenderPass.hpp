@@ -69,6 +69,9 @@ namespace Shift {
 
         std::vector<RenderPassAttachmentInfo> colorAttachments;
         std::optional<RenderPassAttachmentInfo> depthAttachment;
+
+        //! The pass content comes from worker recorded secondary buffers, nothing can be recorded inline then
+        bool secondaryContents = false;
     };
 
     //! RenderPass interface is largely free and up for implementation as different APIs have different implementation
@@ -13,6 +13,38 @@
 #include "Pipeline.hpp"
 
 namespace Shift {
+    //! The arrays of the bindless heap
+    enum class EBindlessType : uint8_t {
+        Texture,
+        Sampler,
+        Buffer
+    };
+
+    //! Slot of a resource in the bindless heap, shaders index the heap array of its type with index
+    struct BindlessHandle {
+        uint32_t index = UINT32_MAX;
+        EBindlessType type = EBindlessType::Texture;
+
+        [[nodiscard]] bool IsValid() const { return index != UINT32_MAX; }
+    };
+
+    //! A texture slot that followed its handle texture to a new slot, the old one is retired
+    struct BindlessMove {
+        BindlessHandle from;
+        BindlessHandle to;
+    };
+
+    //! Transient (current frame only) resource set allocation numbers of the last finished frame
+    struct TransientSetStats {
+        uint32_t setsAllocated = 0;
+        //! Pools the frame went through, more than 1 means the frame pool gets regrown
+        uint32_t poolsUsed = 0;
+        //! Sets the frame pool fits at once
+        uint32_t poolCapacity = 0;
+        //! How many times a frame pool was regrown since init
+        uint32_t regrowCount = 0;
+    };
+
     //! Resource Set (Descriptor set interface).
     //! Currently supports only very basic binds
     //! \tparam Set
@@ -161,6 +161,14 @@ namespace Shift {
         }
     };
 
+    //! What a texture needs from the memory it's placed into
+    struct TextureMemoryRequirements {
+        uint64_t size = 0;
+        uint64_t alignment = 1;
+        //! Memory types the texture can live in, a bit per type
+        uint32_t memoryTypeBits = 0;
+    };
+
     //! A concept that acts as an interface for all Graphics API Buffer classes.
     //! Yes, this could just be a base non-virtual class but such approach can be only followed with the Texture in
     //! Shift RHI design so I aint mixing styles:D
@@ -20,6 +20,7 @@ namespace Shift {
         class RenderPass;
         class CommandBuffer;
         class Device;
+        class MemoryBlock;
     } // VK
 
     //! This is what is exported as an interface
@@ -35,6 +36,7 @@ namespace Shift {
     using RenderPass = VK::RenderPass;
     using CommandBuffer = VK::CommandBuffer;
     using Device = VK::Device;
+    using MemoryBlock = VK::MemoryBlock;
 #endif
 
 } // Shift
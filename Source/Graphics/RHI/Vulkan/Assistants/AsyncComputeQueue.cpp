@@ -0,0 +1,133 @@
+#include "AsyncComputeQueue.hpp"
+
+namespace Shift::VK {
+    bool AsyncComputeQueue::Init(const Device *device, const Instance *ins, VkCommandPool computePool) {
+        m_device = device;
+        m_instance = ins;
+        m_pool = computePool;
+
+        if (!m_timeline.Init(m_device, 0)) {
+            Log(Error, "Failed to create the async compute timeline semaphore!");
+            return false;
+        }
+
+        if (!m_device->HasAsyncCompute()) {
+            Log(Info, "No separate compute queue family, async compute runs on the graphics queue");
+        }
+        return true;
+    }
+
+    const CommandBuffer* AsyncComputeQueue::Begin() {
+        if (m_isRecording) { return &m_recording.cmd; }
+
+        PollCompleted();
+
+        CommandBuffer cmd;
+        if (!m_freeCmds.empty()) {
+            cmd = m_freeCmds.back();
+            m_freeCmds.pop_back();
+        } else if (!cmd.Init(m_device, m_instance, m_pool, EPoolQueueType::Compute)) {
+            Log(Error, "Failed to create an async compute command buffer!");
+            return nullptr;
+        }
+
+        cmd.Reset();
+        if (!cmd.Begin()) {
+            m_freeCmds.push_back(cmd);
+            return nullptr;
+        }
+
+        m_recording.cmd = cmd;
+        m_recording.value = m_nextValue;
+        m_isRecording = true;
+
+        return &m_recording.cmd;
+    }
+
+    void AsyncComputeQueue::Barrier() {
+        if (!m_isRecording) { return; }
+
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        m_recording.cmd.VK_SetPipelineBarrier(
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            {},
+            {&barrier, 1},
+            {},
+            0
+        );
+    }
+
+    ComputeToken AsyncComputeQueue::Submit(const TimelineSemaphore &graphicsTimeline, uint64_t graphicsWaitValue) {
+        if (!m_isRecording) { return {}; }
+
+        m_isRecording = false;
+        if (!m_recording.cmd.End()) {
+            m_freeCmds.push_back(m_recording.cmd);
+            return {};
+        }
+
+        //! The wait is at the top, a batch usually reads what an earlier frame wrote or overwrites what it read
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        bool waits = graphicsWaitValue != 0;
+        uint64_t value = m_recording.value;
+        bool res = m_recording.cmd.VK_Submit(
+            (waits) ? std::span<const VkSemaphore>{graphicsTimeline.Ptr(), 1} : std::span<const VkSemaphore>{},
+            (waits) ? std::span<const VkPipelineStageFlags>{&waitStage, 1} : std::span<const VkPipelineStageFlags>{},
+            (waits) ? std::span<const uint64_t>{&graphicsWaitValue, 1} : std::span<const uint64_t>{},
+            {m_timeline.Ptr(), 1},
+            {&value, 1}
+        );
+        if (!res) {
+            Log(Error, "Failed to submit an async compute batch!");
+            m_freeCmds.push_back(m_recording.cmd);
+            m_recording = Batch{};
+            return {};
+        }
+
+        m_submitted.push_back(m_recording);
+        m_recording = Batch{};
+        ++m_nextValue;
+
+        return {value};
+    }
+
+    void AsyncComputeQueue::Wait(ComputeToken token) const {
+        if (!token.IsValid() || IsDone(token)) { return; }
+
+        m_timeline.Wait(token.value);
+    }
+
+    void AsyncComputeQueue::PollCompleted() {
+        uint64_t completed = m_timeline.GetValue();
+        while (!m_submitted.empty() && m_submitted.front().value <= completed) {
+            m_freeCmds.push_back(m_submitted.front().cmd);
+            m_submitted.pop_front();
+        }
+    }
+
+    void AsyncComputeQueue::Destroy() {
+        if (m_nextValue > 1) {
+            m_timeline.Wait(m_nextValue - 1);
+        }
+
+        for (auto& batch: m_submitted) {
+            batch.cmd.Destroy();
+        }
+        m_submitted.clear();
+
+        if (m_isRecording) {
+            m_recording.cmd.Destroy();
+            m_isRecording = false;
+        }
+        for (auto& cmd: m_freeCmds) {
+            cmd.Destroy();
+        }
+        m_freeCmds.clear();
+
+        m_timeline.Destroy();
+    }
+} // Shift::VK
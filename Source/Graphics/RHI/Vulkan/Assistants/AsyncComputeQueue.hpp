@@ -0,0 +1,80 @@
+#ifndef SHIFT_ASYNCCOMPUTEQUEUE_HPP
+#define SHIFT_ASYNCCOMPUTEQUEUE_HPP
+
+#include <deque>
+#include <vector>
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKSemaphore.hpp"
+#include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
+
+namespace Shift::VK {
+    //! Records and submits compute work on the compute queue, so it runs next to the graphics queue.
+    //! Every submitted batch signals a timeline semaphore value, that value is the ComputeToken handed out to the caller.
+    //! A batch can wait for a value of the graphics frame timeline, and a frame can wait for a token, the two queues
+    //! are ordered through those semaphores only. The resources both queues touch (storage and indirect buffers, storage
+    //! images) are created with concurrent sharing, so there are no ownership transfers. Without a separate compute
+    //! family the batches go to the graphics queue, everything works the same but nothing overlaps.
+    class AsyncComputeQueue {
+    public:
+        //! Initialize the async compute queue
+        //! \param device Device wrapper ptr
+        //! \param ins Instance wrapper ptr
+        //! \param computePool The command pool of the compute family
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, const Instance* ins, VkCommandPool computePool);
+
+        //! Get the command buffer of the current batch, a batch starts if none is recording
+        //! \return nullptr if failed
+        [[nodiscard]] const CommandBuffer* Begin();
+
+        //! Make every shader write recorded so far in the batch visible to the commands after, dispatches and indirect reads
+        void Barrier();
+
+        //! Submit the current batch, never blocks
+        //! \param graphicsTimeline the frame timeline of the graphics queue
+        //! \param graphicsWaitValue graphics timeline value the batch waits for before it starts, 0 for none
+        //! \return The token of the batch, invalid if nothing was recording or the submission failed
+        ComputeToken Submit(const TimelineSemaphore& graphicsTimeline, uint64_t graphicsWaitValue);
+
+        //! Whether the batch of the token is done on the GPU, never blocks
+        [[nodiscard]] bool IsDone(ComputeToken token) const { return token.value <= m_timeline.GetValue(); }
+
+        //! Block until the batch of the token is done on the GPU
+        void Wait(ComputeToken token) const;
+
+        [[nodiscard]] bool IsRecording() const { return m_isRecording; }
+
+        //! Timeline value of the latest batch that may use a resource, recording or submitted, 0 if none
+        [[nodiscard]] uint64_t GetLastValue() const { return (m_isRecording) ? m_nextValue : m_nextValue - 1; }
+
+        [[nodiscard]] const TimelineSemaphore& GetTimeline() const { return m_timeline; }
+
+        void Destroy();
+        ~AsyncComputeQueue() = default;
+    private:
+        struct Batch {
+            CommandBuffer cmd;
+            uint64_t value = 0;
+        };
+
+        //! Hand the command buffers of finished batches back, does not block
+        void PollCompleted();
+
+        const Device* m_device = nullptr;
+        const Instance* m_instance = nullptr;
+        VkCommandPool m_pool = VK_NULL_HANDLE;
+
+        TimelineSemaphore m_timeline;
+        //! The value the recording batch is going to signal
+        uint64_t m_nextValue = 1;
+
+        bool m_isRecording = false;
+        Batch m_recording;
+        //! Submitted batches in submission order
+        std::deque<Batch> m_submitted;
+        std::vector<CommandBuffer> m_freeCmds;
+    };
+} // Shift::VK
+
+#endif //SHIFT_ASYNCCOMPUTEQUEUE_HPP
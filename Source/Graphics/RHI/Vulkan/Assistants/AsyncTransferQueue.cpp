@@ -0,0 +1,290 @@
+#include "AsyncTransferQueue.hpp"
+
+#include <algorithm>
+
+#include "Utility/Vulkan/VKUtilRHI.hpp"
+
+namespace Shift::VK {
+    bool AsyncTransferQueue::Init(const Device *device, const Instance *ins, VkCommandPool transferPool, uint64_t ringSize) {
+        m_device = device;
+        m_instance = ins;
+        m_pool = transferPool;
+
+        const auto& families = m_device->GetQueueFamilyIndices();
+        m_transferFamily = families.transferFamily.value();
+        m_graphicsFamily = families.graphicsFamily.value();
+
+        if (!m_ring.Init(m_device, ringSize, "AsyncTransferRing")) { return false; }
+        if (!m_timeline.Init(m_device, 0)) {
+            Log(Error, "Failed to create the async transfer timeline semaphore!");
+            return false;
+        }
+
+        return true;
+    }
+
+    TransferToken AsyncTransferQueue::UploadToBuffer(const void *data, uint64_t size, const BufferOpDescriptor &dstBuf) {
+        BufferOpDescriptor src{};
+        if (!EnsureRecording() || !Stage(data, size, &src)) { return {}; }
+
+        m_recording.cmd.CopyBufferToBuffer(src, dstBuf, static_cast<uint32_t>(size));
+
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = m_transferFamily;
+        barrier.dstQueueFamilyIndex = m_graphicsFamily;
+        barrier.buffer = dstBuf.buffer->VK_Get();
+        barrier.offset = dstBuf.offset;
+        barrier.size = size;
+
+        //! Same family means the semaphore alone makes the writes visible, no ownership to hand over
+        if (NeedsOwnershipTransfer()) {
+            VkBufferMemoryBarrier release = barrier;
+            release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            release.dstAccessMask = 0;
+            m_recording.bufferReleases.push_back(release);
+
+            VkBufferMemoryBarrier acquire = barrier;
+            acquire.srcAccessMask = 0;
+            acquire.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            m_recording.bufferAcquires.push_back(acquire);
+        }
+
+        return {m_recording.value};
+    }
+
+    TransferToken AsyncTransferQueue::UploadToTexture(const void *data, uint64_t size, const TextureCopyDescriptor &dstTex, EResourceLayout finalLayout) {
+        BufferOpDescriptor src{};
+        if (!EnsureRecording() || !Stage(data, size, &src)) { return {}; }
+
+        const Texture* tex = dstTex.texture;
+        VkImageSubresourceRange range = Util::ShiftToVKSubresourceRange(dstTex.subresourceRange);
+
+        //! The transfer queue takes the image from undefined, previous contents are discarded
+        m_recording.cmd.VK_TransferImageLayout(
+            tex->GetImage(),
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            range
+        );
+        m_recording.cmd.CopyBufferToTexture(src, dstTex);
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = Util::ShiftToVKResourceLayout(finalLayout);
+        barrier.image = tex->GetImage();
+        barrier.subresourceRange = range;
+
+        VkImageMemoryBarrier release = barrier;
+        release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        release.dstAccessMask = 0;
+        if (NeedsOwnershipTransfer()) {
+            release.srcQueueFamilyIndex = m_transferFamily;
+            release.dstQueueFamilyIndex = m_graphicsFamily;
+
+            VkImageMemoryBarrier acquire = release;
+            acquire.srcAccessMask = 0;
+            acquire.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            m_recording.imageAcquires.push_back(acquire);
+        } else {
+            //! Plain layout transition, the semaphore covers visibility
+            release.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            release.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        }
+        m_recording.imageReleases.push_back(release);
+
+        return {m_recording.value};
+    }
+
+    bool AsyncTransferQueue::Submit() {
+        if (!m_isRecording) { return true; }
+
+        if (!m_recording.bufferReleases.empty() || !m_recording.imageReleases.empty()) {
+            m_recording.cmd.VK_SetPipelineBarrier(
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                m_recording.imageReleases,
+                {},
+                m_recording.bufferReleases,
+                0
+            );
+        }
+
+        m_isRecording = false;
+        m_recording.ringHead = m_ring.GetHead();
+        if (!m_recording.cmd.End()) {
+            Log(Error, "Failed to end an async transfer batch!");
+            DropRecording();
+            return false;
+        }
+
+        m_ring.FlushWrites();
+        m_recording.bufferReleases.clear();
+        m_recording.imageReleases.clear();
+
+        uint64_t value = m_recording.value;
+        if (!m_recording.cmd.VK_Submit({}, {}, {}, {m_timeline.Ptr(), 1}, {&value, 1})) {
+            Log(Error, "Failed to submit an async transfer batch!");
+            DropRecording();
+            return false;
+        }
+
+        m_submitted.push_back(std::move(m_recording));
+        m_recording = Batch{};
+        ++m_nextValue;
+
+        return true;
+    }
+
+    void AsyncTransferQueue::DropRecording() {
+        //! The ring frees in order, so the staging goes with the last batch still in flight, or now if there is none
+        if (!m_submitted.empty() && !m_submitted.back().isComplete) {
+            Batch& last = m_submitted.back();
+            last.ringHead = m_recording.ringHead;
+            last.overflowBuffers.insert(last.overflowBuffers.end(), m_recording.overflowBuffers.begin(), m_recording.overflowBuffers.end());
+        } else {
+            ReleaseStaging(m_recording);
+        }
+
+        m_freeCmds.push_back(m_recording.cmd);
+        m_recording = Batch{};
+    }
+
+    uint64_t AsyncTransferQueue::RecordAcquires(const CommandBuffer &graphicsCmd) {
+        PollCompleted();
+
+        while (!m_submitted.empty() && m_submitted.front().isComplete) {
+            Batch& batch = m_submitted.front();
+            m_pendingBufferAcquires.insert(m_pendingBufferAcquires.end(), batch.bufferAcquires.begin(), batch.bufferAcquires.end());
+            m_pendingImageAcquires.insert(m_pendingImageAcquires.end(), batch.imageAcquires.begin(), batch.imageAcquires.end());
+            m_pendingValue = batch.value;
+
+            m_freeCmds.push_back(batch.cmd);
+            m_submitted.pop_front();
+        }
+
+        if (!m_pendingBufferAcquires.empty() || !m_pendingImageAcquires.empty()) {
+            graphicsCmd.VK_SetPipelineBarrier(
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                m_pendingImageAcquires,
+                {},
+                m_pendingBufferAcquires,
+                0
+            );
+        }
+
+        m_acquiredValue = std::max(m_acquiredValue, m_pendingValue);
+        return m_pendingValue;
+    }
+
+    void AsyncTransferQueue::ConfirmAcquires() {
+        m_pendingBufferAcquires.clear();
+        m_pendingImageAcquires.clear();
+        m_pendingValue = 0;
+    }
+
+    void AsyncTransferQueue::Wait(TransferToken token) {
+        if (!token.IsValid() || IsReady(token)) { return; }
+
+        //! A dropped batch never signals its value
+        if (m_isRecording && token.value == m_recording.value && !Submit()) { return; }
+        m_timeline.Wait(token.value);
+        PollCompleted();
+    }
+
+    bool AsyncTransferQueue::Stage(const void *data, uint64_t size, BufferOpDescriptor *outSrc) {
+        uint64_t offset = m_ring.TryAllocate(size);
+        if (offset == UINT64_MAX && size <= m_ring.GetSize()) {
+            PollCompleted();
+            offset = m_ring.TryAllocate(size);
+        }
+
+        if (offset != UINT64_MAX) {
+            m_ring.Write(data, size, offset);
+            *outSrc = {m_ring.GetBuffer(), static_cast<uint32_t>(offset)};
+            return true;
+        }
+
+        //! Streaming must never wait for the GPU, so a full ring spills into a temporary buffer instead
+        Buffer& tmp = m_recording.overflowBuffers.emplace_back();
+        tmp.Init(m_device, BufferDescriptor{.size = size, .name = "AsyncTransferOverflow", .type = EBufferType::Staging});
+        if (!tmp.IsValid()) {
+            Log(Error, "Failed to create an overflow staging buffer of size: {}", size);
+            m_recording.overflowBuffers.pop_back();
+            return false;
+        }
+        tmp.Fill(data, size, 0);
+        tmp.FlushMapped(0, VK_WHOLE_SIZE);
+        *outSrc = {&tmp, 0};
+
+        return true;
+    }
+
+    bool AsyncTransferQueue::EnsureRecording() {
+        if (m_isRecording) { return true; }
+
+        CommandBuffer cmd;
+        if (!m_freeCmds.empty()) {
+            cmd = m_freeCmds.back();
+            m_freeCmds.pop_back();
+        } else if (!cmd.Init(m_device, m_instance, m_pool, EPoolQueueType::Transfer)) {
+            Log(Error, "Failed to create an async transfer command buffer!");
+            return false;
+        }
+
+        cmd.Reset();
+        if (!cmd.Begin()) { return false; }
+
+        m_recording.cmd = cmd;
+        m_recording.value = m_nextValue;
+        m_isRecording = true;
+
+        return true;
+    }
+
+    void AsyncTransferQueue::PollCompleted() {
+        uint64_t completed = m_timeline.GetValue();
+        for (auto& batch: m_submitted) {
+            if (batch.isComplete || batch.value > completed) { continue; }
+
+            batch.isComplete = true;
+            ReleaseStaging(batch);
+        }
+    }
+
+    void AsyncTransferQueue::ReleaseStaging(Batch &batch) {
+        m_ring.Release(batch.ringHead);
+        for (auto& buf: batch.overflowBuffers) {
+            buf.Destroy();
+        }
+        batch.overflowBuffers.clear();
+    }
+
+    void AsyncTransferQueue::Destroy() {
+        if (m_nextValue > 1) {
+            m_timeline.Wait(m_nextValue - 1);
+        }
+
+        for (auto& batch: m_submitted) {
+            ReleaseStaging(batch);
+            batch.cmd.Destroy();
+        }
+        m_submitted.clear();
+
+        if (m_isRecording) {
+            ReleaseStaging(m_recording);
+            m_recording.cmd.Destroy();
+        }
+        for (auto& cmd: m_freeCmds) {
+            cmd.Destroy();
+        }
+        m_freeCmds.clear();
+
+        m_timeline.Destroy();
+        m_ring.Destroy();
+    }
+} // Shift::VK
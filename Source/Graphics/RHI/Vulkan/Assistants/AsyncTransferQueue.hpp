@@ -0,0 +1,136 @@
+#ifndef SHIFT_ASYNCTRANSFERQUEUE_HPP
+#define SHIFT_ASYNCTRANSFERQUEUE_HPP
+
+#include <deque>
+#include <vector>
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKBuffer.hpp"
+#include "Graphics/RHI/Vulkan/VKTexture.hpp"
+#include "Graphics/RHI/Vulkan/VKSemaphore.hpp"
+#include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
+
+#include "StagingRing.hpp"
+
+namespace Shift::VK {
+    //! Streams data on the dedicated transfer queue without ever blocking the frame.
+    //! Every submitted batch signals a timeline semaphore value, that value is the TransferToken handed out to the caller.
+    //! When the transfer family differs from the graphics one, each resource is released on the transfer queue and acquired
+    //! on the graphics queue. Acquires are recorded at the start of a frame, but only for batches the CPU already saw complete,
+    //! so the graphics queue never waits on a transfer that is still running.
+    class AsyncTransferQueue {
+    public:
+        //! Initialize the async transfer queue
+        //! \param device Device wrapper ptr
+        //! \param ins Instance wrapper ptr
+        //! \param transferPool The command pool of the transfer family
+        //! \param ringSize Staging ring size in bytes
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, const Instance* ins, VkCommandPool transferPool, uint64_t ringSize);
+
+        //! Queue a buffer upload into the current batch
+        //! \param data source data, can be freed right after the call
+        //! \param size data size
+        //! \param dstBuf destination buffer + offset
+        //! \return The token of the batch, invalid token on failure
+        TransferToken UploadToBuffer(const void* data, uint64_t size, const BufferOpDescriptor& dstBuf);
+
+        //! Queue a texture upload into the current batch, the texture ends up in finalLayout once acquired. The layout is
+        //! not cached on the texture, the caller hands it to the state tracker
+        //! \param data tightly packed texel data, can be freed right after the call
+        //! \param size data size
+        //! \param dstTex destination texture + region + subresource
+        //! \param finalLayout the layout the texture is left in
+        //! \return The token of the batch, invalid token on failure
+        TransferToken UploadToTexture(const void* data, uint64_t size, const TextureCopyDescriptor& dstTex, EResourceLayout finalLayout);
+
+        //! Submit the current batch to the transfer queue, never blocks. A batch that fails is dropped, its uploads never
+        //! happen and its timeline value goes to the next batch
+        //! \return false if the submission failed
+        bool Submit();
+
+        //! Record the ownership acquires of every completed batch into a graphics command buffer.
+        //! Acquires stay pending and get recorded again until ConfirmAcquires(), so a frame that never got submitted loses nothing.
+        //! \param graphicsCmd a recording graphics command buffer
+        //! \return The timeline value the graphics submit has to wait for, 0 if nothing was acquired
+        uint64_t RecordAcquires(const CommandBuffer& graphicsCmd);
+
+        //! The command buffer with the recorded acquires was submitted
+        void ConfirmAcquires();
+
+        //! Whether the resources of the token are usable on the graphics queue (transfer done and ownership acquired)
+        [[nodiscard]] bool IsReady(TransferToken token) const { return token.value <= m_acquiredValue; }
+
+        //! Block until the transfer of the token is done on the GPU, the acquire still happens at the next RecordAcquires
+        //! \param token transfer token
+        void Wait(TransferToken token);
+
+        [[nodiscard]] const TimelineSemaphore& GetTimeline() const { return m_timeline; }
+
+        //! Timeline value of the latest batch that may touch a resource, recording or submitted, 0 if none
+        [[nodiscard]] uint64_t GetLastValue() const { return (m_isRecording) ? m_nextValue : m_nextValue - 1; }
+
+        void Destroy();
+        ~AsyncTransferQueue() = default;
+    private:
+        struct Batch {
+            CommandBuffer cmd;
+            uint64_t value = 0;
+            uint64_t ringHead = 0;
+            bool isComplete = false;
+            //! Recorded all at once at submission
+            std::vector<VkBufferMemoryBarrier> bufferReleases;
+            std::vector<VkImageMemoryBarrier> imageReleases;
+            //! Recorded on the graphics queue once the batch is complete
+            std::vector<VkBufferMemoryBarrier> bufferAcquires;
+            std::vector<VkImageMemoryBarrier> imageAcquires;
+            std::vector<Buffer> overflowBuffers;
+        };
+
+        //! Get a staging region for the data, either the ring or a temporary buffer
+        //! \return false if failed
+        bool Stage(const void* data, uint64_t size, BufferOpDescriptor* outSrc);
+
+        //! Make sure there is a batch recording
+        bool EnsureRecording();
+
+        //! Mark completed batches and release their staging memory, does not block
+        void PollCompleted();
+
+        //! Free the staging memory of a completed batch
+        void ReleaseStaging(Batch& batch);
+
+        //! Throw away the recording batch after a failed End or submit, the command buffer is reused
+        void DropRecording();
+
+        [[nodiscard]] bool NeedsOwnershipTransfer() const { return m_transferFamily != m_graphicsFamily; }
+
+        const Device* m_device = nullptr;
+        const Instance* m_instance = nullptr;
+        VkCommandPool m_pool = VK_NULL_HANDLE;
+
+        uint32_t m_transferFamily = 0;
+        uint32_t m_graphicsFamily = 0;
+
+        StagingRing m_ring;
+        TimelineSemaphore m_timeline;
+
+        //! The value the recording batch is going to signal
+        uint64_t m_nextValue = 1;
+        //! Everything up to this value is usable on the graphics queue
+        uint64_t m_acquiredValue = 0;
+
+        //! Acquires recorded into a frame that was not submitted yet
+        std::vector<VkBufferMemoryBarrier> m_pendingBufferAcquires;
+        std::vector<VkImageMemoryBarrier> m_pendingImageAcquires;
+        uint64_t m_pendingValue = 0;
+
+        bool m_isRecording = false;
+        Batch m_recording;
+        //! Submitted batches in submission order
+        std::deque<Batch> m_submitted;
+        std::vector<CommandBuffer> m_freeCmds;
+    };
+} // Shift::VK
+
+#endif //SHIFT_ASYNCTRANSFERQUEUE_HPP
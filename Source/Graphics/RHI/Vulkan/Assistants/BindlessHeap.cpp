@@ -0,0 +1,215 @@
+#include "BindlessHeap.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Utility/Vulkan/VKUtilRHI.hpp"
+
+namespace Shift::VK {
+    bool BindlessHeap::Init(const Device *device, DescriptorLayoutCache *layoutCache) {
+        m_device = device;
+
+        //! Stay inside what the device can have bound per stage with update after bind
+        VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+        vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &vulkan12Properties;
+        vkGetPhysicalDeviceProperties2(m_device->GetPhysicalDevice(), &properties);
+
+        GetSlots(EBindlessType::Texture).capacity = std::min(Conf::SHIFT_BINDLESS_TEXTURE_COUNT, vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+        GetSlots(EBindlessType::Sampler).capacity = std::min(Conf::SHIFT_BINDLESS_SAMPLER_COUNT, vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers);
+        GetSlots(EBindlessType::Buffer).capacity = std::min(Conf::SHIFT_BINDLESS_BUFFER_COUNT, vulkan12Properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers);
+        m_textureOwners.resize(GetSlots(EBindlessType::Texture).capacity);
+
+        auto makeBinding = [this](EBindlessType type, EBindingType bindingType) {
+            return PipelineLayoutDescriptor::LayoutBindingDesc{
+                .binding = GetBinding(type),
+                .type = bindingType,
+                .stageFlags = EBindingVisibility::All,
+                .count = GetSlots(type).capacity,
+                .isBindless = true
+            };
+        };
+        m_layoutDesc.bindings = {
+            makeBinding(EBindlessType::Texture, EBindingType::SampledImage),
+            makeBinding(EBindlessType::Sampler, EBindingType::Sampler),
+            makeBinding(EBindlessType::Buffer, EBindingType::StorageBuffer),
+        };
+
+        m_layout = layoutCache->CreateDescriptorLayout(m_layoutDesc);
+        if (m_layout == VK_NULL_HANDLE) {
+            Log(Error, "Failed to create the bindless heap layout!");
+            return false;
+        }
+
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        for (const auto& binding: m_layoutDesc.bindings) {
+            poolSizes.push_back({Util::ShiftToVKBindingType(binding.type), binding.count});
+        }
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+
+        m_pool = m_device->CreateDescriptorPool(poolInfo);
+        if (m_pool == VK_NULL_HANDLE) { return false; }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_pool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_layout;
+
+        VkResult result;
+        m_set = m_device->AllocateDescriptorSet(allocInfo, &result);
+        if (VkCheck(result)) {
+            Log(Error, "Failed to allocate the bindless heap set!");
+            return false;
+        }
+
+        return true;
+    }
+
+    BindlessHandle BindlessHeap::AddTexture(const Texture &texture, TextureHandle owner) {
+        BindlessHandle handle = Allocate(EBindlessType::Texture);
+        if (handle.IsValid()) {
+            m_textureOwners[handle.index] = owner;
+            UpdateTexture(handle, texture);
+        }
+        return handle;
+    }
+
+    BindlessHandle BindlessHeap::AddSampler(const Sampler &sampler) {
+        BindlessHandle handle = Allocate(EBindlessType::Sampler);
+        if (handle.IsValid()) {
+            m_pendingWrites.push_back({.type = handle.type, .index = handle.index, .image = {.sampler = sampler.VK_Get()}});
+        }
+        return handle;
+    }
+
+    BindlessHandle BindlessHeap::AddBuffer(const Buffer &buffer, uint64_t offset, uint64_t size) {
+        BindlessHandle handle = Allocate(EBindlessType::Buffer);
+        if (handle.IsValid()) {
+            m_pendingWrites.push_back({.type = handle.type, .index = handle.index, .buffer = {buffer.VK_Get(), offset, size}});
+        }
+        return handle;
+    }
+
+    void BindlessHeap::UpdateTexture(BindlessHandle handle, const Texture &texture) {
+        assert(handle.type == EBindlessType::Texture);
+
+        VkDescriptorImageInfo image{};
+        image.imageView = texture.GetView();
+        //! The layout the texture is sampled in, not the one it's in now, the state tracker moves it there before the reads
+        image.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_pendingWrites.push_back({.type = handle.type, .index = handle.index, .image = image});
+    }
+
+    void BindlessHeap::MoveOwnedTexture(TextureHandle owner, const Texture &texture, std::vector<BindlessMove>* moves) {
+        //! Gathered first, the new slots may come after the old ones and have the same owner
+        std::vector<uint32_t> owned;
+        const SlotAllocator& slots = GetSlots(EBindlessType::Texture);
+        for (uint32_t i = 0; i < slots.next; ++i) {
+            if (m_textureOwners[i] == owner) {
+                owned.push_back(i);
+            }
+        }
+
+        for (uint32_t index: owned) {
+            BindlessHandle from{index, EBindlessType::Texture};
+            BindlessHandle to = AddTexture(texture, owner);
+            if (!to.IsValid()) { break; }
+
+            //! Frames in flight still sample the old slot, with update unused while pending it can't be written
+            Remove(from);
+            moves->push_back({.from = from, .to = to});
+        }
+    }
+
+    uint32_t BindlessHeap::GetOwnedTextureCount(TextureHandle owner) const {
+        const SlotAllocator& slots = GetSlots(EBindlessType::Texture);
+        return static_cast<uint32_t>(std::count(m_textureOwners.begin(), m_textureOwners.begin() + slots.next, owner));
+    }
+
+    uint32_t BindlessHeap::GetFreeTextureCount() const {
+        const SlotAllocator& slots = GetSlots(EBindlessType::Texture);
+        return slots.capacity - slots.next + static_cast<uint32_t>(slots.free.size());
+    }
+
+    void BindlessHeap::Remove(BindlessHandle handle) {
+        if (!handle.IsValid()) { return; }
+        if (handle.type == EBindlessType::Texture) {
+            m_textureOwners[handle.index] = {};
+        }
+
+        //! Partially bound, the stale descriptor can stay until the slot gets written again
+        GetSlots(handle.type).retired[m_currentFrame].push_back(handle.index);
+    }
+
+    void BindlessHeap::BeginFrame(uint32_t frameIdx) {
+        m_currentFrame = frameIdx;
+
+        //! The frame that used this slot last has finished, nothing reads its releases anymore
+        for (auto& slots: m_slots) {
+            auto& retired = slots.retired[m_currentFrame];
+            slots.free.insert(slots.free.end(), retired.begin(), retired.end());
+            retired.clear();
+        }
+    }
+
+    void BindlessHeap::Flush() {
+        if (m_pendingWrites.empty()) { return; }
+
+        std::vector<VkWriteDescriptorSet> writes;
+        writes.reserve(m_pendingWrites.size());
+        for (const auto& pending: m_pendingWrites) {
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = m_set;
+            write.dstBinding = GetBinding(pending.type);
+            write.dstArrayElement = pending.index;
+            write.descriptorCount = 1;
+            write.descriptorType = Util::ShiftToVKBindingType(m_layoutDesc.bindings[GetBinding(pending.type)].type);
+            if (pending.type == EBindlessType::Buffer) {
+                write.pBufferInfo = &pending.buffer;
+            } else {
+                write.pImageInfo = &pending.image;
+            }
+            writes.push_back(write);
+        }
+
+        vkUpdateDescriptorSets(m_device->Get(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        m_pendingWrites.clear();
+    }
+
+    void BindlessHeap::Destroy() {
+        //! The set goes with the pool, the layout belongs to the layout cache
+        m_device->DestroyDescriptorPool(m_pool);
+        m_pool = VK_NULL_HANDLE;
+        m_set = VK_NULL_HANDLE;
+        m_pendingWrites.clear();
+        m_textureOwners.clear();
+    }
+
+    uint32_t BindlessHeap::SlotAllocator::Allocate() {
+        if (!free.empty()) {
+            uint32_t index = free.back();
+            free.pop_back();
+            return index;
+        }
+        return (next < capacity) ? next++ : UINT32_MAX;
+    }
+
+    BindlessHandle BindlessHeap::Allocate(EBindlessType type) {
+        uint32_t index = GetSlots(type).Allocate();
+        if (index == UINT32_MAX) {
+            Log(Error, "Bindless heap is out of slots of type {}", static_cast<uint32_t>(type));
+            return {};
+        }
+        return {index, type};
+    }
+} // Shift::VK
@@ -0,0 +1,112 @@
+#ifndef SHIFT_BINDLESSHEAP_HPP
+#define SHIFT_BINDLESSHEAP_HPP
+
+#include <array>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/Handle.hpp"
+#include "Graphics/RHI/ResourceSet.hpp"
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKBuffer.hpp"
+#include "Graphics/RHI/Vulkan/VKTexture.hpp"
+#include "Graphics/RHI/Vulkan/VKSampler.hpp"
+
+#include "DescriptorLayoutCache.hpp"
+
+namespace Shift::VK {
+    //! One global descriptor set with big arrays of textures, samplers and storage buffers (Shaders/Source/Bindless.glsl).
+    //! Resources get a slot once and shaders index the arrays with it, so materials don't need a set bind per draw.
+    //! The bindings are partially bound and update after bind: slots are written while frames in flight use the set,
+    //! and a released slot is only handed out again once the frames that could still read it are done.
+    class BindlessHeap {
+    public:
+        //! Create the pool, layout and the set
+        //! \param device Device wrapper ptr
+        //! \param layoutCache the heap layout goes through it, so reflected pipelines get the exact same handle
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, DescriptorLayoutCache* layoutCache);
+
+        //! Put a texture in the heap, it's sampled in ShaderReadOnlyOptimal whatever layout it is in right now
+        //! \param texture texture to sample
+        //! \param owner handle of the texture, its slots follow it through MoveOwnedTexture
+        //! \return invalid handle if the heap is full
+        [[nodiscard]] BindlessHandle AddTexture(const Texture& texture, TextureHandle owner = {});
+        [[nodiscard]] BindlessHandle AddSampler(const Sampler& sampler);
+        //! \param buffer storage buffer
+        //! \param offset offset of the range
+        //! \param size range size, VK_WHOLE_SIZE for the rest of the buffer
+        [[nodiscard]] BindlessHandle AddBuffer(const Buffer& buffer, uint64_t offset = 0, uint64_t size = VK_WHOLE_SIZE);
+
+        //! Point a texture slot at another texture
+        void UpdateTexture(BindlessHandle handle, const Texture& texture);
+        //! Give every slot added with this owner a new slot with the texture now behind the handle. Frames in flight may
+        //! still sample the old slots, those aren't rewritten but retired like on Remove
+        //! \param owner handle of the replaced texture
+        //! \param texture the texture now behind the handle
+        //! \param moves gets a move per slot, check GetOwnedTextureCount against GetFreeTextureCount first
+        void MoveOwnedTexture(TextureHandle owner, const Texture& texture, std::vector<BindlessMove>* moves);
+        //! \return number of texture slots added with this owner
+        [[nodiscard]] uint32_t GetOwnedTextureCount(TextureHandle owner) const;
+        //! \return number of texture slots that can be handed out right now
+        [[nodiscard]] uint32_t GetFreeTextureCount() const;
+
+        //! Give the slot back, it is reused after all the frames in flight are done with it
+        void Remove(BindlessHandle handle);
+
+        //! Recycle the slots released when this frame slot was last used
+        //! \param frameIdx current frame in flight
+        void BeginFrame(uint32_t frameIdx);
+
+        //! Write every pending descriptor in one update call, has to happen before the frame is submitted
+        void Flush();
+
+        //! The offline description of the heap set, the layout of every pipeline using the bindless set
+        [[nodiscard]] const PipelineLayoutDescriptor& GetLayoutDescriptor() const { return m_layoutDesc; }
+        [[nodiscard]] VkDescriptorSet VK_GetSet() const { return m_set; }
+
+        void Destroy();
+        ~BindlessHeap() = default;
+    private:
+        //! Free list slots of one array
+        struct SlotAllocator {
+            uint32_t capacity = 0;
+            uint32_t next = 0;
+            std::vector<uint32_t> free;
+            //! Released in a frame, reusable once the same frame slot comes around again
+            std::array<std::vector<uint32_t>, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> retired;
+
+            [[nodiscard]] uint32_t Allocate();
+        };
+
+        struct PendingWrite {
+            EBindlessType type;
+            uint32_t index;
+            VkDescriptorImageInfo image;
+            VkDescriptorBufferInfo buffer;
+        };
+
+        [[nodiscard]] BindlessHandle Allocate(EBindlessType type);
+
+        //! The arrays are bound in EBindlessType order, so the type is the binding and the slot allocator index
+        [[nodiscard]] static uint32_t GetBinding(EBindlessType type) { return static_cast<uint32_t>(type); }
+        [[nodiscard]] SlotAllocator& GetSlots(EBindlessType type) { return m_slots[GetBinding(type)]; }
+        [[nodiscard]] const SlotAllocator& GetSlots(EBindlessType type) const { return m_slots[GetBinding(type)]; }
+
+        const Device* m_device = nullptr;
+
+        PipelineLayoutDescriptor m_layoutDesc;
+        VkDescriptorPool m_pool = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_layout = VK_NULL_HANDLE;
+        VkDescriptorSet m_set = VK_NULL_HANDLE;
+
+        std::array<SlotAllocator, 3> m_slots;
+        std::vector<PendingWrite> m_pendingWrites;
+        //! Owner handle of every texture slot, only walked when an owned texture is replaced
+        std::vector<TextureHandle> m_textureOwners;
+        uint32_t m_currentFrame = 0;
+    };
+} // Shift::VK
+
+#endif //SHIFT_BINDLESSHEAP_HPP
@@ -3,7 +3,7 @@
 #include "Utility/Vulkan/VKUtilInfo.hpp"
 
 namespace Shift::VK {
-    void CommandPoolStorage::Init(const Device *device, const Instance* ins) {
+    void CommandPoolStorage::Init(const Device *device, const Instance* ins, uint32_t workerCount) {
         m_device = device;
         m_instance = ins;
 
@@ -12,13 +12,36 @@ namespace Shift::VK {
         uint32_t queueFamilyIndexGraphics = queueFamiliIndices.graphicsFamily.value();
         // uint32_t queueFamilyIndexPresent = queueFamiliIndices..value();
         uint32_t queueFamilyIndexTransfer = queueFamiliIndices.transferFamily.value();
+        uint32_t queueFamilyIndexCompute = queueFamiliIndices.computeFamily.value();
 
         m_graphicsPool = m_device->CreateCommandPool(Util::CreateCommandPoolInfo(queueFamilyIndexGraphics));
         m_transferPool = m_device->CreateCommandPool(Util::CreateCommandPoolInfo(queueFamilyIndexTransfer));
+        m_computePool = m_device->CreateCommandPool(Util::CreateCommandPoolInfo(queueFamilyIndexCompute));
+
+        //! Buffers of a worker pool live for a single frame, so no per buffer reset
+        m_workerPools.resize(workerCount);
+        for (auto& framePools: m_workerPools) {
+            for (auto& pool: framePools) {
+                pool = m_device->CreateCommandPool(Util::CreateCommandPoolInfo(queueFamilyIndexGraphics, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT));
+            }
+        }
+    }
+
+    void CommandPoolStorage::ResetWorkerPools(uint32_t frameIdx) {
+        for (auto& framePools: m_workerPools) {
+            m_device->ResetCommandPool(framePools[frameIdx]);
+        }
     }
 
     void CommandPoolStorage::Destroy() {
         m_device->DestroyCommandPool(m_graphicsPool);
         m_device->DestroyCommandPool(m_transferPool);
+        m_device->DestroyCommandPool(m_computePool);
+        for (auto& framePools: m_workerPools) {
+            for (auto& pool: framePools) {
+                m_device->DestroyCommandPool(pool);
+            }
+        }
+        m_workerPools.clear();
     }
 }
@@ -5,13 +5,19 @@
 #ifndef SHIFT_COMMANDPOOL_HPP
 #define SHIFT_COMMANDPOOL_HPP
 
+#include <array>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
 #include "Graphics/RHI/Vulkan/VKDevice.hpp"
 #include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
 
 namespace Shift::VK {
     class CommandPoolStorage {
     public:
-        void Init(const Device *device, const Instance* ins);
+        //! \param workerCount amount of recording workers, each gets a graphics pool per frame in flight
+        void Init(const Device *device, const Instance* ins, uint32_t workerCount);
         void Destroy();
 
         [[nodiscard]] const Instance* GetInstance() const { return m_instance ; }
@@ -19,12 +25,24 @@ namespace Shift::VK {
         [[nodiscard]] VkCommandPool GetGraphics() { return m_graphicsPool; }
         // [[nodiscard]] VkCommandPool GetPresent() { return m_presentPool; }
         [[nodiscard]] VkCommandPool GetTransfer() { return m_transferPool; }
+        //! Of the compute family, the graphics one when the GPU has no separate compute family
+        [[nodiscard]] VkCommandPool GetCompute() { return m_computePool; }
+
+        //! Worker pools are transient and only ever reset as a whole, the owning worker is the only one allowed to touch it
+        [[nodiscard]] VkCommandPool GetWorker(uint32_t workerIdx, uint32_t frameIdx) { return m_workerPools[workerIdx][frameIdx]; }
+        [[nodiscard]] uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workerPools.size()); }
+
+        //! Reset all the worker pools of a frame slot, the frame has to be done on the GPU
+        //! \param frameIdx frame in flight index
+        void ResetWorkerPools(uint32_t frameIdx);
     private:
         const Device* m_device;
         const Instance* m_instance;
 
         VkCommandPool m_transferPool;
         VkCommandPool m_graphicsPool;
+        VkCommandPool m_computePool;
+        std::vector<std::array<VkCommandPool, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT>> m_workerPools;
         // VkCommandPool m_presentPool;
     };
 } // Shift::VK
@@ -0,0 +1,42 @@
+#include "DeletionQueue.hpp"
+
+namespace Shift::VK {
+    void DeletionQueue::Init(const TimelineSemaphore *transferTimeline, const TimelineSemaphore *computeTimeline) {
+        m_transferTimeline = transferTimeline;
+        m_computeTimeline = computeTimeline;
+    }
+
+    void DeletionQueue::BeginFrame(uint64_t frame, uint64_t completedFrame) {
+        m_frame = frame;
+        if (m_entries.empty()) { return; }
+
+        //! One poll per frame, the timelines only move forward
+        uint64_t transferValue = m_transferTimeline->GetValue();
+        uint64_t computeValue = m_computeTimeline->GetValue();
+        while (!m_entries.empty()) {
+            Entry& entry = m_entries.front();
+            //! Queue values are not ordered with the frames, a pending one holds back what comes after it
+            if (entry.frame > completedFrame || entry.transferValue > transferValue || entry.computeValue > computeValue) { break; }
+
+            entry.destroy();
+            m_entries.pop_front();
+        }
+    }
+
+    void DeletionQueue::Push(DestroyFunc &&destroy, uint64_t transferValue, uint64_t computeValue) {
+        m_entries.push_back({.frame = m_frame, .transferValue = transferValue, .computeValue = computeValue, .destroy = std::move(destroy)});
+    }
+
+    void DeletionQueue::Flush() {
+        for (auto& entry: m_entries) {
+            entry.destroy();
+        }
+        m_entries.clear();
+    }
+
+    void DeletionQueue::Destroy() {
+        Flush();
+        m_transferTimeline = nullptr;
+        m_computeTimeline = nullptr;
+    }
+} // Shift::VK
@@ -0,0 +1,57 @@
+#ifndef SHIFT_DELETIONQUEUE_HPP
+#define SHIFT_DELETIONQUEUE_HPP
+
+#include <deque>
+#include <functional>
+
+#include "Graphics/RHI/Vulkan/VKSemaphore.hpp"
+
+namespace Shift::VK {
+    //! Deferred destruction of GPU objects. Every entry is tagged with the last frame that could have recorded it and
+    //! the async transfer and compute timeline values that could still use it, it's freed once all have retired on the GPU, so
+    //! replacing a resource at runtime never has to wait for the device to go idle. Entries are freed in the order they
+    //! were pushed, e.g. textures placed into a memory block go before the block when pushed first. Main thread only.
+    class DeletionQueue {
+    public:
+        using DestroyFunc = std::function<void()>;
+
+        //! \param transferTimeline timeline of the async transfer queue, polled without blocking
+        //! \param computeTimeline timeline of the async compute queue, polled without blocking
+        void Init(const TimelineSemaphore* transferTimeline, const TimelineSemaphore* computeTimeline);
+
+        //! Start tagging with a new frame and free what retired
+        //! \param frame number of the frame that is being recorded now
+        //! \param completedFrame every frame up to this one is done on the GPU
+        void BeginFrame(uint64_t frame, uint64_t completedFrame);
+
+        //! Defer a destruction
+        //! \param destroy frees the object, called on the main thread
+        //! \param transferValue async transfer value that has to be reached first, 0 if none
+        //! \param computeValue async compute value that has to be reached first, 0 if none
+        void Push(DestroyFunc&& destroy, uint64_t transferValue = 0, uint64_t computeValue = 0);
+
+        //! Free everything right away, the GPU has to be idle
+        void Flush();
+
+        [[nodiscard]] uint32_t GetPendingCount() const { return static_cast<uint32_t>(m_entries.size()); }
+
+        void Destroy();
+        ~DeletionQueue() = default;
+    private:
+        struct Entry {
+            uint64_t frame = 0;
+            uint64_t transferValue = 0;
+            uint64_t computeValue = 0;
+            DestroyFunc destroy;
+        };
+
+        const TimelineSemaphore* m_transferTimeline = nullptr;
+        const TimelineSemaphore* m_computeTimeline = nullptr;
+
+        //! Tagged frames only grow, so the retired entries are always at the front
+        std::deque<Entry> m_entries;
+        uint64_t m_frame = 0;
+    };
+} // Shift::VK
+
+#endif //SHIFT_DELETIONQUEUE_HPP
@@ -35,29 +35,28 @@ namespace Shift::VK {
             m_device->ResetDescriptorPool(p);
         }
         for (auto p: m_fullPools) {
-            m_device->DestroyDescriptorPool(p);
+            m_device->ResetDescriptorPool(p);
             m_readyPools.push_back(p);
         }
         m_fullPools.clear();
     }
 
     VkDescriptorPool DescriptorAllocator::GetPool() {
-        VkDescriptorPool newPool;
+        //! The pool in use stays at the back of the ready list until it fills up
         if (!m_readyPools.empty()) {
-            newPool = m_readyPools.back();
-            m_readyPools.pop_back();
+            return m_readyPools.back();
         }
         else {
             //! Need to create a new pool
-            newPool = CreatePool(m_setsPerPool, m_sizeRatios);
+            VkDescriptorPool newPool = CreatePool(m_setsPerPool, m_sizeRatios);
+            m_readyPools.push_back(newPool);
 
             m_setsPerPool = m_setsPerPool * 1.5;
             if (m_setsPerPool > SET_LIMIT_PER_POOL) {
                 m_setsPerPool = SET_LIMIT_PER_POOL;
             }
+            return newPool;
         }
-
-        return newPool;
     }
 
     VkDescriptorPool DescriptorAllocator::CreatePool(uint32_t setCount, std::span<PoolSizeRatio> poolRatios) {
@@ -95,6 +94,7 @@ namespace Shift::VK {
         //! Allocation failed. Try again but if not then we fucked up
         if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
             m_fullPools.push_back(poolToUse);
+            m_readyPools.pop_back();
 
             poolToUse = GetPool();
             allocInfo.descriptorPool = poolToUse;
@@ -108,7 +108,6 @@ namespace Shift::VK {
             }
         }
 
-        m_readyPools.push_back(poolToUse);
         return ds;
     }
 } // SHift::VK
\ No newline at end of file
@@ -7,7 +7,7 @@
 #include "Graphics/RHI/Vulkan/VKDevice.hpp"
 
 namespace Shift::VK {
-    //! A growable allocator for descriptor sets
+    //! A growable allocator for long lived descriptor sets, per frame sets go to the FrameDescriptorAllocator
     class DescriptorAllocator {
     public:
         struct PoolSizeRatio {
@@ -38,7 +38,7 @@ namespace Shift::VK {
         //! \return
         bool Init(const Device* device, uint32_t initialSets = 4);
 
-        //! Clears all pools
+        //! Resets all pools, every set allocated from them becomes invalid
         void Clear();
 
         //! Destroys all pools
@@ -4,6 +4,11 @@
 
 #include "DescriptorLayoutCache.hpp"
 
+#include <algorithm>
+#include <numeric>
+
+#include "Utility/Vulkan/VKUtilRHI.hpp"
+
 namespace Shift::VK {
     void DescriptorLayoutCache::Init(const Device* device) {
         m_device = device;
@@ -13,17 +18,34 @@ namespace Shift::VK {
         for (auto pair : layoutCache){
             vkDestroyDescriptorSetLayout(m_device->Get(), pair.second, nullptr);
         }
+        for (auto& [layout, updateTemplate]: m_updateTemplates) {
+            if (updateTemplate.IsValid()) {
+                m_device->DestroyDescriptorUpdateTemplate(updateTemplate.handle);
+            }
+        }
+        m_updateTemplates.clear();
     }
 
     VkDescriptorSetLayout DescriptorLayoutCache::CreateDescriptorLayout(const VkDescriptorSetLayoutCreateInfo& info){
         DescriptorLayoutInfo layoutinfo{};
+        layoutinfo.flags = info.flags;
         layoutinfo.bindings.reserve(info.bindingCount);
+        layoutinfo.bindingFlags.reserve(info.bindingCount);
         bool isSorted = true;
         int lastBinding = -1;
 
+        //! Binding flags change the layout as much as the bindings do
+        const VkDescriptorBindingFlags* bindingFlags = nullptr;
+        for (auto next = static_cast<const VkBaseInStructure*>(info.pNext); next != nullptr; next = next->pNext) {
+            if (next->sType == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO) {
+                bindingFlags = reinterpret_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfo*>(next)->pBindingFlags;
+            }
+        }
+
         //copy from the direct info struct into our own one
         for (int i = 0; i < info.bindingCount; i++) {
             layoutinfo.bindings.push_back(info.pBindings[i]);
+            layoutinfo.bindingFlags.push_back((bindingFlags != nullptr) ? bindingFlags[i] : 0);
 
             // Check that the bindings are in strict increasing order
             if (info.pBindings[i].binding > lastBinding) {
@@ -33,11 +55,20 @@ namespace Shift::VK {
                 isSorted = false;
             }
         }
-        // Sort the bindings if they aren't in order
+        // Sort the bindings if they aren't in order, the flags go along with their binding
         if (!isSorted) {
-            std::sort(layoutinfo.bindings.begin(), layoutinfo.bindings.end(), [](VkDescriptorSetLayoutBinding& a, VkDescriptorSetLayoutBinding& b ){
-                    return a.binding < b.binding;
+            std::vector<uint32_t> order(layoutinfo.bindings.size());
+            std::iota(order.begin(), order.end(), 0u);
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                    return layoutinfo.bindings[a].binding < layoutinfo.bindings[b].binding;
             });
+
+            DescriptorLayoutInfo sorted{.flags = layoutinfo.flags};
+            for (uint32_t idx: order) {
+                sorted.bindings.push_back(layoutinfo.bindings[idx]);
+                sorted.bindingFlags.push_back(layoutinfo.bindingFlags[idx]);
+            }
+            layoutinfo = std::move(sorted);
         }
 
         // Try to grab from cache
@@ -51,11 +82,98 @@ namespace Shift::VK {
 
         // Cache dat shi
         layoutCache[layoutinfo] = layout;
+        CreateUpdateTemplate(layout, layoutinfo);
         return layout;
     }
 
+    const DescriptorUpdateTemplate* DescriptorLayoutCache::GetUpdateTemplate(VkDescriptorSetLayout layout) const {
+        auto it = m_updateTemplates.find(layout);
+        return (it != m_updateTemplates.end()) ? &it->second : nullptr;
+    }
+
+    void DescriptorLayoutCache::CreateUpdateTemplate(VkDescriptorSetLayout layout, const DescriptorLayoutInfo &info) {
+        //! A template writes every descriptor of the set, that is not what partially bound/bindless sets want. They still
+        //! get the entries, plain writes take the descriptor types from them
+        bool canTemplate = std::ranges::none_of(info.bindingFlags, [](VkDescriptorBindingFlags f) { return f != 0; });
+
+        DescriptorUpdateTemplate updateTemplate;
+        std::vector<VkDescriptorUpdateTemplateEntry> vkEntries;
+        vkEntries.reserve(info.bindings.size());
+
+        for (const auto& binding: info.bindings) {
+            if (binding.descriptorCount == 0) { continue; }
+
+            updateTemplate.entries.push_back({binding.binding, binding.descriptorType, updateTemplate.slotCount, binding.descriptorCount});
+
+            VkDescriptorUpdateTemplateEntry entry{};
+            entry.dstBinding = binding.binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = binding.descriptorCount;
+            entry.descriptorType = binding.descriptorType;
+            entry.offset = updateTemplate.slotCount * sizeof(DescriptorData);
+            entry.stride = sizeof(DescriptorData);
+            vkEntries.push_back(entry);
+
+            updateTemplate.slotCount += binding.descriptorCount;
+        }
+        if (vkEntries.empty()) { return; }
+        if (!canTemplate) {
+            m_updateTemplates.emplace(layout, std::move(updateTemplate));
+            return;
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo templateInfo{};
+        templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        templateInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(vkEntries.size());
+        templateInfo.pDescriptorUpdateEntries = vkEntries.data();
+        templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        templateInfo.descriptorSetLayout = layout;
+
+        //! Left without a handle if this fails, the sets of the layout then use plain writes
+        updateTemplate.handle = m_device->CreateDescriptorUpdateTemplate(templateInfo);
+        m_updateTemplates.emplace(layout, std::move(updateTemplate));
+    }
+
+    VkDescriptorSetLayout DescriptorLayoutCache::CreateDescriptorLayout(const PipelineLayoutDescriptor& desc) {
+        std::vector<VkDescriptorSetLayoutBinding> vkBindings;
+        std::vector<VkDescriptorBindingFlags> vkBindingFlags;
+        vkBindings.reserve(desc.bindings.size());
+        vkBindingFlags.reserve(desc.bindings.size());
+        bool hasBindless = false;
+
+        for (const auto& b : desc.bindings) {
+            VkDescriptorSetLayoutBinding binding{};
+            binding.binding = b.binding;
+            binding.descriptorCount = b.count;
+            binding.stageFlags = Util::ShiftToVKBindingVisibility(b.stageFlags);
+            binding.descriptorType = Util::ShiftToVKBindingType(b.type);
+            binding.pImmutableSamplers = nullptr; // handle immutable samplers if needed
+            vkBindings.push_back(binding);
+
+            //! Not every slot is written and slots get written while the heap is bound by frames in flight
+            vkBindingFlags.push_back((b.isBindless) ?
+                VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT :
+                0);
+            hasBindless |= b.isBindless;
+        }
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount = static_cast<uint32_t>(vkBindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = vkBindingFlags.data();
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = (hasBindless) ? &bindingFlagsInfo : nullptr;
+        layoutInfo.flags = (hasBindless) ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT : 0;
+        layoutInfo.bindingCount = static_cast<uint32_t>(vkBindings.size());
+        layoutInfo.pBindings = vkBindings.data();
+
+        return CreateDescriptorLayout(layoutInfo);
+    }
+
     bool DescriptorLayoutCache::DescriptorLayoutInfo::operator==(const DescriptorLayoutInfo& other) const {
-        if (other.bindings.size() != bindings.size()) {
+        if (other.bindings.size() != bindings.size() || other.flags != flags || other.bindingFlags != bindingFlags) {
             return false;
         }
         // Compare each of the bindings is the same. Bindings are sorted so they will match
@@ -80,7 +198,7 @@ namespace Shift::VK {
         using std::size_t;
         using std::hash;
 
-        size_t result = hash<size_t>()(bindings.size());
+        size_t result = hash<size_t>()(bindings.size()) ^ hash<size_t>()(flags);
 
         for (const VkDescriptorSetLayoutBinding& b : bindings)
         {
@@ -90,6 +208,9 @@ namespace Shift::VK {
             // Shuffle the packed binding data and xor it with the main hash
             result ^= hash<size_t>()(binding_hash);
         }
+        for (VkDescriptorBindingFlags f : bindingFlags) {
+            result ^= hash<size_t>()(f) << 1;
+        }
 
         return result;
     }
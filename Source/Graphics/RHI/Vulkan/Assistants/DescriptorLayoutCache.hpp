@@ -7,8 +7,11 @@
 
 #include <vector>
 
+#include "Graphics/RHI/Pipeline.hpp"
 #include "Graphics/RHI/Vulkan/VKDevice.hpp"
 
+#include "DescriptorUpdate.hpp"
+
 namespace Shift::VK {
     class DescriptorLayoutCache {
     public:
@@ -18,9 +21,21 @@ namespace Shift::VK {
         //! THe data conversion to this input format lies on the SRHI
         VkDescriptorSetLayout CreateDescriptorLayout(const VkDescriptorSetLayoutCreateInfo& info);
 
+        //! Convert the offline layout description and get the matching layout.
+        //! Bindless bindings are partially bound and update after bind
+        VkDescriptorSetLayout CreateDescriptorLayout(const PipelineLayoutDescriptor& desc);
+
+        //! Get the update template made together with the layout
+        //! \param layout a layout created by this cache
+        //! \return nullptr for layouts without bindings, an invalid template (entries only) for bindless/partially bound ones
+        [[nodiscard]] const DescriptorUpdateTemplate* GetUpdateTemplate(VkDescriptorSetLayout layout) const;
+
         //! Layout info stucture
         struct DescriptorLayoutInfo {
             std::vector<VkDescriptorSetLayoutBinding> bindings;
+            //! Parallel to bindings, 0 when the create info has no binding flags
+            std::vector<VkDescriptorBindingFlags> bindingFlags;
+            VkDescriptorSetLayoutCreateFlags flags = 0;
 
             bool operator==(const DescriptorLayoutInfo& other) const;
 
@@ -28,6 +43,9 @@ namespace Shift::VK {
         };
 
     private:
+        //! Fill the template for a new layout, the bindings are sorted
+        void CreateUpdateTemplate(VkDescriptorSetLayout layout, const DescriptorLayoutInfo& info);
+
         const Device* m_device;
 
         struct DescriptorLayoutHash {
@@ -37,6 +55,8 @@ namespace Shift::VK {
         };
 
         std::unordered_map<DescriptorLayoutInfo, VkDescriptorSetLayout, DescriptorLayoutHash> layoutCache;
+        //! Node based, the template pointers handed out stay valid
+        std::unordered_map<VkDescriptorSetLayout, DescriptorUpdateTemplate> m_updateTemplates;
     };
 
 } // Shift::VK
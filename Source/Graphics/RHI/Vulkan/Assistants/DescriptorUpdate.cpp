@@ -0,0 +1,51 @@
+#include "DescriptorUpdate.hpp"
+
+#include <algorithm>
+
+namespace Shift::VK {
+    const DescriptorUpdateTemplate::Entry* DescriptorUpdateTemplate::FindEntry(uint32_t binding) const {
+        auto it = std::ranges::find(entries, binding, &Entry::binding);
+        return (it != entries.end()) ? &(*it) : nullptr;
+    }
+
+    void DescriptorWriteBatcher::Write(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, const DescriptorData *data, uint32_t count) {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.dstArrayElement = arrayElement;
+        write.descriptorType = type;
+        write.descriptorCount = count;
+
+        switch (type) {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                write.pBufferInfo = &data->buffer;
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                //! Buffer views are strided by the DescriptorData size, the write wants them packed, so one write each
+                write.descriptorCount = 1;
+                for (uint32_t i = 0; i < count; ++i) {
+                    write.dstArrayElement = arrayElement + i;
+                    write.pTexelBufferView = &data[i].texelBuffer;
+                    m_writes.push_back(write);
+                }
+                return;
+            default:
+                write.pImageInfo = &data->image;
+                break;
+        }
+
+        m_writes.push_back(write);
+    }
+
+    void DescriptorWriteBatcher::Flush() {
+        if (m_writes.empty()) { return; }
+
+        vkUpdateDescriptorSets(m_device->Get(), static_cast<uint32_t>(m_writes.size()), m_writes.data(), 0, nullptr);
+        m_writes.clear();
+    }
+} // Shift::VK
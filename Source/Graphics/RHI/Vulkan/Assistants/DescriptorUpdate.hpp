@@ -0,0 +1,61 @@
+#ifndef SHIFT_DESCRIPTORUPDATE_HPP
+#define SHIFT_DESCRIPTORUPDATE_HPP
+
+#include <vector>
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+
+namespace Shift::VK {
+    //! One descriptor worth of update data. Update templates read these tightly packed, so a whole set is one array
+    union DescriptorData {
+        VkDescriptorImageInfo image;
+        VkDescriptorBufferInfo buffer;
+        VkBufferView texelBuffer;
+    };
+    //! Arrays of DescriptorData double as image/buffer info arrays for plain writes
+    static_assert(sizeof(DescriptorData) == sizeof(VkDescriptorImageInfo) && sizeof(DescriptorData) == sizeof(VkDescriptorBufferInfo));
+
+    //! Update template of a set layout, built by the DescriptorLayoutCache together with the layout.
+    //! Every descriptor of the layout has a slot in a DescriptorData array, bindings are packed in binding order.
+    //! Layouts a template can't write (bindless, partially bound) have no handle, only the entries describing the bindings.
+    struct DescriptorUpdateTemplate {
+        struct Entry {
+            uint32_t binding;
+            VkDescriptorType type;
+            uint32_t firstSlot;
+            uint32_t count;
+        };
+
+        VkDescriptorUpdateTemplate handle = VK_NULL_HANDLE;
+        std::vector<Entry> entries;
+        uint32_t slotCount = 0;
+
+        //! \return nullptr if the layout has no such binding
+        [[nodiscard]] const Entry* FindEntry(uint32_t binding) const;
+
+        [[nodiscard]] bool IsValid() const { return handle != VK_NULL_HANDLE; }
+    };
+
+    //! Collects descriptor writes of any number of sets and submits them in one vkUpdateDescriptorSets call.
+    //! The infos the writes point to have to stay alive until Flush.
+    class DescriptorWriteBatcher {
+    public:
+        void Init(const Device* device) { m_device = device; }
+
+        //! Queue a write of count descriptors starting at arrayElement
+        //! \param data count packed descriptors
+        void Write(VkDescriptorSet set, uint32_t binding, uint32_t arrayElement, VkDescriptorType type, const DescriptorData* data, uint32_t count = 1);
+
+        //! Write everything queued in one call
+        void Flush();
+
+        [[nodiscard]] uint32_t GetPendingCount() const { return static_cast<uint32_t>(m_writes.size()); }
+
+        ~DescriptorWriteBatcher() = default;
+    private:
+        const Device* m_device = nullptr;
+        std::vector<VkWriteDescriptorSet> m_writes;
+    };
+} // Shift::VK
+
+#endif //SHIFT_DESCRIPTORUPDATE_HPP
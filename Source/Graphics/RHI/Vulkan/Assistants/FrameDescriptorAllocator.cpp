@@ -0,0 +1,131 @@
+#include "FrameDescriptorAllocator.hpp"
+
+#include <algorithm>
+
+namespace Shift::VK {
+    namespace {
+        struct PoolSizeRatio {
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        //! Transient sets are mostly per draw uniforms and material textures, but every binding type a set can have gets
+        //! some room, a type without any can never be allocated from the pool however often it regrows
+        constexpr std::array<PoolSizeRatio, 11> TRANSIENT_SIZE_CONFIG{{
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.f },
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.f },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.f },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 0.25f },
+                { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.f },
+                { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4.f },
+                { VK_DESCRIPTOR_TYPE_SAMPLER, 1.f },
+                { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0.5f },
+                { VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 0.25f },
+                { VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 0.25f },
+                { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.25f },
+        }};
+    }
+
+    bool FrameDescriptorAllocator::Init(const Device *device, uint32_t initialSets) {
+        m_device = device;
+
+        for (auto& frame: m_frames) {
+            frame.pool = CreatePool(initialSets);
+            if (frame.pool == VK_NULL_HANDLE) { return false; }
+            frame.capacity = initialSets;
+        }
+        m_stats.poolCapacity = initialSets;
+
+        return true;
+    }
+
+    void FrameDescriptorAllocator::BeginFrame(uint32_t frameIdx) {
+        m_currentFrame = frameIdx;
+        FramePools& frame = m_frames[m_currentFrame];
+
+        m_stats.setsAllocated = frame.setsAllocated;
+        m_stats.poolsUsed = 1 + static_cast<uint32_t>(frame.overflow.size());
+
+        if (frame.overflow.empty()) {
+            m_device->ResetDescriptorPool(frame.pool);
+        } else {
+            //! Outgrown, one pool with headroom over the observed usage so steady state stays at a single reset
+            for (auto pool: frame.overflow) {
+                m_device->DestroyDescriptorPool(pool);
+            }
+            frame.overflow.clear();
+            m_device->DestroyDescriptorPool(frame.pool);
+
+            frame.capacity = std::max(frame.capacity * 2u, frame.setsAllocated + frame.setsAllocated / 2u);
+            frame.pool = CreatePool(frame.capacity);
+            ++m_stats.regrowCount;
+        }
+
+        m_stats.poolCapacity = frame.capacity;
+        frame.setsAllocated = 0;
+    }
+
+    VkDescriptorSet FrameDescriptorAllocator::Allocate(VkDescriptorSetLayout layout) {
+        FramePools& frame = m_frames[m_currentFrame];
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = (frame.overflow.empty()) ? frame.pool : frame.overflow.back();
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+
+        VkResult result;
+        VkDescriptorSet set = m_device->AllocateDescriptorSet(allocInfo, &result);
+
+        //! Out of sets or of one descriptor type, keep the frame going from a new pool and regrow at the next reset
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+            VkDescriptorPool overflowPool = CreatePool(frame.capacity);
+            if (overflowPool == VK_NULL_HANDLE) { return VK_NULL_HANDLE; }
+
+            allocInfo.descriptorPool = overflowPool;
+            set = m_device->AllocateDescriptorSet(allocInfo, &result);
+            //! A set that doesn't fit a fresh pool won't fit the next one either, keeping it would only leak pools
+            if (VkCheck(result)) {
+                m_device->DestroyDescriptorPool(overflowPool);
+            } else {
+                frame.overflow.push_back(overflowPool);
+            }
+        }
+
+        if (VkCheck(result)) {
+            Log(Error, "Error allocating a transient descriptor set");
+            return VK_NULL_HANDLE;
+        }
+
+        ++frame.setsAllocated;
+        return set;
+    }
+
+    void FrameDescriptorAllocator::Destroy() {
+        for (auto& frame: m_frames) {
+            for (auto pool: frame.overflow) {
+                m_device->DestroyDescriptorPool(pool);
+            }
+            frame.overflow.clear();
+            m_device->DestroyDescriptorPool(frame.pool);
+            frame.pool = VK_NULL_HANDLE;
+        }
+    }
+
+    VkDescriptorPool FrameDescriptorAllocator::CreatePool(uint32_t setCount) const {
+        std::array<VkDescriptorPoolSize, TRANSIENT_SIZE_CONFIG.size()> poolSizes{};
+        for (size_t i = 0; i < TRANSIENT_SIZE_CONFIG.size(); ++i) {
+            poolSizes[i].type = TRANSIENT_SIZE_CONFIG[i].type;
+            poolSizes[i].descriptorCount = std::max(1u, static_cast<uint32_t>(TRANSIENT_SIZE_CONFIG[i].ratio * static_cast<float>(setCount)));
+        }
+
+        //! No FREE_DESCRIPTOR_SET flag, sets only ever go away with the whole pool
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = setCount;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+
+        return m_device->CreateDescriptorPool(poolInfo);
+    }
+} // Shift::VK
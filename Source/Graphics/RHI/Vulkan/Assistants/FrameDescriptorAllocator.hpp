@@ -0,0 +1,60 @@
+#ifndef SHIFT_FRAMEDESCRIPTORALLOCATOR_HPP
+#define SHIFT_FRAMEDESCRIPTORALLOCATOR_HPP
+
+#include <array>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/ResourceSet.hpp"
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+
+namespace Shift::VK {
+    //! Linear allocator for descriptor sets that live for one frame (per draw/per pass data).
+    //! Every frame in flight has its own pool, sets are never freed one by one, the whole pool is reset with a single
+    //! vkResetDescriptorPool once the frame fence has signaled. A frame that runs out of its pool keeps going from
+    //! overflow pools, then the next time that frame slot begins its pool is recreated big enough for what was used.
+    //! Main thread only.
+    class FrameDescriptorAllocator {
+    public:
+        //! Create a pool per frame in flight
+        //! \param device Device wrapper ptr
+        //! \param initialSets sets the frame pools fit at the start
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, uint32_t initialSets);
+
+        //! Reset the pool of the frame, has to be called after its fence has signaled
+        //! \param frameIdx current frame in flight
+        void BeginFrame(uint32_t frameIdx);
+
+        //! Allocate a set valid until this frame slot begins again
+        //! \param layout descriptor layout
+        //! \return allocated set, VK_NULL_HANDLE if there was an error
+        [[nodiscard]] VkDescriptorSet Allocate(VkDescriptorSetLayout layout);
+
+        //! Numbers of the last frame that was reset
+        [[nodiscard]] const TransientSetStats& GetStats() const { return m_stats; }
+
+        void Destroy();
+        ~FrameDescriptorAllocator() = default;
+    private:
+        struct FramePools {
+            VkDescriptorPool pool = VK_NULL_HANDLE;
+            uint32_t capacity = 0;
+            //! Only filled when the frame outgrew its pool
+            std::vector<VkDescriptorPool> overflow;
+            uint32_t setsAllocated = 0;
+        };
+
+        //! Pool for setCount sets, descriptor counts are scaled from the transient usage ratios
+        [[nodiscard]] VkDescriptorPool CreatePool(uint32_t setCount) const;
+
+        const Device* m_device = nullptr;
+
+        std::array<FramePools, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> m_frames;
+        uint32_t m_currentFrame = 0;
+        TransientSetStats m_stats{};
+    };
+} // Shift::VK
+
+#endif //SHIFT_FRAMEDESCRIPTORALLOCATOR_HPP
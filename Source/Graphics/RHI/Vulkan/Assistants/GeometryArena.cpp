@@ -0,0 +1,121 @@
+#include "GeometryArena.hpp"
+
+namespace Shift::VK {
+    bool GeometryArena::Init(const Device *device, uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity) {
+        m_vertexStride = vertexStride;
+        m_vertexCapacity = vertexCapacity;
+        m_indexCapacity = indexCapacity;
+
+        m_vertexBuffer.Init(device, BufferDescriptor{
+            .size = static_cast<uint64_t>(vertexStride) * vertexCapacity,
+            .name = "GeometryArenaVertices",
+            .type = EBufferType::Vertex
+        });
+        m_indexBuffer.Init(device, BufferDescriptor{
+            .size = static_cast<uint64_t>(sizeof(uint32_t)) * indexCapacity,
+            .name = "GeometryArenaIndices",
+            .type = EBufferType::Index
+        });
+        if (!m_vertexBuffer.IsValid() || !m_indexBuffer.IsValid()) {
+            Log(Error, "Failed to create the geometry arena buffers");
+            return false;
+        }
+
+        VmaVirtualBlockCreateInfo blockInfo{};
+        blockInfo.size = vertexCapacity;
+        if (VkCheck(vmaCreateVirtualBlock(&blockInfo, &m_vertexBlock))) {
+            Log(Error, "Failed to create the geometry arena vertex block");
+            return false;
+        }
+        blockInfo.size = indexCapacity;
+        if (VkCheck(vmaCreateVirtualBlock(&blockInfo, &m_indexBlock))) {
+            Log(Error, "Failed to create the geometry arena index block");
+            return false;
+        }
+
+        return true;
+    }
+
+    MeshHandle GeometryArena::Allocate(uint32_t vertexCount, uint32_t indexCount) {
+        if (vertexCount == 0) {
+            Log(Error, "A mesh needs at least one vertex");
+            return {};
+        }
+
+        Mesh mesh{};
+        VkDeviceSize offset = 0;
+
+        VmaVirtualAllocationCreateInfo allocInfo{};
+        allocInfo.size = vertexCount;
+        VkResult res = vmaVirtualAllocate(m_vertexBlock, &allocInfo, &mesh.allocation.vertices, &offset);
+        mesh.range.vertexOffset = static_cast<int32_t>(offset);
+        mesh.range.vertexCount = vertexCount;
+
+        if (res == VK_SUCCESS && indexCount > 0) {
+            allocInfo.size = indexCount;
+            res = vmaVirtualAllocate(m_indexBlock, &allocInfo, &mesh.allocation.indices, &offset);
+            mesh.range.firstIndex = static_cast<uint32_t>(offset);
+            mesh.range.indexCount = indexCount;
+        }
+
+        if (res != VK_SUCCESS) {
+            if (!m_fullReported) {
+                Log(Warning, "Geometry arena is out of space ({} vertices, {} indices), raise its Conf::SHIFT_GEOMETRY_* sizes", m_vertexCapacity, m_indexCapacity);
+                m_fullReported = true;
+            }
+            Free(mesh.allocation);
+            return {};
+        }
+
+        return m_meshes.Insert(std::move(mesh));
+    }
+
+    const MeshRange* GeometryArena::Get(MeshHandle handle) const {
+        const Mesh* mesh = m_meshes.Get(handle);
+        return (mesh != nullptr) ? &mesh->range : nullptr;
+    }
+
+    std::optional<GeometryArena::Allocation> GeometryArena::Remove(MeshHandle handle) {
+        std::optional<Mesh> mesh = m_meshes.Remove(handle);
+        if (!mesh.has_value()) { return std::nullopt; }
+        return mesh->allocation;
+    }
+
+    void GeometryArena::Free(const Allocation &allocation) {
+        //! Null allocations are ignored by VMA
+        vmaVirtualFree(m_vertexBlock, allocation.vertices);
+        vmaVirtualFree(m_indexBlock, allocation.indices);
+    }
+
+    GeometryArenaStats GeometryArena::GetStats() const {
+        VmaStatistics vertexStats{};
+        VmaStatistics indexStats{};
+        vmaGetVirtualBlockStatistics(m_vertexBlock, &vertexStats);
+        vmaGetVirtualBlockStatistics(m_indexBlock, &indexStats);
+
+        return {
+            .meshCount = m_meshes.GetCount(),
+            .usedVertices = vertexStats.allocationBytes,
+            .vertexCapacity = m_vertexCapacity,
+            .usedIndices = indexStats.allocationBytes,
+            .indexCapacity = m_indexCapacity
+        };
+    }
+
+    void GeometryArena::Destroy() {
+        for (VmaVirtualBlock block: {m_vertexBlock, m_indexBlock}) {
+            if (block != VK_NULL_HANDLE) {
+                vmaClearVirtualBlock(block);
+                vmaDestroyVirtualBlock(block);
+            }
+        }
+        m_vertexBlock = VK_NULL_HANDLE;
+        m_indexBlock = VK_NULL_HANDLE;
+        m_meshes.Clear();
+
+        if (m_vertexBuffer.IsValid()) { m_vertexBuffer.Destroy(); }
+        if (m_indexBuffer.IsValid()) { m_indexBuffer.Destroy(); }
+        m_vertexBuffer = {};
+        m_indexBuffer = {};
+    }
+} // Shift::VK
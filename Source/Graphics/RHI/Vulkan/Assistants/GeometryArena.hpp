@@ -0,0 +1,75 @@
+#ifndef SHIFT_GEOMETRYARENA_HPP
+#define SHIFT_GEOMETRYARENA_HPP
+
+#include <optional>
+
+#include "Graphics/RHI/Handle.hpp"
+#include "Graphics/RHI/CommandBuffer.hpp"
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKBuffer.hpp"
+
+namespace Shift::VK {
+    //! One device local vertex buffer and one index buffer shared by every mesh, suballocated through VMA virtual blocks.
+    //! The blocks count vertices and indices instead of bytes, so the offsets they give out are the vertexOffset and
+    //! firstIndex of the draw as is, and any vertex stride works without power of two alignment. Main thread only.
+    class GeometryArena {
+    public:
+        //! Ranges of a mesh in the virtual blocks
+        struct Allocation {
+            VmaVirtualAllocation vertices = VK_NULL_HANDLE;
+            VmaVirtualAllocation indices = VK_NULL_HANDLE;
+        };
+
+        //! Create the buffers and their blocks
+        //! \param device Device wrapper ptr
+        //! \param vertexStride bytes per vertex
+        //! \param vertexCapacity vertices the arena fits
+        //! \param indexCapacity 32 bit indices the arena fits
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity);
+
+        //! Reserve the ranges of a mesh, the data is uploaded by the caller
+        //! \param vertexCount vertices of the mesh, more than 0
+        //! \param indexCount indices of the mesh, 0 for non indexed meshes
+        //! \return invalid handle if the arena is out of space
+        [[nodiscard]] MeshHandle Allocate(uint32_t vertexCount, uint32_t indexCount);
+
+        //! \return nullptr if the handle is stale
+        [[nodiscard]] const MeshRange* Get(MeshHandle handle) const;
+
+        //! Retire the handle, the ranges stay reserved until Free since frames in flight may still draw from them
+        //! \return the ranges to Free, std::nullopt if the handle is stale
+        [[nodiscard]] std::optional<Allocation> Remove(MeshHandle handle);
+        void Free(const Allocation& allocation);
+
+        [[nodiscard]] Buffer& GetVertexBuffer() { return m_vertexBuffer; }
+        [[nodiscard]] Buffer& GetIndexBuffer() { return m_indexBuffer; }
+        [[nodiscard]] const Buffer& GetVertexBuffer() const { return m_vertexBuffer; }
+        [[nodiscard]] const Buffer& GetIndexBuffer() const { return m_indexBuffer; }
+        [[nodiscard]] uint32_t GetVertexStride() const { return m_vertexStride; }
+
+        [[nodiscard]] GeometryArenaStats GetStats() const;
+
+        void Destroy();
+        ~GeometryArena() = default;
+    private:
+        struct Mesh {
+            MeshRange range;
+            Allocation allocation;
+        };
+
+        Buffer m_vertexBuffer;
+        Buffer m_indexBuffer;
+        VmaVirtualBlock m_vertexBlock = VK_NULL_HANDLE;
+        VmaVirtualBlock m_indexBlock = VK_NULL_HANDLE;
+
+        HandlePool<Mesh, MeshRange> m_meshes;
+
+        uint32_t m_vertexStride = 0;
+        uint32_t m_vertexCapacity = 0;
+        uint32_t m_indexCapacity = 0;
+        bool m_fullReported = false;
+    };
+} // Shift::VK
+
+#endif //SHIFT_GEOMETRYARENA_HPP
@@ -0,0 +1,141 @@
+#include "GpuProfiler.hpp"
+
+#include <utility>
+
+namespace Shift::VK {
+    bool GpuProfiler::Init(const Device *device) {
+        m_device = device;
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_device->GetPhysicalDevice(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_device->GetPhysicalDevice(), &familyCount, families.data());
+
+        uint32_t validBits = families[m_device->GetQueueFamilyIndices().graphicsFamily.value()].timestampValidBits;
+        if (validBits == 0) {
+            Log(Warning, "Graphics queue has no timestamps, GPU timers are disabled");
+            return true;
+        }
+        m_timestampMask = (validBits >= 64) ? UINT64_MAX : (1ull << validBits) - 1;
+        m_msPerTick = static_cast<double>(m_device->GetDeviceProperties().limits.timestampPeriod) / 1e6;
+
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = Conf::SHIFT_GPU_TIMER_COUNT * 2;
+
+        for (auto& frame: m_frames) {
+            frame.pool = m_device->CreateQueryPool(poolInfo);
+            if (frame.pool == VK_NULL_HANDLE) { return false; }
+            frame.timers.reserve(Conf::SHIFT_GPU_TIMER_COUNT);
+        }
+        m_timestamps.resize(Conf::SHIFT_GPU_TIMER_COUNT * 2);
+
+        return true;
+    }
+
+    void GpuProfiler::BeginFrame(uint32_t frameIdx, const CommandBuffer &cmd) {
+        m_frameIdx = frameIdx;
+        m_cmd = &cmd;
+        m_openTimers.clear();
+
+        FrameQueries& frame = m_frames[m_frameIdx];
+        if (frame.pool == VK_NULL_HANDLE) { return; }
+
+        if (frame.isRecorded) {
+            Resolve(frame);
+        }
+        frame.timers.clear();
+        frame.isRecorded = false;
+
+        //! Vulkan 1.2 core has host query resets, but the frame buffer is right here and it keeps the reset ordered
+        cmd.VK_ResetQueryPool(frame.pool, 0, Conf::SHIFT_GPU_TIMER_COUNT * 2);
+        BeginTimer("Frame");
+    }
+
+    void GpuProfiler::EndFrame() {
+        FrameQueries& frame = m_frames[m_frameIdx];
+        if (frame.pool == VK_NULL_HANDLE || m_cmd == nullptr) { return; }
+
+        if (m_openTimers.size() > 1) {
+            Log(Warning, "{} GPU timer scopes were left open at the end of the frame", m_openTimers.size() - 1);
+        }
+        while (!m_openTimers.empty()) {
+            EndTimer();
+        }
+
+        frame.isRecorded = true;
+        m_cmd = nullptr;
+    }
+
+    void GpuProfiler::BeginTimer(const char *name) {
+        FrameQueries& frame = m_frames[m_frameIdx];
+        if (frame.pool == VK_NULL_HANDLE || m_cmd == nullptr) { return; }
+
+        //! Scopes past the limit are still pushed, so their EndTimer pops the right one, they just don't get a query
+        uint32_t timerIdx = UINT32_MAX;
+        if (frame.timers.size() < Conf::SHIFT_GPU_TIMER_COUNT) {
+            timerIdx = static_cast<uint32_t>(frame.timers.size());
+            frame.timers.push_back({.name = name, .depth = static_cast<uint32_t>(m_openTimers.size()), .query = timerIdx * 2});
+            m_cmd->VK_WriteTimestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.pool, timerIdx * 2);
+        } else if (!m_overflowReported) {
+            Log(Warning, "Out of GPU timers ({} per frame), raise Conf::SHIFT_GPU_TIMER_COUNT", Conf::SHIFT_GPU_TIMER_COUNT);
+            m_overflowReported = true;
+        }
+        m_openTimers.push_back(timerIdx);
+    }
+
+    void GpuProfiler::EndTimer() {
+        FrameQueries& frame = m_frames[m_frameIdx];
+        if (frame.pool == VK_NULL_HANDLE || m_cmd == nullptr || m_openTimers.empty()) { return; }
+
+        uint32_t timerIdx = m_openTimers.back();
+        m_openTimers.pop_back();
+        if (timerIdx == UINT32_MAX) { return; }
+
+        m_cmd->VK_WriteTimestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.pool, frame.timers[timerIdx].query + 1);
+    }
+
+    void GpuProfiler::Resolve(FrameQueries &frame) {
+        if (frame.timers.empty()) { return; }
+
+        //! No WAIT bit, the fence of the slot has signaled, so anything that isn't there now never will be
+        auto queryCount = static_cast<uint32_t>(frame.timers.size() * 2);
+        VkResult res = vkGetQueryPoolResults(m_device->Get(), frame.pool, 0, queryCount, queryCount * sizeof(uint64_t),
+                                             m_timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (res != VK_SUCCESS) { return; }
+
+        auto toMs = [this](const Timer& timer) {
+            uint64_t ticks = (m_timestamps[timer.query + 1] - m_timestamps[timer.query]) & m_timestampMask;
+            return static_cast<float>(static_cast<double>(ticks) * m_msPerTick);
+        };
+
+        m_frameTimeMs = toMs(frame.timers.front());
+        m_results.clear();
+        for (size_t i = 1; i < frame.timers.size(); ++i) {
+            const Timer& timer = frame.timers[i];
+            m_results.push_back({.name = timer.name, .ms = toMs(timer), .depth = timer.depth - 1});
+        }
+        m_hasNewResults = true;
+    }
+
+    bool GpuProfiler::TakeResults(std::vector<GpuTimerResult> *out) {
+        if (!m_hasNewResults) { return false; }
+
+        std::swap(*out, m_results);
+        m_hasNewResults = false;
+        return true;
+    }
+
+    void GpuProfiler::Destroy() {
+        for (auto& frame: m_frames) {
+            if (frame.pool != VK_NULL_HANDLE) {
+                m_device->DestroyQueryPool(frame.pool);
+            }
+            frame = {};
+        }
+        m_openTimers.clear();
+        m_results.clear();
+        m_hasNewResults = false;
+    }
+} // Shift::VK
@@ -0,0 +1,85 @@
+#ifndef SHIFT_GPUPROFILER_HPP
+#define SHIFT_GPUPROFILER_HPP
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
+
+namespace Shift::VK {
+    //! GPU timer scopes of the frame command buffer, a timestamp query pool per frame in flight.
+    //! The whole frame is a timer of its own, the scopes are nested in it. A slot is read back when the frame comes
+    //! around to it again, its fence has signaled by then, so the readback never waits on the GPU. The results are
+    //! SHIFT_MAX_FRAMES_IN_FLIGHT frames old. Main thread only, worker buffers are not timed.
+    class GpuProfiler {
+    public:
+        //! \param device Device wrapper ptr
+        //! \return false if failed, timers are no-ops if the graphics queue has no timestamps
+        [[nodiscard]] bool Init(const Device* device);
+
+        //! Read back what the slot recorded last time, reset its pool and start the frame timer
+        //! \param frameIdx current frame in flight, its fence has to have signaled
+        //! \param cmd the frame buffer that was just begun
+        void BeginFrame(uint32_t frameIdx, const CommandBuffer& cmd);
+
+        //! Close the scopes still open and the frame timer, the slot is resolved next time it begins
+        void EndFrame();
+
+        //! Open a scope, it's timed from when the commands before it are done
+        //! \param name scope name, copied
+        void BeginTimer(const char* name);
+        //! Close the innermost open scope
+        void EndTimer();
+
+        //! Swap the scopes of the last resolved frame, in the order they were opened, into out. The vector handed in is
+        //! filled by the next resolve, so nothing is copied or allocated per frame
+        //! \param out receives the results, left alone if no frame was resolved since the last take
+        //! \return false if there was nothing new
+        bool TakeResults(std::vector<GpuTimerResult>* out);
+        //! GPU time of the last resolved frame, from the first to the last command of the frame buffer
+        [[nodiscard]] float GetFrameTimeMs() const { return m_frameTimeMs; }
+
+        void Destroy();
+        ~GpuProfiler() = default;
+    private:
+        struct Timer {
+            std::string name;
+            uint32_t depth = 0;
+            //! The end query is begin + 1
+            uint32_t query = 0;
+        };
+
+        struct FrameQueries {
+            VkQueryPool pool = VK_NULL_HANDLE;
+            std::vector<Timer> timers;
+            //! Set once the frame ended, a frame that was begun but never ended has nothing to read
+            bool isRecorded = false;
+        };
+
+        //! Turn the timestamps of the slot into results, keeps the old ones if they are not there
+        void Resolve(FrameQueries& frame);
+
+        const Device* m_device = nullptr;
+        const CommandBuffer* m_cmd = nullptr;
+
+        std::array<FrameQueries, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> m_frames{};
+        uint32_t m_frameIdx = 0;
+        //! Indices into the timers of the current frame, the frame timer is the first
+        std::vector<uint32_t> m_openTimers;
+
+        std::vector<uint64_t> m_timestamps;
+        std::vector<GpuTimerResult> m_results;
+        bool m_hasNewResults = false;
+        float m_frameTimeMs = 0.0f;
+
+        double m_msPerTick = 0.0;
+        uint64_t m_timestampMask = 0;
+        bool m_overflowReported = false;
+    };
+} // Shift::VK
+
+#endif //SHIFT_GPUPROFILER_HPP
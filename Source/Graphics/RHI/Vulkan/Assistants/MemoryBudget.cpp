@@ -0,0 +1,75 @@
+#include "MemoryBudget.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "Config/EngineConfig.hpp"
+
+namespace Shift::VK {
+    void MemoryBudget::Init(const Device *device) {
+        m_device = device;
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(m_device->GetAllocator(), &memoryProperties);
+
+        m_heaps.resize(memoryProperties->memoryHeapCount);
+        for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i) {
+            m_heaps[i].isDeviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        }
+
+        if (!m_device->HasMemoryBudget()) {
+            Log(Warning, "VK_EXT_memory_budget is not supported, memory budgets are estimated from the heap sizes");
+        }
+    }
+
+    void MemoryBudget::BeginFrame(uint64_t frame) {
+        //! Also what makes VMA fetch the budget from the driver again
+        vmaSetCurrentFrameIndex(m_device->GetAllocator(), static_cast<uint32_t>(frame));
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+        vmaGetHeapBudgets(m_device->GetAllocator(), budgets.data());
+
+        float worstRatio = 0.0f;
+        uint32_t worstHeap = 0;
+        m_excess = 0;
+        for (uint32_t i = 0; i < m_heaps.size(); ++i) {
+            MemoryHeapBudget& heap = m_heaps[i];
+            heap.usage = budgets[i].usage;
+            heap.budget = budgets[i].budget;
+            heap.allocated = budgets[i].statistics.blockBytes;
+            if (!heap.isDeviceLocal || heap.budget == 0) { continue; }
+
+            float ratio = static_cast<float>(heap.usage) / static_cast<float>(heap.budget);
+            if (ratio > worstRatio) {
+                worstRatio = ratio;
+                worstHeap = i;
+            }
+
+            auto highMark = static_cast<uint64_t>(static_cast<double>(heap.budget) * Conf::SHIFT_MEMORY_BUDGET_HIGH);
+            if (heap.usage > highMark) {
+                m_excess = std::max(m_excess, heap.usage - highMark);
+            }
+        }
+
+        EMemoryPressure pressure = EMemoryPressure::None;
+        if (worstRatio >= Conf::SHIFT_MEMORY_BUDGET_CRITICAL) {
+            pressure = EMemoryPressure::Critical;
+        } else if (worstRatio >= Conf::SHIFT_MEMORY_BUDGET_HIGH) {
+            pressure = EMemoryPressure::High;
+        }
+
+        //! Only the rises are worth a line, it can sit at the same level for a long time
+        if (pressure > m_pressure) {
+            Log(Warning, "GPU memory pressure went {}: heap {} uses {} MiB of its {} MiB budget", (pressure == EMemoryPressure::Critical) ? "critical" : "high",
+                worstHeap, m_heaps[worstHeap].usage >> 20, m_heaps[worstHeap].budget >> 20);
+        }
+        m_pressure = pressure;
+    }
+
+    void MemoryBudget::Destroy() {
+        m_heaps.clear();
+        m_pressure = EMemoryPressure::None;
+        m_excess = 0;
+        m_device = nullptr;
+    }
+} // Shift::VK
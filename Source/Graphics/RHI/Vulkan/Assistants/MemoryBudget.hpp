@@ -0,0 +1,39 @@
+#ifndef SHIFT_MEMORYBUDGET_HPP
+#define SHIFT_MEMORYBUDGET_HPP
+
+#include <span>
+#include <vector>
+
+#include "Graphics/RHI/CommandBuffer.hpp"
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+
+namespace Shift::VK {
+    //! Per heap usage against the budget, read from VMA once per frame. With VK_EXT_memory_budget the budget is what the
+    //! driver gives the process right now (other applications shrink it), without it VMA estimates it from the heap size.
+    //! Only device local heaps count towards the pressure, running out of host memory is not something textures fix.
+    class MemoryBudget {
+    public:
+        //! \param device Device wrapper ptr
+        void Init(const Device* device);
+
+        //! Let VMA refresh the budget and read every heap
+        //! \param frame number of the frame that is being recorded now
+        void BeginFrame(uint64_t frame);
+
+        [[nodiscard]] std::span<const MemoryHeapBudget> GetHeaps() const { return m_heaps; }
+        [[nodiscard]] EMemoryPressure GetPressure() const { return m_pressure; }
+        //! Bytes the fullest device local heap is over the High threshold, 0 if it's under it
+        [[nodiscard]] uint64_t GetExcess() const { return m_excess; }
+
+        void Destroy();
+        ~MemoryBudget() = default;
+    private:
+        const Device* m_device = nullptr;
+
+        std::vector<MemoryHeapBudget> m_heaps;
+        EMemoryPressure m_pressure = EMemoryPressure::None;
+        uint64_t m_excess = 0;
+    };
+} // Shift::VK
+
+#endif //SHIFT_MEMORYBUDGET_HPP
@@ -0,0 +1,90 @@
+#include "ParallelRecorder.hpp"
+
+#include <cassert>
+
+namespace Shift::VK {
+    bool ParallelRecorder::Init(const Device *device, const Instance *ins, CommandPoolStorage *pools) {
+        m_device = device;
+        m_instance = ins;
+        m_pools = pools;
+
+        m_workers.resize(m_pools->GetWorkerCount());
+        for (uint32_t worker = 0; worker < m_pools->GetWorkerCount(); ++worker) {
+            for (uint32_t frame = 0; frame < Conf::SHIFT_MAX_FRAMES_IN_FLIGHT; ++frame) {
+                if (m_pools->GetWorker(worker, frame) == VK_NULL_HANDLE) {
+                    Log(Error, "Missing command pool for recording worker {}!", worker);
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void ParallelRecorder::BeginFrame(uint32_t frameIdx) {
+        m_currentFrame = frameIdx;
+        m_pools->ResetWorkerPools(m_currentFrame);
+
+        for (auto& frames: m_workers) {
+            frames[m_currentFrame].usedSecondaries = 0;
+            frames[m_currentFrame].usedPrimaries = 0;
+        }
+    }
+
+    CommandBuffer* ParallelRecorder::BeginSecondary(uint32_t workerIdx, const VkCommandBufferInheritanceRenderingInfoKHR &renderingInfo) {
+        assert(workerIdx < m_workers.size());
+
+        WorkerFrame& frame = m_workers[workerIdx][m_currentFrame];
+        CommandBuffer* cmd = NextBuffer(frame.secondaries, &frame.usedSecondaries, m_pools->GetWorker(workerIdx, m_currentFrame), ECommandBufferLevel::Secondary);
+        if (cmd == nullptr || !cmd->VK_BeginSecondary(renderingInfo)) { return nullptr; }
+
+        return cmd;
+    }
+
+    CommandBuffer* ParallelRecorder::BeginPrimary(uint32_t workerIdx) {
+        assert(workerIdx < m_workers.size());
+
+        WorkerFrame& frame = m_workers[workerIdx][m_currentFrame];
+        CommandBuffer* cmd = NextBuffer(frame.primaries, &frame.usedPrimaries, m_pools->GetWorker(workerIdx, m_currentFrame), ECommandBufferLevel::Primary);
+        //! The pool reset took care of the buffer, only the fence is left in whatever state
+        if (cmd == nullptr || !cmd->Begin()) { return nullptr; }
+
+        return cmd;
+    }
+
+    void ParallelRecorder::GatherPrimaries(std::vector<VkCommandBuffer> *outBuffers) const {
+        for (const auto& frames: m_workers) {
+            const WorkerFrame& frame = frames[m_currentFrame];
+            for (uint32_t i = 0; i < frame.usedPrimaries; ++i) {
+                outBuffers->push_back(frame.primaries[i].VK_Get());
+            }
+        }
+    }
+
+    CommandBuffer* ParallelRecorder::NextBuffer(std::deque<CommandBuffer>& buffers, uint32_t* used, VkCommandPool pool, ECommandBufferLevel level) {
+        if (*used == buffers.size()) {
+            CommandBuffer& cmd = buffers.emplace_back();
+            if (!cmd.Init(m_device, m_instance, pool, EPoolQueueType::Graphics, level)) {
+                Log(Error, "Failed to allocate a worker command buffer!");
+                buffers.pop_back();
+                return nullptr;
+            }
+        }
+
+        return &buffers[(*used)++];
+    }
+
+    void ParallelRecorder::Destroy() {
+        //! The buffers themselves go away with their pools
+        for (auto& frames: m_workers) {
+            for (auto& frame: frames) {
+                for (auto& cmd: frame.primaries) {
+                    cmd.Destroy();
+                }
+                frame.primaries.clear();
+                frame.secondaries.clear();
+            }
+        }
+        m_workers.clear();
+    }
+} // Shift::VK
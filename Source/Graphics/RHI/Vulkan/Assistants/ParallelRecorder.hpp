@@ -0,0 +1,72 @@
+#ifndef SHIFT_PARALLELRECORDER_HPP
+#define SHIFT_PARALLELRECORDER_HPP
+
+#include <array>
+#include <deque>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
+
+#include "CommandPoolStorage.hpp"
+
+namespace Shift::VK {
+    //! Hands out command buffers to recording workers from their own per frame pools.
+    //! A worker index belongs to a single thread during recording, so no locking is done. BeginFrame is called on the
+    //! main thread while no worker records. Buffers are cached and reused, the whole slot is recycled with one pool reset.
+    class ParallelRecorder {
+    public:
+        //! Initialize the recorder, the worker pools have to exist in the storage already
+        //! \param device Device wrapper ptr
+        //! \param ins Instance wrapper ptr
+        //! \param pools Pool storage with the worker pools
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, const Instance* ins, CommandPoolStorage* pools);
+
+        //! Recycle everything recorded in the frame slot, the previous frame in this slot has to be done on the GPU
+        //! \param frameIdx frame in flight index
+        void BeginFrame(uint32_t frameIdx);
+
+        //! Get a secondary buffer of the worker and begin it for the rendering pass with the given attachment formats
+        //! \param workerIdx recording worker index
+        //! \param renderingInfo attachment formats of the pass the buffer is executed in
+        //! \return begun command buffer, nullptr if failed. The pointer stays valid for the frame
+        [[nodiscard]] CommandBuffer* BeginSecondary(uint32_t workerIdx, const VkCommandBufferInheritanceRenderingInfoKHR& renderingInfo);
+
+        //! Get a primary buffer of the worker and begin it, it gets submitted together with the frame
+        //! \param workerIdx recording worker index
+        //! \return begun command buffer, nullptr if failed. The pointer stays valid for the frame
+        [[nodiscard]] CommandBuffer* BeginPrimary(uint32_t workerIdx);
+
+        //! Append the primaries recorded this frame, in worker order and per worker in begin order
+        //! \param outBuffers where to put them
+        void GatherPrimaries(std::vector<VkCommandBuffer>* outBuffers) const;
+
+        [[nodiscard]] uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        void Destroy();
+        ~ParallelRecorder() = default;
+    private:
+        struct WorkerFrame {
+            //! Deque so the handed out pointers survive growing
+            std::deque<CommandBuffer> secondaries;
+            std::deque<CommandBuffer> primaries;
+            uint32_t usedSecondaries = 0;
+            uint32_t usedPrimaries = 0;
+        };
+
+        //! Get the next free buffer of the list or allocate a new one
+        CommandBuffer* NextBuffer(std::deque<CommandBuffer>& buffers, uint32_t* used, VkCommandPool pool, ECommandBufferLevel level);
+
+        const Device* m_device = nullptr;
+        const Instance* m_instance = nullptr;
+        CommandPoolStorage* m_pools = nullptr;
+
+        std::vector<std::array<WorkerFrame, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT>> m_workers;
+        uint32_t m_currentFrame = 0;
+    };
+} // Shift::VK
+
+#endif //SHIFT_PARALLELRECORDER_HPP
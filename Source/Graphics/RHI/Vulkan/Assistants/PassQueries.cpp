@@ -0,0 +1,167 @@
+#include "PassQueries.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace Shift::VK {
+    bool PassQueries::Init(const Device *device) {
+        m_device = device;
+
+        const VkPhysicalDeviceFeatures& features = m_device->GetEnabledFeatures();
+        m_occlusionFlags = (features.occlusionQueryPrecise) ? VK_QUERY_CONTROL_PRECISE_BIT : 0;
+        if (!features.pipelineStatisticsQuery) {
+            Log(Warning, "No pipeline statistics queries on this device, passes only get occlusion counts");
+        }
+
+        VkQueryPoolCreateInfo statisticsInfo{};
+        statisticsInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        statisticsInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statisticsInfo.queryCount = Conf::SHIFT_GPU_PASS_QUERY_COUNT;
+        statisticsInfo.pipelineStatistics = STATISTIC_FLAGS;
+
+        VkQueryPoolCreateInfo occlusionInfo{};
+        occlusionInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        occlusionInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+        occlusionInfo.queryCount = Conf::SHIFT_GPU_PASS_QUERY_COUNT;
+
+        for (auto& frame: m_frames) {
+            if (features.pipelineStatisticsQuery) {
+                frame.statisticsPool = m_device->CreateQueryPool(statisticsInfo);
+                if (frame.statisticsPool == VK_NULL_HANDLE) { return false; }
+            }
+            frame.occlusionPool = m_device->CreateQueryPool(occlusionInfo);
+            if (frame.occlusionPool == VK_NULL_HANDLE) { return false; }
+            frame.passes.reserve(Conf::SHIFT_GPU_PASS_QUERY_COUNT);
+        }
+        m_statistics.resize(Conf::SHIFT_GPU_PASS_QUERY_COUNT * STATISTIC_COUNT);
+        m_samples.resize(Conf::SHIFT_GPU_PASS_QUERY_COUNT);
+
+        return true;
+    }
+
+    void PassQueries::BeginFrame(uint32_t frameIdx, const CommandBuffer &cmd) {
+        m_frameIdx = frameIdx;
+        m_cmd = &cmd;
+        m_openQuery = UINT32_MAX;
+
+        FrameQueries& frame = m_frames[m_frameIdx];
+        if (frame.occlusionPool == VK_NULL_HANDLE) { return; }
+
+        if (frame.isRecorded) {
+            Resolve(frame);
+        }
+        frame.passes.clear();
+        frame.isRecorded = false;
+
+        if (frame.statisticsPool != VK_NULL_HANDLE) {
+            cmd.VK_ResetQueryPool(frame.statisticsPool, 0, Conf::SHIFT_GPU_PASS_QUERY_COUNT);
+        }
+        cmd.VK_ResetQueryPool(frame.occlusionPool, 0, Conf::SHIFT_GPU_PASS_QUERY_COUNT);
+    }
+
+    void PassQueries::EndFrame() {
+        FrameQueries& frame = m_frames[m_frameIdx];
+        if (frame.occlusionPool == VK_NULL_HANDLE || m_cmd == nullptr) { return; }
+
+        if (m_openQuery != UINT32_MAX) {
+            Log(Warning, "Pass {} was still counted at the end of the frame", frame.passes[m_openQuery]);
+            EndPass();
+        }
+
+        frame.isRecorded = true;
+        m_cmd = nullptr;
+    }
+
+    void PassQueries::BeginPass(const char *name) {
+        FrameQueries& frame = m_frames[m_frameIdx];
+        if (frame.occlusionPool == VK_NULL_HANDLE || m_cmd == nullptr) { return; }
+
+        if (m_openQuery != UINT32_MAX) {
+            Log(Warning, "Pass {} is counted inside of {}, pass queries don't nest", name, frame.passes[m_openQuery]);
+            return;
+        }
+        if (frame.passes.size() >= Conf::SHIFT_GPU_PASS_QUERY_COUNT) {
+            if (!m_overflowReported) {
+                Log(Warning, "Out of pass queries ({} per frame), raise Conf::SHIFT_GPU_PASS_QUERY_COUNT", Conf::SHIFT_GPU_PASS_QUERY_COUNT);
+                m_overflowReported = true;
+            }
+            return;
+        }
+
+        m_openQuery = static_cast<uint32_t>(frame.passes.size());
+        frame.passes.emplace_back(name);
+
+        if (frame.statisticsPool != VK_NULL_HANDLE) {
+            m_cmd->VK_BeginQuery(frame.statisticsPool, m_openQuery, 0);
+        }
+        m_cmd->VK_BeginQuery(frame.occlusionPool, m_openQuery, m_occlusionFlags);
+    }
+
+    void PassQueries::EndPass() {
+        FrameQueries& frame = m_frames[m_frameIdx];
+        if (m_openQuery == UINT32_MAX || m_cmd == nullptr) { return; }
+
+        if (frame.statisticsPool != VK_NULL_HANDLE) {
+            m_cmd->VK_EndQuery(frame.statisticsPool, m_openQuery);
+        }
+        m_cmd->VK_EndQuery(frame.occlusionPool, m_openQuery);
+        m_openQuery = UINT32_MAX;
+    }
+
+    void PassQueries::Resolve(FrameQueries &frame) {
+        if (frame.passes.empty()) { return; }
+
+        //! No WAIT bit, the fence of the slot has signaled, so anything that isn't there now never will be
+        auto queryCount = static_cast<uint32_t>(frame.passes.size());
+        if (frame.statisticsPool != VK_NULL_HANDLE) {
+            VkResult res = vkGetQueryPoolResults(m_device->Get(), frame.statisticsPool, 0, queryCount,
+                                                 queryCount * STATISTIC_COUNT * sizeof(uint64_t), m_statistics.data(),
+                                                 STATISTIC_COUNT * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+            if (res != VK_SUCCESS) { return; }
+        }
+        VkResult res = vkGetQueryPoolResults(m_device->Get(), frame.occlusionPool, 0, queryCount, queryCount * sizeof(uint64_t),
+                                             m_samples.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (res != VK_SUCCESS) { return; }
+
+        m_results.clear();
+        for (uint32_t i = 0; i < queryCount; ++i) {
+            auto it = std::ranges::find(m_results, frame.passes[i], &PassStatistics::name);
+            PassStatistics& pass = (it != m_results.end()) ? *it : m_results.emplace_back(PassStatistics{.name = frame.passes[i]});
+
+            if (frame.statisticsPool != VK_NULL_HANDLE) {
+                const uint64_t* counters = &m_statistics[i * STATISTIC_COUNT];
+                pass.inputVertices += counters[0];
+                pass.inputPrimitives += counters[1];
+                pass.vertexInvocations += counters[2];
+                pass.clippingInvocations += counters[3];
+                pass.clippingPrimitives += counters[4];
+                pass.fragmentInvocations += counters[5];
+                pass.computeInvocations += counters[6];
+            }
+            pass.samplesPassed += m_samples[i];
+        }
+        m_hasNewResults = true;
+    }
+
+    bool PassQueries::TakeResults(std::vector<PassStatistics> *out) {
+        if (!m_hasNewResults) { return false; }
+
+        std::swap(*out, m_results);
+        m_hasNewResults = false;
+        return true;
+    }
+
+    void PassQueries::Destroy() {
+        for (auto& frame: m_frames) {
+            if (frame.statisticsPool != VK_NULL_HANDLE) {
+                m_device->DestroyQueryPool(frame.statisticsPool);
+            }
+            if (frame.occlusionPool != VK_NULL_HANDLE) {
+                m_device->DestroyQueryPool(frame.occlusionPool);
+            }
+            frame = {};
+        }
+        m_results.clear();
+        m_hasNewResults = false;
+    }
+} // Shift::VK
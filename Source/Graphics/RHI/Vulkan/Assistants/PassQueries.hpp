@@ -0,0 +1,87 @@
+#ifndef SHIFT_PASSQUERIES_HPP
+#define SHIFT_PASSQUERIES_HPP
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
+
+namespace Shift::VK {
+    //! Pipeline statistics and occlusion queries around passes of the frame command buffer, a pool of each per frame
+    //! in flight. Same lifecycle as the GPU timers: a slot is read back without waiting when the frame comes around to
+    //! it again. Queries of one type can't be nested in Vulkan, so only one pass scope can be open at a time.
+    //! Main thread only.
+    class PassQueries {
+    public:
+        //! \param device Device wrapper ptr
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device);
+
+        //! Read back what the slot recorded last time and reset its pools
+        //! \param frameIdx current frame in flight, its fence has to have signaled
+        //! \param cmd the frame buffer that was just begun
+        void BeginFrame(uint32_t frameIdx, const CommandBuffer& cmd);
+
+        //! Close the pass still open, the slot is resolved next time it begins
+        void EndFrame();
+
+        //! Start counting, has to be outside of a render pass (or begin and end in the same one)
+        //! \param name pass name, scopes of the same name are summed
+        void BeginPass(const char* name);
+        void EndPass();
+
+        //! Swap the passes of the last resolved frame, in the order they first ran, into out. The vector handed in is
+        //! filled by the next resolve
+        //! \param out receives the results, left alone if no frame was resolved since the last take
+        //! \return false if there was nothing new
+        bool TakeResults(std::vector<PassStatistics>* out);
+
+        void Destroy();
+        ~PassQueries() = default;
+    private:
+        //! 1:1 with the counters of PassStatistics and the order Vulkan writes them in (bit order)
+        static constexpr VkQueryPipelineStatisticFlags STATISTIC_FLAGS =
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+        static constexpr uint32_t STATISTIC_COUNT = 7;
+
+        struct FrameQueries {
+            //! VK_NULL_HANDLE without pipelineStatisticsQuery
+            VkQueryPool statisticsPool = VK_NULL_HANDLE;
+            VkQueryPool occlusionPool = VK_NULL_HANDLE;
+            //! Name of every query index
+            std::vector<std::string> passes;
+            bool isRecorded = false;
+        };
+
+        //! Turn the counters of the slot into results, keeps the old ones if they are not there
+        void Resolve(FrameQueries& frame);
+
+        const Device* m_device = nullptr;
+        const CommandBuffer* m_cmd = nullptr;
+
+        std::array<FrameQueries, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> m_frames{};
+        uint32_t m_frameIdx = 0;
+        //! Query index of the open pass, UINT32_MAX if none
+        uint32_t m_openQuery = UINT32_MAX;
+
+        std::vector<uint64_t> m_statistics;
+        std::vector<uint64_t> m_samples;
+        std::vector<PassStatistics> m_results;
+        bool m_hasNewResults = false;
+
+        VkQueryControlFlags m_occlusionFlags = 0;
+        bool m_overflowReported = false;
+    };
+} // Shift::VK
+
+#endif //SHIFT_PASSQUERIES_HPP
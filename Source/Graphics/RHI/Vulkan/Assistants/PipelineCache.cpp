@@ -0,0 +1,137 @@
+#include "PipelineCache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "Utility/UtilStandard.hpp"
+
+namespace Shift::VK {
+    bool PipelineCache::Init(const Device *device, const std::string &path) {
+        m_device = device;
+        m_path = path;
+
+        std::vector<char> fileData = Util::ReadFile(m_path);
+        m_isWarm = !fileData.empty() && Validate(fileData);
+        if (!fileData.empty() && !m_isWarm) {
+            Log(Warning, "Pipeline cache at {} is stale or corrupted, starting cold", m_path);
+        }
+
+        VkPipelineCacheCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        if (m_isWarm) {
+            info.initialDataSize = fileData.size() - sizeof(FileHeader);
+            info.pInitialData = fileData.data() + sizeof(FileHeader);
+        }
+
+        m_cache = m_device->CreatePipelineCache(info);
+        return VkNullCheck(m_cache);
+    }
+
+    bool PipelineCache::Save() const {
+        size_t dataSize = 0;
+        if ( VkCheck(vkGetPipelineCacheData(m_device->Get(), m_cache, &dataSize, nullptr)) ) {
+            Log(Error, "Failed to get the pipeline cache size!");
+            return false;
+        }
+
+        std::vector<char> data(dataSize);
+        if ( VkCheck(vkGetPipelineCacheData(m_device->Get(), m_cache, &dataSize, data.data())) ) {
+            Log(Error, "Failed to get the pipeline cache data!");
+            return false;
+        }
+
+        FileHeader header = MakeHeader(dataSize, Util::HashFNV1a(data.data(), dataSize));
+
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path{m_path}.parent_path(), ec);
+
+        std::string tmpPath = m_path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                Log(Error, "Failed to open {} for writing the pipeline cache!", tmpPath);
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+            file.write(data.data(), static_cast<std::streamsize>(dataSize));
+            if (!file.good()) {
+                Log(Error, "Failed to write the pipeline cache!");
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tmpPath, m_path, ec);
+        if (ec) {
+            Log(Error, "Failed to move the pipeline cache into place: {}", ec.message());
+            return false;
+        }
+
+        return true;
+    }
+
+    void PipelineCache::RecordCreation(double ms) {
+        std::lock_guard lock(m_statsMutex);
+        ++m_pipelineCount;
+        m_creationTimeMs += ms;
+    }
+
+    void PipelineCache::ReportStats() const {
+        std::lock_guard lock(m_statsMutex);
+        if (m_pipelineCount == 0) { return; }
+
+        Log(Info, "Pipeline cache ({} start): {} pipelines created in {:.3f} ms, {:.3f} ms avg",
+            (m_isWarm) ? "warm" : "cold",
+            m_pipelineCount,
+            m_creationTimeMs,
+            m_creationTimeMs / m_pipelineCount
+        );
+    }
+
+    PipelineCache::FileHeader PipelineCache::MakeHeader(uint64_t dataSize, uint64_t checksum) const {
+        VkPhysicalDeviceProperties props = m_device->GetDeviceProperties();
+
+        FileHeader header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.vendorID = props.vendorID;
+        header.deviceID = props.deviceID;
+        header.driverVersion = props.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+        header.dataSize = dataSize;
+        header.checksum = checksum;
+
+        return header;
+    }
+
+    bool PipelineCache::Validate(const std::vector<char> &fileData) const {
+        if (fileData.size() < sizeof(FileHeader) + sizeof(VkPipelineCacheHeaderVersionOne)) { return false; }
+
+        FileHeader header;
+        std::memcpy(&header, fileData.data(), sizeof(FileHeader));
+        const char* blob = fileData.data() + sizeof(FileHeader);
+        uint64_t blobSize = fileData.size() - sizeof(FileHeader);
+
+        FileHeader expected = MakeHeader(blobSize, Util::HashFNV1a(blob, blobSize));
+        if (header.magic != expected.magic || header.version != expected.version ||
+            header.vendorID != expected.vendorID || header.deviceID != expected.deviceID ||
+            header.driverVersion != expected.driverVersion ||
+            std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            return false;
+        }
+        if (header.dataSize != blobSize || header.checksum != expected.checksum) { return false; }
+
+        //! Drivers are supposed to reject foreign data themselves, not all of them do
+        VkPipelineCacheHeaderVersionOne driverHeader;
+        std::memcpy(&driverHeader, blob, sizeof(VkPipelineCacheHeaderVersionOne));
+        return driverHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+               driverHeader.vendorID == expected.vendorID &&
+               driverHeader.deviceID == expected.deviceID &&
+               std::memcmp(driverHeader.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    void PipelineCache::Destroy() {
+        m_device->DestroyPipelineCache(m_cache);
+        m_cache = VK_NULL_HANDLE;
+    }
+} // Shift::VK
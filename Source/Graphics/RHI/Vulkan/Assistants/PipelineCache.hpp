@@ -0,0 +1,74 @@
+#ifndef SHIFT_PIPELINECACHE_HPP
+#define SHIFT_PIPELINECACHE_HPP
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+
+namespace Shift::VK {
+    //! VkPipelineCache persisted to disk between runs.
+    //! The blob is prefixed with our own header keyed by vendor, device, driver version and pipelineCacheUUID plus a
+    //! checksum of the data. Anything that does not match (other GPU, driver update, truncated file) is dropped and the
+    //! cache starts cold, so a stale blob is never handed to the driver.
+    class PipelineCache {
+    public:
+        //! Create the cache, seeded from the file if it is valid for this device
+        //! \param device Device wrapper ptr
+        //! \param path cache file path
+        //! \return false if the VkPipelineCache could not be created
+        [[nodiscard]] bool Init(const Device* device, const std::string& path);
+
+        //! Write the cache to disk, goes through a temporary file so a crash never leaves a half written cache
+        //! \return false if failed
+        bool Save() const;
+
+        //! Account a pipeline creation for the startup report, thread safe: compile workers and the main thread both create
+        //! \param ms creation time in milliseconds
+        void RecordCreation(double ms);
+
+        //! Log the pipeline creation stats, cold = compiled from scratch, warm = seeded from disk
+        void ReportStats() const;
+
+        [[nodiscard]] VkPipelineCache Get() const { return m_cache; }
+        [[nodiscard]] bool IsWarm() const { return m_isWarm; }
+
+        void Destroy();
+        ~PipelineCache() = default;
+    private:
+        static constexpr uint32_t MAGIC = 0x43505353; // "SSPC"
+        static constexpr uint32_t VERSION = 1;
+
+        struct FileHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint32_t driverVersion;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+            uint64_t dataSize;
+            uint64_t checksum;
+        };
+
+        //! Fill the header for the current device
+        [[nodiscard]] FileHeader MakeHeader(uint64_t dataSize, uint64_t checksum) const;
+
+        //! Check the file contents against the current device
+        //! \param fileData the whole file
+        //! \return true if the blob after the header can be handed to the driver
+        [[nodiscard]] bool Validate(const std::vector<char>& fileData) const;
+
+        const Device* m_device = nullptr;
+        VkPipelineCache m_cache = VK_NULL_HANDLE;
+        std::string m_path;
+
+        bool m_isWarm = false;
+        //! Guards the creation stats
+        mutable std::mutex m_statsMutex;
+        uint32_t m_pipelineCount = 0;
+        double m_creationTimeMs = 0.0;
+    };
+} // Shift::VK
+
+#endif //SHIFT_PIPELINECACHE_HPP
@@ -0,0 +1,209 @@
+#include "PipelineLayoutCache.hpp"
+
+#include <algorithm>
+
+#include "Config/EngineConfig.hpp"
+#include "Utility/Vulkan/VKUtilRHI.hpp"
+
+namespace Shift::VK {
+    void PipelineLayoutCache::Init(const Device *device, DescriptorLayoutCache *descLayoutCache) {
+        m_device = device;
+        m_descLayoutCache = descLayoutCache;
+    }
+
+    bool PipelineLayoutCache::RegisterShader(uint64_t shaderHash, EShaderType stage, std::span<const char> code) {
+        if (m_reflections.contains(shaderHash)) { return true; }
+
+        ShaderReflection reflection;
+        if (!ReflectSpirv(code, stage, &reflection)) { return false; }
+
+        uint32_t maxPushSize = m_device->GetDeviceProperties().limits.maxPushConstantsSize;
+        if (reflection.pushConstantSize > maxPushSize) {
+            Log(Error, "Shader push constants take {} bytes, the device limit is {}", reflection.pushConstantSize, maxPushSize);
+            return false;
+        }
+
+        m_reflections.emplace(shaderHash, std::move(reflection));
+        return true;
+    }
+
+    VkPipelineLayout PipelineLayoutCache::Resolve(const std::vector<ShaderStageDesc> &shaders, PipelineDescriptor *desc) {
+        bool reflectLayouts = desc->descriptorLayouts.empty();
+        bool reflectVertexInput = desc->vertexConfig.vertexBindings.empty() && desc->vertexConfig.attributeDescs.empty();
+
+        std::vector<const ShaderReflection*> reflections;
+        const ShaderReflection* vertexReflection = nullptr;
+        bool isCompute = false;
+        for (const auto& stage: shaders) {
+            isCompute |= stage.type == EShaderType::Compute;
+
+            auto it = m_reflections.find(stage.handle->GetHash());
+            if (it == m_reflections.end()) {
+                if (reflectLayouts || reflectVertexInput) {
+                    Log(Error, "No reflection for a pipeline shader, create it through the RHI or describe the pipeline explicitly");
+                    return VK_NULL_HANDLE;
+                }
+                continue;
+            }
+
+            reflections.push_back(&it->second);
+            if (stage.type == EShaderType::Vertex) {
+                vertexReflection = &it->second;
+            }
+        }
+
+        EBindingVisibility visibility = (isCompute) ? EBindingVisibility::Compute : EBindingVisibility::AllGraphics;
+
+        if (reflectLayouts && !MergeBindings(reflections, visibility, &desc->descriptorLayouts)) {
+            return VK_NULL_HANDLE;
+        }
+        if (desc->pushConstantRanges.empty()) {
+            desc->pushConstantRanges.push_back({.stages = visibility, .offset = 0, .size = Conf::SHIFT_PUSH_CONSTANT_SIZE});
+        }
+        if (!ValidatePushConstants(reflections, desc->pushConstantRanges)) {
+            return VK_NULL_HANDLE;
+        }
+        if (reflectVertexInput && vertexReflection != nullptr) {
+            FillVertexConfig(*vertexReflection, &desc->vertexConfig);
+        }
+
+        std::vector<VkDescriptorSetLayout> setLayouts;
+        setLayouts.reserve(desc->descriptorLayouts.size());
+        for (const auto& layoutDesc: desc->descriptorLayouts) {
+            setLayouts.push_back(m_descLayoutCache->CreateDescriptorLayout(layoutDesc));
+        }
+
+        return GetLayout(setLayouts, desc->pushConstantRanges);
+    }
+
+    VkPipelineLayout PipelineLayoutCache::GetLayout(std::span<const VkDescriptorSetLayout> setLayouts, std::span<const PushConstantRange> pushConstantRanges) {
+        std::vector<VkPushConstantRange> pushRanges;
+        pushRanges.reserve(pushConstantRanges.size());
+        for (const auto& range: pushConstantRanges) {
+            pushRanges.push_back({Util::ShiftToVKBindingVisibility(range.stages), range.offset, range.size});
+        }
+
+        std::string key;
+        key.append(reinterpret_cast<const char*>(pushRanges.data()), pushRanges.size() * sizeof(VkPushConstantRange));
+        key.push_back('|');
+        key.append(reinterpret_cast<const char*>(setLayouts.data()), setLayouts.size_bytes());
+
+        if (auto it = m_layouts.find(key); it != m_layouts.end()) {
+            return it->second;
+        }
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+        layoutInfo.pSetLayouts = setLayouts.data();
+        layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushRanges.size());
+        layoutInfo.pPushConstantRanges = pushRanges.data();
+
+        VkPipelineLayout layout = m_device->CreatePipelineLayout(layoutInfo);
+        if (!VkNullCheck(layout)) { return VK_NULL_HANDLE; }
+
+        m_layouts.emplace(std::move(key), layout);
+        return layout;
+    }
+
+    bool PipelineLayoutCache::MergeBindings(std::span<const ShaderReflection* const> reflections, EBindingVisibility visibility, std::vector<PipelineLayoutDescriptor> *outLayouts) {
+        bool usesBindless = false;
+        for (const ShaderReflection* reflection: reflections) {
+            for (const auto& binding: reflection->bindings) {
+                if (binding.set == Conf::SHIFT_BINDLESS_SET) {
+                    auto it = std::ranges::find(m_bindlessLayout.bindings, binding.binding, &PipelineLayoutDescriptor::LayoutBindingDesc::binding);
+                    if (it == m_bindlessLayout.bindings.end() || it->type != binding.type) {
+                        Log(Error, "Binding {} of the bindless set does not match the bindless heap", binding.binding);
+                        return false;
+                    }
+                    usesBindless = true;
+                    continue;
+                }
+
+                if (binding.count == 0) {
+                    Log(Error, "Runtime sized array at set {} binding {} can't be reflected into a layout", binding.set, binding.binding);
+                    return false;
+                }
+
+                //! SPIR-V can't tell, per object uniforms are dynamic by convention so they can live in the uniform ring
+                EBindingType type = binding.type;
+                if (binding.set == Conf::SHIFT_PER_OBJECT_SET && type == EBindingType::UniformBuffer) {
+                    type = EBindingType::UniformBufferDynamic;
+                }
+
+                //! Sets nobody declares in between stay as empty layouts, the set numbers have to match the shaders
+                if (outLayouts->size() <= binding.set) {
+                    outLayouts->resize(binding.set + 1);
+                }
+                auto& bindings = (*outLayouts)[binding.set].bindings;
+
+                auto it = std::ranges::find(bindings, binding.binding, &PipelineLayoutDescriptor::LayoutBindingDesc::binding);
+                if (it == bindings.end()) {
+                    bindings.push_back({.binding = binding.binding, .type = type, .stageFlags = visibility, .count = binding.count});
+                    continue;
+                }
+
+                if (it->type != type || it->count != binding.count) {
+                    Log(Error, "Set {} binding {} is declared differently between the shader stages", binding.set, binding.binding);
+                    return false;
+                }
+            }
+        }
+
+        //! Sorted, so the same bindings always give the same descriptor and the same pipeline key
+        for (auto& layout: *outLayouts) {
+            std::ranges::sort(layout.bindings, {}, &PipelineLayoutDescriptor::LayoutBindingDesc::binding);
+        }
+
+        //! Whole heap layout no matter what the shader declared, so the heap set can be bound with any of these pipelines
+        if (usesBindless) {
+            if (outLayouts->size() <= Conf::SHIFT_BINDLESS_SET) {
+                outLayouts->resize(Conf::SHIFT_BINDLESS_SET + 1);
+            }
+            (*outLayouts)[Conf::SHIFT_BINDLESS_SET] = m_bindlessLayout;
+        }
+
+        return true;
+    }
+
+    bool PipelineLayoutCache::ValidatePushConstants(std::span<const ShaderReflection* const> reflections, std::span<const PushConstantRange> ranges) const {
+        uint32_t maxPushSize = m_device->GetDeviceProperties().limits.maxPushConstantsSize;
+
+        uint32_t rangesEnd = 0;
+        for (const auto& range: ranges) {
+            if (range.size == 0 || range.offset % 4 != 0 || range.size % 4 != 0 || range.offset + range.size > maxPushSize) {
+                Log(Error, "Push constant range [{}, {}) is invalid, it has to be 4 byte aligned and within {} bytes", range.offset, range.offset + range.size, maxPushSize);
+                return false;
+            }
+            rangesEnd = std::max(rangesEnd, range.offset + range.size);
+        }
+
+        for (const ShaderReflection* reflection: reflections) {
+            if (reflection->pushConstantSize > rangesEnd) {
+                Log(Error, "Shader push constants take {} bytes, the pipeline ranges cover {}", reflection->pushConstantSize, rangesEnd);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void PipelineLayoutCache::FillVertexConfig(const ShaderReflection &reflection, PipelineDescriptor::VertexConfig *outConfig) {
+        if (reflection.vertexInputs.empty()) { return; }
+
+        uint32_t offset = 0;
+        for (const auto& input: reflection.vertexInputs) {
+            outConfig->attributeDescs.push_back({.location = input.location, .binding = 0, .offset = offset, .format = input.format});
+            offset += input.size;
+        }
+        outConfig->vertexBindings.push_back({.binding = 0, .stride = offset, .inputRate = EVertexInputRate::PerVertex});
+    }
+
+    void PipelineLayoutCache::Destroy() {
+        for (auto& [key, layout]: m_layouts) {
+            m_device->DestroyPipelineLayout(layout);
+        }
+        m_layouts.clear();
+        m_reflections.clear();
+    }
+} // Shift::VK
@@ -0,0 +1,77 @@
+#ifndef SHIFT_PIPELINELAYOUTCACHE_HPP
+#define SHIFT_PIPELINELAYOUTCACHE_HPP
+
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKShader.hpp"
+
+#include "DescriptorLayoutCache.hpp"
+#include "ShaderReflection.hpp"
+
+namespace Shift::VK {
+    //! Shared pipeline layouts built from shader reflection.
+    //! Reflected bindings are visible to every graphics stage (or compute) no matter which stage declared them, and every
+    //! layout without explicit push constant ranges carries the same canonical one. So two pipelines whose shaders declare
+    //! the same set N (e.g. per-frame and per-view data from Base.glsl) have compatible layouts up to N and the bound sets
+    //! survive pipeline switches.
+    //! Uniform buffers of Conf::SHIFT_PER_OBJECT_SET are reflected as dynamic ones, they are fed from the uniform ring.
+    //! Main thread only, the pipeline registry gets its layouts resolved before the compile is queued.
+    class PipelineLayoutCache {
+    public:
+        //! \param device Device wrapper ptr
+        //! \param descLayoutCache set layouts are created through it, so equal sets are the same handle
+        void Init(const Device* device, DescriptorLayoutCache* descLayoutCache);
+
+        //! Reflect a shader module and keep the result for the pipelines built with it
+        //! \param shaderHash Shader::GetHash() of the module
+        //! \param stage shader stage
+        //! \param code SPIR-V binary
+        //! \return false if the reflection failed, pipelines can still be built from an explicit descriptor
+        bool RegisterShader(uint64_t shaderHash, EShaderType stage, std::span<const char> code);
+
+        //! Shaders declaring Conf::SHIFT_BINDLESS_SET get this layout for it instead of a reflected one
+        //! \param desc the bindless heap layout description
+        void SetBindlessLayout(const PipelineLayoutDescriptor& desc) { m_bindlessLayout = desc; }
+
+        //! Fill whatever the descriptor leaves empty (descriptor layouts, vertex input, push constant ranges) from the
+        //! reflection of its shaders and get the matching shared pipeline layout
+        //! \param shaders pipeline shader stages
+        //! \param desc descriptor to complete, explicit layouts and vertex input are kept as is
+        //! \return VK_NULL_HANDLE if failed
+        [[nodiscard]] VkPipelineLayout Resolve(const std::vector<ShaderStageDesc>& shaders, PipelineDescriptor* desc);
+
+        //! Get or create the layout of these set layouts and push constant ranges
+        //! \param setLayouts set layouts in set order
+        //! \param pushConstantRanges validated push constant ranges
+        //! \return VK_NULL_HANDLE if failed
+        [[nodiscard]] VkPipelineLayout GetLayout(std::span<const VkDescriptorSetLayout> setLayouts, std::span<const PushConstantRange> pushConstantRanges);
+
+        void Destroy();
+        ~PipelineLayoutCache() = default;
+    private:
+        //! Union of the bindings of all the stages, a binding declared differently by two stages is an error
+        //! \return false if failed
+        bool MergeBindings(std::span<const ShaderReflection* const> reflections, EBindingVisibility visibility, std::vector<PipelineLayoutDescriptor>* outLayouts);
+
+        //! Ranges have to be 4 byte aligned, fit maxPushConstantsSize and cover the push blocks of the shaders
+        //! \return false if failed
+        [[nodiscard]] bool ValidatePushConstants(std::span<const ShaderReflection* const> reflections, std::span<const PushConstantRange> ranges) const;
+
+        //! One interleaved per vertex binding with the attributes tightly packed in location order
+        static void FillVertexConfig(const ShaderReflection& reflection, PipelineDescriptor::VertexConfig* outConfig);
+
+        const Device* m_device = nullptr;
+        DescriptorLayoutCache* m_descLayoutCache = nullptr;
+        PipelineLayoutDescriptor m_bindlessLayout;
+
+        std::unordered_map<uint64_t, ShaderReflection> m_reflections;
+        //! Keyed by the set layout handles and push constant stages
+        std::unordered_map<std::string, VkPipelineLayout> m_layouts;
+    };
+} // Shift::VK
+
+#endif //SHIFT_PIPELINELAYOUTCACHE_HPP
@@ -0,0 +1,220 @@
+#include "PipelineRegistry.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <type_traits>
+
+namespace Shift::VK {
+    bool PipelineRegistry::Init(const Device *device, PipelineCache *cache, uint32_t workerCount) {
+        m_device = device;
+        m_cache = cache;
+        m_isStopping = false;
+
+        if (workerCount == 0) {
+            //! Leave most of the cores to the frame, compilation is a background thing
+            workerCount = std::clamp(std::thread::hardware_concurrency() / 4u, 1u, 4u);
+        }
+
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            m_workers.emplace_back(&PipelineRegistry::WorkerLoop, this);
+        }
+
+        return true;
+    }
+
+    PipelineHandle PipelineRegistry::Request(const PipelineDescriptor &desc, const std::vector<ShaderStageDesc> &shaders, VkPipelineLayout layout) {
+        std::string key = MakeKey(desc, shaders);
+        if (auto it = m_lookup.find(key); it != m_lookup.end()) {
+            return {.index = it->second, .generation = m_generation};
+        }
+
+        uint32_t index = static_cast<uint32_t>(m_entries.size());
+        Entry& entry = m_entries.emplace_back();
+        m_lookup.emplace(std::move(key), index);
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_jobs.push(CompileJob{&entry, desc, shaders, layout});
+        }
+        m_jobAvailable.notify_one();
+
+        return {.index = index, .generation = m_generation};
+    }
+
+    EPipelineStatus PipelineRegistry::GetStatus(PipelineHandle handle) const {
+        if (!IsAlive(handle)) { return EPipelineStatus::Failed; }
+
+        return m_entries[handle.index].status.load(std::memory_order_acquire);
+    }
+
+    const Pipeline* PipelineRegistry::Get(PipelineHandle handle) const {
+        if (GetStatus(handle) != EPipelineStatus::Ready) { return nullptr; }
+
+        return &m_entries[handle.index].pipeline;
+    }
+
+    void PipelineRegistry::Wait(PipelineHandle handle) const {
+        if (!IsAlive(handle)) { return; }
+
+        std::unique_lock lock(m_mutex);
+        m_jobDone.wait(lock, [&]() {
+            return m_entries[handle.index].status.load(std::memory_order_acquire) != EPipelineStatus::Compiling;
+        });
+    }
+
+    void PipelineRegistry::WorkerLoop() {
+        while (true) {
+            CompileJob job;
+            {
+                std::unique_lock lock(m_mutex);
+                m_jobAvailable.wait(lock, [this]() { return m_isStopping || !m_jobs.empty(); });
+                if (m_isStopping) { return; }
+
+                job = std::move(m_jobs.front());
+                m_jobs.pop();
+            }
+
+            auto start = std::chrono::high_resolution_clock::now();
+            job.entry->pipeline.Init(m_device, job.desc, job.shaders, job.layout, m_cache->Get());
+            std::chrono::duration<double, std::milli> creationTime = std::chrono::high_resolution_clock::now() - start;
+
+            bool isValid = job.entry->pipeline.IsValid();
+            if (!isValid) {
+                Log(Error, "Background pipeline compilation failed!");
+            }
+
+            {
+                std::lock_guard lock(m_mutex);
+                m_cache->RecordCreation(creationTime.count());
+                job.entry->status.store((isValid) ? EPipelineStatus::Ready : EPipelineStatus::Failed, std::memory_order_release);
+            }
+            m_jobDone.notify_all();
+        }
+    }
+
+    std::string PipelineRegistry::MakeKey(const PipelineDescriptor &desc, const std::vector<ShaderStageDesc> &shaders) {
+        std::string key;
+        key.reserve(256);
+
+        //! Field by field, so padding and bitfields never end up in the key
+        auto append = [&key]<typename T>(T value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        };
+
+        append(shaders.size());
+        for (const auto& stage: shaders) {
+            append(stage.type);
+            append(stage.handle->GetHash());
+        }
+
+        append(desc.vertexConfig.vertexBindings.size());
+        for (const auto& binding: desc.vertexConfig.vertexBindings) {
+            append(binding.binding);
+            append(binding.stride);
+            append(binding.inputRate);
+        }
+        append(desc.vertexConfig.attributeDescs.size());
+        for (const auto& attribute: desc.vertexConfig.attributeDescs) {
+            append(attribute.location);
+            append(attribute.binding);
+            append(attribute.offset);
+            append(attribute.format);
+        }
+
+        append(desc.topology);
+
+        //! Viewport and scissor are dynamic state, they don't make a different pipeline
+        const auto& raster = desc.rasterizerStateDesc;
+        append(static_cast<bool>(raster.depthClampEnable));
+        append(static_cast<bool>(raster.rasterizerDiscardEnable));
+        append(raster.polygoneMode);
+        append(raster.cullMode);
+        append(raster.windingOrder);
+        append(raster.lineWidth);
+        append(raster.depthBias.clamp);
+        append(raster.depthBias.constantFactor);
+        append(raster.depthBias.slopeFactor);
+        append(raster.depthBias.enable);
+
+        const auto& blend = desc.colorBlendConfig;
+        append(blend.logicalOperation);
+        append(blend.logicalOpEnabled);
+        append(blend.attachments.size());
+        for (const auto& att: blend.attachments) {
+            append(att.blendEnabled);
+            append(att.colorWriteMask);
+            append(att.sourceColorBlendFactor);
+            append(att.destinationColorBlendFactor);
+            append(att.colorBlendOperation);
+            append(att.sourceAlphaBlendFactor);
+            append(att.destinationAlphaBlendFactor);
+            append(att.alphaBlendOperation);
+            append(att.format);
+        }
+        for (float constant: blend.blendConstants) {
+            append(constant);
+        }
+
+        const auto& depth = desc.depthStencilConfig;
+        append(depth.depthFormat);
+        append(depth.stencilFormat);
+        append(depth.depthTestEnabled);
+        append(depth.depthWriteEnabled);
+        append(depth.depthFunction);
+
+        append(desc.descriptorLayouts.size());
+        for (const auto& layout: desc.descriptorLayouts) {
+            append(layout.bindings.size());
+            for (const auto& binding: layout.bindings) {
+                append(binding.binding);
+                append(binding.type);
+                append(binding.stageFlags);
+                append(binding.count);
+                append(binding.isBindless);
+                append(binding.writable);
+            }
+        }
+
+        append(desc.pushConstantRanges.size());
+        for (const auto& range: desc.pushConstantRanges) {
+            append(range.stages);
+            append(range.offset);
+            append(range.size);
+        }
+
+        return key;
+    }
+
+    void PipelineRegistry::Destroy() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_isStopping = true;
+            m_jobs = {};
+        }
+        m_jobAvailable.notify_all();
+        for (auto& worker: m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+
+        //! Destroying a failed (null) pipeline is a no-op, entries that are still Compiling never got their job started
+        for (auto& entry: m_entries) {
+            if (entry.status.load(std::memory_order_acquire) != EPipelineStatus::Compiling) {
+                entry.pipeline.Destroy();
+            }
+        }
+        m_entries.clear();
+        m_lookup.clear();
+        ++m_generation;
+    }
+
+    bool PipelineRegistry::IsAlive(PipelineHandle handle) const {
+        if (!handle.IsValid()) { return false; }
+
+        bool isAlive = handle.generation == m_generation && handle.index < m_entries.size();
+        assert(isAlive && "Stale pipeline handle, its registry was destroyed");
+        return isAlive;
+    }
+} // Shift::VK
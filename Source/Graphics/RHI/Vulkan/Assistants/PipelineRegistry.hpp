@@ -0,0 +1,94 @@
+#ifndef SHIFT_PIPELINEREGISTRY_HPP
+#define SHIFT_PIPELINEREGISTRY_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKPipeline.hpp"
+
+#include "PipelineCache.hpp"
+
+namespace Shift::VK {
+    //! Hash-consed pipeline storage. A pipeline is identified by its full descriptor plus the identity of its shaders,
+    //! identical requests share one pipeline. New pipelines are compiled on a small pool of worker threads, the caller
+    //! gets a handle right away and polls the status, drawing with a fallback (or not at all) until it is Ready.
+    //! Requests come from one thread, the workers only ever touch the entry they compile.
+    class PipelineRegistry {
+    public:
+        //! Start the compilation workers
+        //! \param device Device wrapper ptr
+        //! \param cache Pipeline cache the compilations go through (VkPipelineCache is internally synchronized)
+        //! \param workerCount amount of compilation threads, 0 picks based on the hardware
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, PipelineCache* cache, uint32_t workerCount = 0);
+
+        //! Get the handle for a pipeline, queues the compilation if this combination was never requested before.
+        //! Shaders have to stay alive until the pipeline is no longer Compiling.
+        //! \param desc pipeline descriptor
+        //! \param shaders shader stages
+        //! \param layout already resolved shared pipeline layout of desc
+        //! \return shared pipeline handle
+        [[nodiscard]] PipelineHandle Request(const PipelineDescriptor& desc, const std::vector<ShaderStageDesc>& shaders, VkPipelineLayout layout);
+
+        //! \return Failed for invalid handles and handles of an earlier registry, those assert in debug
+        [[nodiscard]] EPipelineStatus GetStatus(PipelineHandle handle) const;
+
+        //! Get the pipeline if it is ready
+        //! \return nullptr if it is still compiling or failed
+        [[nodiscard]] const Pipeline* Get(PipelineHandle handle) const;
+
+        //! Block until the pipeline is not compiling anymore, meant for load time
+        void Wait(PipelineHandle handle) const;
+
+        //! Stop the workers and destroy all the pipelines, the GPU must not use them anymore
+        void Destroy();
+        ~PipelineRegistry() = default;
+    private:
+        struct Entry {
+            Pipeline pipeline;
+            std::atomic<EPipelineStatus> status{EPipelineStatus::Compiling};
+        };
+
+        struct CompileJob {
+            //! Taken at request time, indexing the deque from a worker would race with new requests
+            Entry* entry;
+            PipelineDescriptor desc;
+            std::vector<ShaderStageDesc> shaders;
+            VkPipelineLayout layout = VK_NULL_HANDLE;
+        };
+
+        //! Serialize everything that affects the compiled pipeline into a byte key
+        [[nodiscard]] static std::string MakeKey(const PipelineDescriptor& desc, const std::vector<ShaderStageDesc>& shaders);
+
+        void WorkerLoop();
+
+        //! Whether the handle points at an entry of this registry
+        [[nodiscard]] bool IsAlive(PipelineHandle handle) const;
+
+        const Device* m_device = nullptr;
+        PipelineCache* m_cache = nullptr;
+
+        //! Deque so entries never move while a worker writes into one
+        std::deque<Entry> m_entries;
+        std::unordered_map<std::string, uint32_t> m_lookup;
+        //! Bumped by Destroy, so the handles of the entries it drops go stale
+        uint32_t m_generation = 0;
+
+        std::vector<std::thread> m_workers;
+        std::queue<CompileJob> m_jobs;
+        mutable std::mutex m_mutex;
+        mutable std::condition_variable m_jobAvailable;
+        mutable std::condition_variable m_jobDone;
+        bool m_isStopping = false;
+    };
+} // Shift::VK
+
+#endif //SHIFT_PIPELINEREGISTRY_HPP
@@ -0,0 +1,114 @@
+#include "ReadbackRing.hpp"
+
+#include <utility>
+
+#include "Utility/Vulkan/VKUtilRHI.hpp"
+
+namespace Shift::VK {
+    bool ReadbackRing::Init(const Device *device, uint64_t size) {
+        return m_ring.Init(device, size, "ReadbackRing", EBufferType::Readback);
+    }
+
+    ReadbackToken ReadbackRing::Record(const CommandBuffer &cmd, const TextureCopyDescriptor &srcTex, uint64_t frameNumber, ReadbackCallback callback) {
+        VkFormat format = Util::ShiftToVKTextureFormat(srcTex.texture->GetFormat());
+        uint32_t texelSize = Util::GetFormatCopySize(format, Util::ShiftToVKTextureAspect(srcTex.subresourceRange.aspect));
+        if (texelSize == 0) {
+            Log(Error, "Can't read back format {}, only plain color formats and a single depth or stencil aspect", static_cast<uint32_t>(format));
+            return {};
+        }
+
+        uint64_t size = static_cast<uint64_t>(texelSize) * srcTex.size.x * srcTex.size.y * srcTex.size.z * srcTex.subresourceRange.layerCount;
+        //! The ring aligns to 16 bytes or more, the offset of 3, 6, 12 and 24 byte texels has to be moved to a multiple of them
+        bool isAligned = (texelSize & (texelSize - 1)) == 0 && texelSize <= 16;
+        uint64_t allocated = m_ring.TryAllocate((isAligned) ? size : size + texelSize);
+        if (allocated == UINT64_MAX) {
+            Log(Warning, "Readback ring is full, dropping a {} byte readback. Release the finished ones!", size);
+            return {};
+        }
+        uint64_t offset = (allocated + texelSize - 1) / texelSize * texelSize;
+
+        cmd.CopyTextureToBuffer(srcTex, {m_ring.GetBuffer(), static_cast<uint32_t>(offset)});
+        m_hasFrameCopies = true;
+
+        ReadbackToken token{m_frontValue + m_requests.size()};
+        m_requests.push_back({
+            .frame = frameNumber,
+            .offset = offset,
+            .size = size,
+            .head = m_ring.GetHead(),
+            .callback = std::move(callback)
+        });
+        return token;
+    }
+
+    void ReadbackRing::BeginFrame(uint64_t completedFrame) {
+        m_completedFrame = completedFrame;
+
+        //! By index and nothing is popped until the loop is done, a callback may release or record requests
+        m_isResolving = true;
+        for (size_t i = 0; i < m_requests.size(); ++i) {
+            Request& request = m_requests[i];
+            if (request.frame > completedFrame) { break; }
+            if (request.isReady || request.isReleased) { continue; }
+
+            m_ring.InvalidateReads(request.offset, request.size);
+            request.isReady = true;
+            if (request.callback) {
+                //! Released before the call, the request must not be touched after it. Its space stays until ReleaseFront
+                ReadbackCallback callback = std::move(request.callback);
+                std::span<const std::byte> data{m_ring.GetMapped(request.offset), request.size};
+                request.isReleased = true;
+                callback(data);
+            }
+        }
+        m_isResolving = false;
+        ReleaseFront();
+    }
+
+    bool ReadbackRing::IsReady(ReadbackToken token) const {
+        const Request* request = Find(token);
+        return request != nullptr && request->isReady;
+    }
+
+    std::span<const std::byte> ReadbackRing::GetData(ReadbackToken token) {
+        Request* request = Find(token);
+        if (request == nullptr || !request->isReady) { return {}; }
+
+        return {m_ring.GetMapped(request->offset), request->size};
+    }
+
+    void ReadbackRing::Release(ReadbackToken token) {
+        Request* request = Find(token);
+        if (request == nullptr) { return; }
+
+        //! The space of a copy still in flight stays taken until its frame is done, ReleaseFront checks for that
+        request->isReleased = true;
+        request->callback = {};
+        if (!m_isResolving) { ReleaseFront(); }
+    }
+
+    ReadbackRing::Request* ReadbackRing::Find(ReadbackToken token) {
+        return const_cast<Request*>(std::as_const(*this).Find(token));
+    }
+
+    const ReadbackRing::Request* ReadbackRing::Find(ReadbackToken token) const {
+        if (!token.IsValid() || token.value < m_frontValue || token.value - m_frontValue >= m_requests.size()) { return nullptr; }
+
+        const Request& request = m_requests[token.value - m_frontValue];
+        return (request.isReleased) ? nullptr : &request;
+    }
+
+    void ReadbackRing::ReleaseFront() {
+        while (!m_requests.empty() && m_requests.front().isReleased && m_requests.front().frame <= m_completedFrame) {
+            m_ring.Release(m_requests.front().head);
+            m_requests.pop_front();
+            ++m_frontValue;
+        }
+    }
+
+    void ReadbackRing::Destroy() {
+        m_requests.clear();
+        m_hasFrameCopies = false;
+        m_ring.Destroy();
+    }
+} // Shift::VK
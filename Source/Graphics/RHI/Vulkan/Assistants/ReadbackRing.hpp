@@ -0,0 +1,86 @@
+#ifndef SHIFT_READBACKRING_HPP
+#define SHIFT_READBACKRING_HPP
+
+#include <deque>
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/StagingRing.hpp"
+
+namespace Shift::VK {
+    //! Texture readbacks of the frame command buffer into a host visible ring. A request is tagged with the frame it was
+    //! recorded in and resolved at the BeginCmds after that frame is done, so nothing waits for the GPU. Requests with a
+    //! callback get it then and are released right after, the others stay readable until they are released. The ring
+    //! space goes back in request order, so a request that is never released stalls the ring. Main thread only.
+    class ReadbackRing {
+    public:
+        //! \param device Device wrapper ptr
+        //! \param size ring size in bytes
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, uint64_t size);
+
+        //! Record the copy of a texture region, tightly packed
+        //! \param cmd the frame buffer, the texture has to be in TransferSrcOptimal and the ring ready for transfer writes
+        //! \param srcTex texture + size to copy + offset + subresource range, a single mip and aspect
+        //! \param frameNumber the frame the copy is recorded in
+        //! \param callback called once the data is there, can be empty
+        //! \return invalid token if the format has no plain texel size or the ring is full
+        [[nodiscard]] ReadbackToken Record(const CommandBuffer& cmd, const TextureCopyDescriptor& srcTex, uint64_t frameNumber, ReadbackCallback callback);
+
+        //! Resolve the requests of the frames that are done and give back the space released since
+        //! \param completedFrame every frame up to this one is done on the GPU
+        void BeginFrame(uint64_t completedFrame);
+
+        //! Whether a copy was recorded in the current frame, the ring then needs a host read barrier before the end
+        [[nodiscard]] bool HasFrameCopies() const { return m_hasFrameCopies; }
+        void EndFrame() { m_hasFrameCopies = false; }
+
+        //! Whether the data of the request can be read, never blocks
+        [[nodiscard]] bool IsReady(ReadbackToken token) const;
+
+        //! The tightly packed texels of a ready request
+        //! \return empty if not ready or released, else valid until released
+        [[nodiscard]] std::span<const std::byte> GetData(ReadbackToken token);
+
+        //! Let go of a request, its data is not readable after. The space of a copy still in flight goes back once its
+        //! frame is done
+        void Release(ReadbackToken token);
+
+        [[nodiscard]] const Buffer& GetBuffer() { return *m_ring.GetBuffer(); }
+
+        //! Drop every request without calling back, the GPU must not write the ring anymore
+        void Destroy();
+        ~ReadbackRing() = default;
+    private:
+        struct Request {
+            uint64_t frame = 0;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+            //! Ring head after the allocation, everything before it is free once this request goes
+            uint64_t head = 0;
+            ReadbackCallback callback;
+            bool isReady = false;
+            bool isReleased = false;
+        };
+
+        //! \return nullptr if the token is invalid or its request was let go of
+        [[nodiscard]] Request* Find(ReadbackToken token);
+        [[nodiscard]] const Request* Find(ReadbackToken token) const;
+
+        //! Pop the released requests of completed frames at the front and give their space back
+        void ReleaseFront();
+
+        StagingRing m_ring;
+
+        //! Requests in recording order, the token of the front one is m_frontValue and the rest follow it
+        std::deque<Request> m_requests;
+        uint64_t m_frontValue = 1;
+        //! Every frame up to this one is done on the GPU, the copies of later ones may still write the ring
+        uint64_t m_completedFrame = 0;
+        //! Callbacks are running, releases then leave the popping to BeginFrame
+        bool m_isResolving = false;
+        bool m_hasFrameCopies = false;
+    };
+} // Shift::VK
+
+#endif //SHIFT_READBACKRING_HPP
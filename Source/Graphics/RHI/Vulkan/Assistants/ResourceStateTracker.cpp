@@ -0,0 +1,337 @@
+#include "ResourceStateTracker.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "Utility/Vulkan/VKUtilRHI.hpp"
+
+namespace Shift::VK {
+    void ResourceStateTracker::Begin(const CommandBuffer *cmd) {
+        m_cmd = cmd;
+        //! Whatever wasn't flushed belonged to a buffer that is gone, the states already assume it was recorded
+        m_imageBarriers.clear();
+        m_bufferBarriers.clear();
+        ++m_batch;
+    }
+
+    void ResourceStateTracker::TransitionTexture(const Texture &texture, const VkImageSubresourceRange &range,
+        VkImageLayout layout, VkPipelineStageFlags2KHR stages)
+    {
+        TextureState& textureState = GetTextureState(texture);
+
+        uint32_t mipEnd = (range.levelCount == VK_REMAINING_MIP_LEVELS) ? textureState.mipCount : std::min(range.baseMipLevel + range.levelCount, textureState.mipCount);
+        uint32_t layerEnd = (range.layerCount == VK_REMAINING_ARRAY_LAYERS) ? textureState.layerCount : std::min(range.baseArrayLayer + range.layerCount, textureState.layerCount);
+        VkAccessFlags2KHR access = GetLayoutAccess(layout, stages);
+
+        //! A second barrier for a subresource can't go into the same batch as its first one
+        bool isQueued = false;
+        for (uint32_t layer = range.baseArrayLayer; layer < layerEnd; ++layer) {
+            for (uint32_t mip = range.baseMipLevel; mip < mipEnd; ++mip) {
+                isQueued |= textureState.subresources[layer * textureState.mipCount + mip].batch == m_batch;
+            }
+        }
+        if (isQueued) { Flush(); }
+
+        //! Runs of mips with the same source scope become one barrier, and equal runs of consecutive layers merge too
+        for (uint32_t layer = range.baseArrayLayer; layer < layerEnd; ++layer) {
+            uint32_t runStart = 0;
+            uint32_t runCount = 0;
+            Scope runSrc;
+            for (uint32_t mip = range.baseMipLevel; mip < mipEnd; ++mip) {
+                State& state = textureState.subresources[layer * textureState.mipCount + mip];
+                Scope src;
+                bool needsBarrier = Advance(&state, layout, stages, access, &src);
+                if (needsBarrier) { state.batch = m_batch; }
+
+                if (runCount > 0 && (!needsBarrier || src != runSrc || runStart + runCount != mip)) {
+                    QueueImageBarrier(texture.GetImage(), Util::ShiftToVKTextureAspect(texture.GetAspect()), runStart, runCount, layer, runSrc, layout, stages, access);
+                    runCount = 0;
+                }
+                if (needsBarrier) {
+                    if (runCount == 0) {
+                        runStart = mip;
+                        runSrc = src;
+                    }
+                    ++runCount;
+                }
+            }
+            if (runCount > 0) {
+                QueueImageBarrier(texture.GetImage(), Util::ShiftToVKTextureAspect(texture.GetAspect()), runStart, runCount, layer, runSrc, layout, stages, access);
+            }
+        }
+
+        UpdateCachedLayout(texture, textureState, layout, stages);
+    }
+
+    void ResourceStateTracker::RecordTextureTransition(const CommandBuffer &cmd, const Texture &texture,
+        const VkImageSubresourceRange &range, VkImageLayout layout, VkPipelineStageFlags2KHR stages)
+    {
+        //! Same path as the frame transitions, only flushed into the other buffer. The queued frame barriers wait aside
+        const CommandBuffer* frameCmd = m_cmd;
+        std::vector<VkImageMemoryBarrier2KHR> frameImageBarriers = std::exchange(m_imageBarriers, {});
+        std::vector<VkBufferMemoryBarrier2KHR> frameBufferBarriers = std::exchange(m_bufferBarriers, {});
+
+        m_cmd = &cmd;
+        TransitionTexture(texture, range, layout, stages);
+        Flush();
+
+        m_cmd = frameCmd;
+        m_imageBarriers = std::move(frameImageBarriers);
+        m_bufferBarriers = std::move(frameBufferBarriers);
+    }
+
+    void ResourceStateTracker::AssumeTextureState(const Texture &texture, const VkImageSubresourceRange &range,
+        VkImageLayout layout, VkPipelineStageFlags2KHR stages)
+    {
+        TextureState& textureState = GetTextureState(texture);
+
+        uint32_t mipEnd = (range.levelCount == VK_REMAINING_MIP_LEVELS) ? textureState.mipCount : std::min(range.baseMipLevel + range.levelCount, textureState.mipCount);
+        uint32_t layerEnd = (range.layerCount == VK_REMAINING_ARRAY_LAYERS) ? textureState.layerCount : std::min(range.baseArrayLayer + range.layerCount, textureState.layerCount);
+        for (uint32_t layer = range.baseArrayLayer; layer < layerEnd; ++layer) {
+            for (uint32_t mip = range.baseMipLevel; mip < mipEnd; ++mip) {
+                textureState.subresources[layer * textureState.mipCount + mip] = State{.layout = layout, .writeStages = stages};
+            }
+        }
+
+        UpdateCachedLayout(texture, textureState, layout, stages);
+    }
+
+    void ResourceStateTracker::TransitionExternalImage(VkImage image, VkImageAspectFlags aspect, VkImageLayout *layout,
+        VkPipelineStageFlags *stageFlags, VkImageLayout newLayout, VkPipelineStageFlags2KHR stages)
+    {
+        uint64_t& batch = m_externalBatches[image];
+        if (batch == m_batch) { Flush(); }
+
+        State state{.layout = *layout, .writeStages = *stageFlags, .writeAccess = GetWriteAccess(GetLayoutAccess(*layout, *stageFlags))};
+        VkAccessFlags2KHR access = GetLayoutAccess(newLayout, stages);
+
+        Scope src;
+        if (Advance(&state, newLayout, stages, access, &src)) {
+            QueueImageBarrier(image, aspect, 0, 1, 0, src, newLayout, stages, access);
+            batch = m_batch;
+        }
+
+        *layout = newLayout;
+        *stageFlags = static_cast<VkPipelineStageFlags>(stages);
+    }
+
+    void ResourceStateTracker::TransitionBuffer(const Buffer &buffer, VkAccessFlags2KHR access, VkPipelineStageFlags2KHR stages) {
+        State& state = m_buffers[buffer.VK_Get()];
+        if (state.batch == m_batch) { Flush(); }
+
+        Scope src;
+        if (!Advance(&state, VK_IMAGE_LAYOUT_UNDEFINED, stages, access, &src)) { return; }
+        state.batch = m_batch;
+
+        VkBufferMemoryBarrier2KHR barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+        barrier.srcStageMask = src.stages;
+        barrier.srcAccessMask = src.access;
+        barrier.dstStageMask = stages;
+        barrier.dstAccessMask = access;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = buffer.VK_Get();
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        m_bufferBarriers.push_back(barrier);
+    }
+
+    void ResourceStateTracker::Discard(const Texture &texture, std::span<const Texture* const> aliased) {
+        //! Whatever touched the memory last becomes the source scope, the bytes themselves don't matter anymore
+        State discarded;
+        auto absorb = [&](const Texture& other) {
+            auto it = m_textures.find(other.GetImage());
+            if (it == m_textures.end()) {
+                discarded.writeStages |= Util::ShiftToVKPipelineStageFlags2(static_cast<EPipelineStageFlags>(other.VK_GetStageFlags()));
+                return;
+            }
+            for (const State& state: it->second.subresources) {
+                discarded.writeStages |= state.writeStages | state.readStages;
+                discarded.writeAccess |= state.writeAccess;
+                discarded.batch = std::max(discarded.batch, state.batch);
+            }
+        };
+        absorb(texture);
+        for (const Texture* other: aliased) {
+            absorb(*other);
+        }
+
+        TextureState& textureState = GetTextureState(texture);
+        textureState.subresources.assign(textureState.subresources.size(), discarded);
+        texture.SetResourceLayout(EResourceLayout::Undefined);
+    }
+
+    VkImageLayout ResourceStateTracker::GetLayout(const Texture &texture, uint32_t mip, uint32_t layer) const {
+        auto it = m_textures.find(texture.GetImage());
+        if (it == m_textures.end() || mip >= it->second.mipCount || layer >= it->second.layerCount) {
+            return Util::ShiftToVKResourceLayout(texture.GetResourceLayout());
+        }
+        return it->second.subresources[layer * it->second.mipCount + mip].layout;
+    }
+
+    void ResourceStateTracker::Forget(const Texture &texture) {
+        m_textures.erase(texture.GetImage());
+    }
+
+    void ResourceStateTracker::Forget(const Buffer &buffer) {
+        m_buffers.erase(buffer.VK_Get());
+    }
+
+    void ResourceStateTracker::Flush() {
+        if (m_imageBarriers.empty() && m_bufferBarriers.empty()) { return; }
+
+        VkDependencyInfoKHR dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(m_bufferBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = m_bufferBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(m_imageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = m_imageBarriers.data();
+        m_cmd->VK_PipelineBarrier2(dependencyInfo);
+
+        m_imageBarriers.clear();
+        m_bufferBarriers.clear();
+        ++m_batch;
+    }
+
+    void ResourceStateTracker::Destroy() {
+        m_textures.clear();
+        m_buffers.clear();
+        m_externalBatches.clear();
+        m_imageBarriers.clear();
+        m_bufferBarriers.clear();
+        m_cmd = nullptr;
+    }
+
+    bool ResourceStateTracker::Advance(State *state, VkImageLayout layout, VkPipelineStageFlags2KHR stages,
+        VkAccessFlags2KHR access, Scope *outSrc)
+    {
+        VkAccessFlags2KHR writeAccess = GetWriteAccess(access);
+
+        //! Reads in the same layout only have to wait for the last write, and only once per stage
+        if (state->layout == layout && writeAccess == VK_ACCESS_2_NONE_KHR) {
+            bool seenByStages = (stages & ~state->readStages) == 0;
+            bool nothingToWaitFor = state->writeStages == VK_PIPELINE_STAGE_2_NONE_KHR && state->writeAccess == VK_ACCESS_2_NONE_KHR;
+            state->readStages |= stages;
+            if (seenByStages || nothingToWaitFor) { return false; }
+
+            *outSrc = {.layout = layout, .stages = state->writeStages, .access = state->writeAccess};
+            return true;
+        }
+
+        //! Writes and layout transitions wait for everything, the transition itself counts as a write in the new stages
+        *outSrc = {.layout = state->layout, .stages = state->writeStages | state->readStages, .access = state->writeAccess};
+        state->layout = layout;
+        state->writeStages = stages;
+        state->writeAccess = writeAccess;
+        state->readStages = (writeAccess == VK_ACCESS_2_NONE_KHR) ? stages : VK_PIPELINE_STAGE_2_NONE_KHR;
+        return true;
+    }
+
+    void ResourceStateTracker::QueueImageBarrier(VkImage image, VkImageAspectFlags aspect, uint32_t baseMip, uint32_t mipCount,
+        uint32_t layer, const Scope &src, VkImageLayout layout, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access)
+    {
+        if (!m_imageBarriers.empty()) {
+            VkImageMemoryBarrier2KHR& last = m_imageBarriers.back();
+            VkImageSubresourceRange& lastRange = last.subresourceRange;
+            bool sameScope = last.image == image && last.oldLayout == src.layout && last.newLayout == layout &&
+                             last.srcStageMask == src.stages && last.srcAccessMask == src.access &&
+                             last.dstStageMask == stages && last.dstAccessMask == access;
+
+            if (sameScope && lastRange.baseMipLevel == baseMip && lastRange.levelCount == mipCount &&
+                lastRange.baseArrayLayer + lastRange.layerCount == layer) {
+                ++lastRange.layerCount;
+                return;
+            }
+        }
+
+        VkImageMemoryBarrier2KHR barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+        barrier.srcStageMask = src.stages;
+        barrier.srcAccessMask = src.access;
+        barrier.dstStageMask = stages;
+        barrier.dstAccessMask = access;
+        barrier.oldLayout = src.layout;
+        barrier.newLayout = layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {aspect, baseMip, mipCount, layer, 1};
+        m_imageBarriers.push_back(barrier);
+    }
+
+    VkAccessFlags2KHR ResourceStateTracker::GetLayoutAccess(VkImageLayout layout, VkPipelineStageFlags2KHR stages) {
+        switch (layout) {
+            case VK_IMAGE_LAYOUT_UNDEFINED:
+            case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+                //! Presentation is synchronized with the semaphores
+                return VK_ACCESS_2_NONE_KHR;
+            case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+                return VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR;
+            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+                return VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR;
+            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+                return VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR;
+            case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+                return VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR;
+            case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+                return VK_ACCESS_2_TRANSFER_READ_BIT_KHR;
+            case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+                return VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+            case VK_IMAGE_LAYOUT_GENERAL: {
+                //! Storage images, or transfers if that is who uses it
+                VkAccessFlags2KHR access = VK_ACCESS_2_NONE_KHR;
+                if (stages & (VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR | VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR)) {
+                    access |= VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+                }
+                if (stages & ~VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR) {
+                    access |= VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR;
+                }
+                return access;
+            }
+            default:
+                return VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+        }
+    }
+
+    VkAccessFlags2KHR ResourceStateTracker::GetWriteAccess(VkAccessFlags2KHR access) {
+        constexpr VkAccessFlags2KHR WRITE_ACCESS =
+            VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR |
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR |
+            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+            VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR |
+            VK_ACCESS_2_HOST_WRITE_BIT_KHR |
+            VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+        return access & WRITE_ACCESS;
+    }
+
+    ResourceStateTracker::TextureState& ResourceStateTracker::GetTextureState(const Texture &texture) {
+        VkImageLayout cachedLayout = Util::ShiftToVKResourceLayout(texture.GetResourceLayout());
+        auto [it, inserted] = m_textures.try_emplace(texture.GetImage());
+        TextureState& textureState = it->second;
+
+        if (inserted) {
+            VkPipelineStageFlags2KHR cachedStages = Util::ShiftToVKPipelineStageFlags2(static_cast<EPipelineStageFlags>(texture.VK_GetStageFlags()));
+            textureState.mipCount = std::max(texture.GetMipCount(), 1u);
+            textureState.layerCount = std::max(texture.GetLevels(), 1u);
+            textureState.subresources.assign(textureState.mipCount * textureState.layerCount, State{
+                .layout = cachedLayout,
+                .writeStages = cachedStages,
+                .readStages = cachedStages
+            });
+        }
+        return textureState;
+    }
+
+    void ResourceStateTracker::UpdateCachedLayout(const Texture &texture, const TextureState &textureState, VkImageLayout layout,
+        VkPipelineStageFlags2KHR stages)
+    {
+        //! The cached layout is what descriptors and render passes use, only meaningful while the texture is in one layout
+        bool isUniform = std::ranges::all_of(textureState.subresources, [&](const State& state) { return state.layout == layout; });
+        if (isUniform) {
+            texture.SetResourceLayout(static_cast<EResourceLayout>(layout));
+            texture.VK_SetStageFlags(static_cast<VkPipelineStageFlags>(stages));
+        }
+    }
+} // Shift::VK
@@ -0,0 +1,146 @@
+#ifndef SHIFT_RESOURCESTATETRACKER_HPP
+#define SHIFT_RESOURCESTATETRACKER_HPP
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Graphics/RHI/Vulkan/VKBuffer.hpp"
+#include "Graphics/RHI/Vulkan/VKTexture.hpp"
+#include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
+
+namespace Shift::VK {
+    //! Last layout, stages and accesses of every texture subresource and buffer the frame command buffer touched.
+    //! Transitions are only queued here, the whole batch goes out as one vkCmdPipelineBarrier2 right before the command
+    //! that consumes it (render pass begin, blit, end of the buffer). The source scope is whatever really used the
+    //! resource last instead of a guess from the layout, and readers of the same layout don't wait on each other.
+    //! This is the only owner of texture layouts, buffers and queues outside of the frame buffer (uploads) move a texture
+    //! through it too. Main thread only. Worker primaries are submitted before the frame buffer, so they are not tracked.
+    class ResourceStateTracker {
+    public:
+        //! \param cmd the buffer the barriers are recorded into, the frame buffer that was just begun
+        void Begin(const CommandBuffer* cmd);
+
+        //! Queue a transition of a texture range, a texture is tracked from its cached layout the first time it's seen.
+        //! The cached layout of the texture is kept up to date while the whole texture is in one layout
+        //! \param texture texture to transition
+        //! \param range subresources, VK_REMAINING_MIP_LEVELS/VK_REMAINING_ARRAY_LAYERS are fine
+        //! \param layout layout the range has to be in
+        //! \param stages stages that are going to use it
+        void TransitionTexture(const Texture& texture, const VkImageSubresourceRange& range, VkImageLayout layout, VkPipelineStageFlags2KHR stages);
+
+        //! Record a transition of a texture range into another buffer right away, for buffers that are submitted before
+        //! the frame buffer (uploads). The range must not be used by the frame buffer before it in the same frame
+        //! \param cmd the buffer to record the barrier into
+        //! \param texture texture to transition
+        //! \param range subresources, VK_REMAINING_MIP_LEVELS/VK_REMAINING_ARRAY_LAYERS are fine
+        //! \param layout layout the range has to be in
+        //! \param stages stages that are going to use it
+        void RecordTextureTransition(const CommandBuffer& cmd, const Texture& texture, const VkImageSubresourceRange& range,
+                                     VkImageLayout layout, VkPipelineStageFlags2KHR stages);
+
+        //! Take a texture range as being in a layout another queue left it in (async transfer), no barrier is recorded.
+        //! The acquire on the graphics queue makes it visible, so later transitions only chain from the given stages
+        //! \param texture texture that was transitioned
+        //! \param range subresources, VK_REMAINING_MIP_LEVELS/VK_REMAINING_ARRAY_LAYERS are fine
+        //! \param layout layout the range is in
+        //! \param stages stages that use it next
+        void AssumeTextureState(const Texture& texture, const VkImageSubresourceRange& range, VkImageLayout layout, VkPipelineStageFlags2KHR stages);
+
+        //! Queue a transition of an image whose state is kept by the owner (swapchain images)
+        //! \param image the image
+        //! \param aspect image aspect
+        //! \param layout in: current layout, out: new layout
+        //! \param stageFlags in: stages that used the image last, out: stages that are going to use it
+        //! \param newLayout layout the image has to be in
+        //! \param stages stages that are going to use it
+        void TransitionExternalImage(VkImage image, VkImageAspectFlags aspect, VkImageLayout* layout, VkPipelineStageFlags* stageFlags,
+                                     VkImageLayout newLayout, VkPipelineStageFlags2KHR stages);
+
+        //! Queue a barrier for a whole buffer
+        //! \param buffer buffer to transition
+        //! \param access how it's going to be accessed
+        //! \param stages stages that are going to access it
+        void TransitionBuffer(const Buffer& buffer, VkAccessFlags2KHR access, VkPipelineStageFlags2KHR stages);
+
+        //! Throw away the contents of a texture, its next transition starts from undefined
+        //! \param texture texture to discard
+        //! \param aliased textures that used the same memory before it, its first transition waits for them too
+        void Discard(const Texture& texture, std::span<const Texture* const> aliased);
+
+        //! The layout a subresource is in after the queued transitions, the cached one for untracked textures
+        [[nodiscard]] VkImageLayout GetLayout(const Texture& texture, uint32_t mip = 0, uint32_t layer = 0) const;
+
+        //! Drop the state of a resource that is being destroyed, the handle may come back for a new one
+        void Forget(const Texture& texture);
+        void Forget(const Buffer& buffer);
+
+        //! Record the queued barriers as one vkCmdPipelineBarrier2, has to happen outside of a render pass
+        void Flush();
+
+        [[nodiscard]] uint32_t GetPendingCount() const { return static_cast<uint32_t>(m_imageBarriers.size() + m_bufferBarriers.size()); }
+
+        void Destroy();
+        ~ResourceStateTracker() = default;
+    private:
+        struct State {
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            //! The last write (or layout transition), every later access has to chain from it
+            VkPipelineStageFlags2KHR writeStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            VkAccessFlags2KHR writeAccess = VK_ACCESS_2_NONE_KHR;
+            //! Stages that read since the last write and already see it
+            VkPipelineStageFlags2KHR readStages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            //! Flush batch of the last queued barrier, barriers of one batch are not ordered between each other
+            uint64_t batch = 0;
+        };
+
+        struct TextureState {
+            uint32_t mipCount = 1;
+            uint32_t layerCount = 1;
+            //! Layer major, layer * mipCount + mip
+            std::vector<State> subresources;
+        };
+
+        //! Source scope of a barrier
+        struct Scope {
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags2KHR stages = VK_PIPELINE_STAGE_2_NONE_KHR;
+            VkAccessFlags2KHR access = VK_ACCESS_2_NONE_KHR;
+
+            [[nodiscard]] bool operator==(const Scope& other) const = default;
+        };
+
+        //! Move a state to a new access
+        //! \param state state to update
+        //! \param outSrc source scope of the barrier
+        //! \return false if no barrier is needed
+        [[nodiscard]] static bool Advance(State* state, VkImageLayout layout, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access, Scope* outSrc);
+
+        //! Queue a barrier, merged into the previous one if it continues its mip or layer range
+        void QueueImageBarrier(VkImage image, VkImageAspectFlags aspect, uint32_t baseMip, uint32_t mipCount, uint32_t layer,
+                               const Scope& src, VkImageLayout layout, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access);
+
+        //! Everything a layout can be accessed with by the given stages
+        [[nodiscard]] static VkAccessFlags2KHR GetLayoutAccess(VkImageLayout layout, VkPipelineStageFlags2KHR stages);
+        [[nodiscard]] static VkAccessFlags2KHR GetWriteAccess(VkAccessFlags2KHR access);
+
+        //! State of a texture, starting from its creation layout the first time it is seen
+        TextureState& GetTextureState(const Texture& texture);
+
+        //! Keep the cached layout of the texture for descriptors and render passes while it is all in one layout
+        static void UpdateCachedLayout(const Texture& texture, const TextureState& textureState, VkImageLayout layout, VkPipelineStageFlags2KHR stages);
+
+        const CommandBuffer* m_cmd = nullptr;
+
+        std::unordered_map<VkImage, TextureState> m_textures;
+        std::unordered_map<VkBuffer, State> m_buffers;
+        //! Only the flush batch of the owner tracked images
+        std::unordered_map<VkImage, uint64_t> m_externalBatches;
+
+        std::vector<VkImageMemoryBarrier2KHR> m_imageBarriers;
+        std::vector<VkBufferMemoryBarrier2KHR> m_bufferBarriers;
+        uint64_t m_batch = 1;
+    };
+} // Shift::VK
+
+#endif //SHIFT_RESOURCESTATETRACKER_HPP
@@ -0,0 +1,430 @@
+#include "ShaderReflection.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+#include "Utility/Logging/LogMacros.hpp"
+
+namespace Shift::VK {
+    namespace {
+        //! The subset of the SPIR-V spec we care about
+        namespace Spv {
+            constexpr uint32_t MAGIC = 0x07230203;
+            constexpr uint32_t HEADER_WORDS = 5;
+
+            enum Op : uint32_t {
+                OpTypeBool = 20,
+                OpTypeInt = 21,
+                OpTypeFloat = 22,
+                OpTypeVector = 23,
+                OpTypeMatrix = 24,
+                OpTypeImage = 25,
+                OpTypeSampler = 26,
+                OpTypeSampledImage = 27,
+                OpTypeArray = 28,
+                OpTypeRuntimeArray = 29,
+                OpTypeStruct = 30,
+                OpTypePointer = 32,
+                OpConstant = 43,
+                OpSpecConstant = 50,
+                OpVariable = 59,
+                OpDecorate = 71,
+                OpMemberDecorate = 72,
+            };
+
+            enum Decoration : uint32_t {
+                Block = 2,
+                BufferBlock = 3,
+                ArrayStride = 6,
+                MatrixStride = 7,
+                BuiltIn = 11,
+                Location = 30,
+                Binding = 33,
+                DescriptorSet = 34,
+                Offset = 35,
+            };
+
+            enum StorageClass : uint32_t {
+                UniformConstant = 0,
+                Input = 1,
+                Uniform = 2,
+                PushConstant = 9,
+                StorageBuffer = 12,
+            };
+
+            enum Dim : uint32_t {
+                Buffer = 5,
+                SubpassData = 6,
+            };
+
+            //! OpTypeImage "Sampled" operand: 2 means read/write without a sampler
+            constexpr uint32_t IMAGE_STORAGE = 2;
+        } // Spv
+
+        struct MemberInfo {
+            uint32_t offset = 0;
+            uint32_t matrixStride = 0;
+        };
+
+        //! Everything we track for one SPIR-V result id
+        struct IdInfo {
+            uint32_t opcode = 0;
+            //! Type operands after the result id, layout depends on the opcode
+            std::vector<uint32_t> operands;
+            //! OpVariable / OpConstant result type
+            uint32_t typeId = 0;
+            uint32_t storageClass = 0;
+            uint32_t constantValue = 0;
+
+            uint32_t set = 0;
+            uint32_t binding = 0;
+            uint32_t location = 0;
+            uint32_t arrayStride = 0;
+            bool hasSet = false;
+            bool hasBinding = false;
+            bool hasLocation = false;
+            bool isBuiltIn = false;
+            bool isBufferBlock = false;
+
+            std::vector<MemberInfo> members;
+        };
+
+        class SpirvParser {
+        public:
+            explicit SpirvParser(std::vector<uint32_t> words): m_words{std::move(words)} {}
+
+            //! Deeper type nesting than any real shader has, ids that refer back to themselves end up past it
+            static constexpr uint32_t MAX_TYPE_DEPTH = 64;
+
+            bool Parse() {
+                if (m_words.size() < Spv::HEADER_WORDS || m_words[0] != Spv::MAGIC) {
+                    Log(Error, "Reflection: not a SPIR-V binary");
+                    return false;
+                }
+                //! Every id in the module is below the bound
+                m_ids.resize(m_words[3]);
+
+                size_t pos = Spv::HEADER_WORDS;
+                while (pos < m_words.size()) {
+                    uint32_t wordCount = m_words[pos] >> 16;
+                    uint32_t opcode = m_words[pos] & 0xFFFF;
+                    if (wordCount == 0 || pos + wordCount > m_words.size()) {
+                        Log(Error, "Reflection: malformed SPIR-V instruction at word {}", pos);
+                        return false;
+                    }
+                    if (!ParseInstruction(opcode, std::span{m_words.data() + pos, wordCount})) { return false; }
+                    pos += wordCount;
+                }
+
+                return true;
+            }
+
+            bool Reflect(EShaderType stage, ShaderReflection* outReflection) const {
+                outReflection->stage = stage;
+
+                for (const auto& var: m_ids) {
+                    if (var.opcode != Spv::OpVariable) { continue; }
+
+                    const IdInfo& pointer = m_ids[var.typeId];
+                    if (pointer.opcode != Spv::OpTypePointer || pointer.operands.size() < 2) { continue; }
+                    uint32_t pointee = pointer.operands[1];
+
+                    switch (var.storageClass) {
+                        case Spv::PushConstant: {
+                            uint32_t size = 0;
+                            if (!TypeSize(pointee, 0, 0, &size)) { return false; }
+                            outReflection->pushConstantSize = std::max(outReflection->pushConstantSize, size);
+                            break;
+                        }
+                        case Spv::Input:
+                            if (stage != EShaderType::Vertex || !var.hasLocation || var.isBuiltIn) { break; }
+                            if (!ReflectVertexInput(var, pointee, outReflection)) { return false; }
+                            break;
+                        case Spv::UniformConstant:
+                        case Spv::Uniform:
+                        case Spv::StorageBuffer:
+                            if (!var.hasBinding) { break; }
+                            if (!ReflectBinding(var, pointee, outReflection)) { return false; }
+                            break;
+                        default:
+                            break;
+                    }
+                }
+
+                std::ranges::sort(outReflection->vertexInputs, {}, &ShaderReflection::VertexInput::location);
+                return true;
+            }
+        private:
+            bool ParseInstruction(uint32_t opcode, std::span<const uint32_t> ins) {
+                auto idAt = [&](size_t operand) -> IdInfo* {
+                    if (operand >= ins.size() || ins[operand] >= m_ids.size()) { return nullptr; }
+                    return &m_ids[ins[operand]];
+                };
+
+                switch (opcode) {
+                    case Spv::OpTypeBool:
+                    case Spv::OpTypeInt:
+                    case Spv::OpTypeFloat:
+                    case Spv::OpTypeVector:
+                    case Spv::OpTypeMatrix:
+                    case Spv::OpTypeImage:
+                    case Spv::OpTypeSampler:
+                    case Spv::OpTypeSampledImage:
+                    case Spv::OpTypeArray:
+                    case Spv::OpTypeRuntimeArray:
+                    case Spv::OpTypePointer: {
+                        IdInfo* id = idAt(1);
+                        if (id == nullptr) { return MalformedId(opcode); }
+                        id->opcode = opcode;
+                        id->operands.assign(ins.begin() + 2, ins.end());
+                        break;
+                    }
+                    case Spv::OpTypeStruct: {
+                        IdInfo* id = idAt(1);
+                        if (id == nullptr) { return MalformedId(opcode); }
+                        id->opcode = opcode;
+                        id->operands.assign(ins.begin() + 2, ins.end());
+                        //! Member decorations can come before the struct itself, never shrink
+                        id->members.resize(std::max(id->members.size(), id->operands.size()));
+                        break;
+                    }
+                    case Spv::OpConstant:
+                    case Spv::OpSpecConstant: {
+                        IdInfo* id = idAt(2);
+                        if (id == nullptr || ins.size() < 4) { return MalformedId(opcode); }
+                        id->opcode = opcode;
+                        id->typeId = ins[1];
+                        //! Only used for array lengths, those are 32 bit
+                        id->constantValue = ins[3];
+                        break;
+                    }
+                    case Spv::OpVariable: {
+                        IdInfo* id = idAt(2);
+                        if (id == nullptr || ins.size() < 4 || ins[1] >= m_ids.size()) { return MalformedId(opcode); }
+                        id->opcode = opcode;
+                        id->typeId = ins[1];
+                        id->storageClass = ins[3];
+                        break;
+                    }
+                    case Spv::OpDecorate: {
+                        IdInfo* id = idAt(1);
+                        if (id == nullptr || ins.size() < 3) { return MalformedId(opcode); }
+                        uint32_t literal = (ins.size() > 3) ? ins[3] : 0;
+                        switch (ins[2]) {
+                            case Spv::DescriptorSet: id->set = literal; id->hasSet = true; break;
+                            case Spv::Binding: id->binding = literal; id->hasBinding = true; break;
+                            case Spv::Location: id->location = literal; id->hasLocation = true; break;
+                            case Spv::ArrayStride: id->arrayStride = literal; break;
+                            case Spv::BuiltIn: id->isBuiltIn = true; break;
+                            case Spv::BufferBlock: id->isBufferBlock = true; break;
+                            default: break;
+                        }
+                        break;
+                    }
+                    case Spv::OpMemberDecorate: {
+                        IdInfo* id = idAt(1);
+                        if (id == nullptr || ins.size() < 5) { return MalformedId(opcode); }
+                        uint32_t member = ins[2];
+                        if (member >= id->members.size()) { id->members.resize(member + 1); }
+                        switch (ins[3]) {
+                            case Spv::Offset: id->members[member].offset = ins[4]; break;
+                            case Spv::MatrixStride: id->members[member].matrixStride = ins[4]; break;
+                            default: break;
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                }
+
+                return true;
+            }
+
+            static bool MalformedId(uint32_t opcode) {
+                Log(Error, "Reflection: malformed operands of SPIR-V opcode {}", opcode);
+                return false;
+            }
+
+            //! \return nullptr if the id is past the bound
+            [[nodiscard]] const IdInfo* FindId(uint32_t id) const { return (id < m_ids.size()) ? &m_ids[id] : nullptr; }
+
+            //! The type an operand refers to
+            //! \return nullptr if the type has fewer operands or the id is past the bound
+            [[nodiscard]] const IdInfo* FindOperandId(const IdInfo& type, size_t operand) const {
+                return (operand < type.operands.size()) ? FindId(type.operands[operand]) : nullptr;
+            }
+
+            //! Size in bytes following the explicit layout decorations
+            //! \param typeId type to measure
+            //! \param matrixStride stride of the member if the type is a matrix, 0 for tightly packed
+            //! \param depth nesting depth of the type, bounded so self referencing ids can't recurse forever
+            //! \param outSize size of the type, 0 for runtime arrays and opaque types
+            //! \return false if the type is malformed
+            [[nodiscard]] bool TypeSize(uint32_t typeId, uint32_t matrixStride, uint32_t depth, uint32_t* outSize) const {
+                const IdInfo* type = FindId(typeId);
+                if (type == nullptr || depth > MAX_TYPE_DEPTH) {
+                    Log(Error, "Reflection: type id {} is out of bounds or nested too deep", typeId);
+                    return false;
+                }
+
+                uint32_t elementSize = 0;
+                switch (type->opcode) {
+                    case Spv::OpTypeBool:
+                        *outSize = 4;
+                        return true;
+                    case Spv::OpTypeInt:
+                    case Spv::OpTypeFloat:
+                        if (type->operands.empty()) { return MalformedId(type->opcode); }
+                        *outSize = type->operands[0] / 8;
+                        return true;
+                    case Spv::OpTypeVector:
+                        if (type->operands.size() < 2) { return MalformedId(type->opcode); }
+                        if (!TypeSize(type->operands[0], 0, depth + 1, &elementSize)) { return false; }
+                        *outSize = type->operands[1] * elementSize;
+                        return true;
+                    case Spv::OpTypeMatrix:
+                        if (type->operands.size() < 2) { return MalformedId(type->opcode); }
+                        if (matrixStride == 0 && !TypeSize(type->operands[0], 0, depth + 1, &elementSize)) { return false; }
+                        *outSize = type->operands[1] * ((matrixStride != 0) ? matrixStride : elementSize);
+                        return true;
+                    case Spv::OpTypeArray: {
+                        const IdInfo* length = FindOperandId(*type, 1);
+                        if (length == nullptr) { return MalformedId(type->opcode); }
+                        if (type->arrayStride == 0 && !TypeSize(type->operands[0], matrixStride, depth + 1, &elementSize)) { return false; }
+                        *outSize = length->constantValue * ((type->arrayStride != 0) ? type->arrayStride : elementSize);
+                        return true;
+                    }
+                    case Spv::OpTypeStruct: {
+                        uint32_t size = 0;
+                        for (size_t i = 0; i < type->operands.size(); ++i) {
+                            const MemberInfo& member = type->members[i];
+                            uint32_t memberSize = 0;
+                            if (!TypeSize(type->operands[i], member.matrixStride, depth + 1, &memberSize)) { return false; }
+                            size = std::max(size, member.offset + memberSize);
+                        }
+                        *outSize = size;
+                        return true;
+                    }
+                    default:
+                        //! Runtime arrays and opaque types have no size
+                        *outSize = 0;
+                        return true;
+                }
+            }
+
+            //! \return nullopt if the type is no resource or malformed
+            [[nodiscard]] std::optional<EBindingType> DescriptorType(uint32_t typeId, uint32_t storageClass) const {
+                const IdInfo& type = m_ids[typeId];
+                switch (type.opcode) {
+                    case Spv::OpTypeStruct:
+                        //! Old style storage buffers are Uniform + BufferBlock, new style have their own storage class
+                        if (storageClass == Spv::StorageBuffer || type.isBufferBlock) { return EBindingType::StorageBuffer; }
+                        return EBindingType::UniformBuffer;
+                    case Spv::OpTypeSampler:
+                        return EBindingType::Sampler;
+                    case Spv::OpTypeSampledImage: {
+                        const IdInfo* image = FindOperandId(type, 0);
+                        if (image == nullptr || image->opcode != Spv::OpTypeImage || image->operands.size() < 6) {
+                            MalformedId(type.opcode);
+                            return std::nullopt;
+                        }
+                        return (image->operands[1] == Spv::Buffer) ? EBindingType::UniformTexelBuffer : EBindingType::CombinedImageSampler;
+                    }
+                    case Spv::OpTypeImage: {
+                        //! Sampled type, dim, depth, arrayed, MS, sampled
+                        if (type.operands.size() < 6) {
+                            MalformedId(type.opcode);
+                            return std::nullopt;
+                        }
+                        bool isStorage = type.operands[5] == Spv::IMAGE_STORAGE;
+                        switch (type.operands[1]) {
+                            case Spv::Buffer:
+                                return (isStorage) ? EBindingType::StorageTexelBuffer : EBindingType::UniformTexelBuffer;
+                            case Spv::SubpassData:
+                                return EBindingType::InputAttachment;
+                            default:
+                                return (isStorage) ? EBindingType::StorageImage : EBindingType::SampledImage;
+                        }
+                    }
+                    default:
+                        return std::nullopt;
+                }
+            }
+
+            bool ReflectBinding(const IdInfo& var, uint32_t typeId, ShaderReflection* outReflection) const {
+                ShaderReflection::Binding binding{.set = var.set, .binding = var.binding};
+
+                //! Arrays of resources are one binding with a count
+                for (uint32_t depth = 0; ; ++depth) {
+                    const IdInfo* array = FindId(typeId);
+                    if (array == nullptr || depth > MAX_TYPE_DEPTH) {
+                        Log(Error, "Reflection: type id {} is out of bounds or nested too deep", typeId);
+                        return false;
+                    }
+                    if (array->opcode != Spv::OpTypeArray && array->opcode != Spv::OpTypeRuntimeArray) { break; }
+
+                    const IdInfo* length = (array->opcode == Spv::OpTypeArray) ? FindOperandId(*array, 1) : nullptr;
+                    if (array->operands.empty() || (array->opcode == Spv::OpTypeArray && length == nullptr)) { return MalformedId(array->opcode); }
+                    binding.count = (length != nullptr) ? binding.count * length->constantValue : 0;
+                    typeId = array->operands[0];
+                }
+
+                auto type = DescriptorType(typeId, var.storageClass);
+                if (!type.has_value()) {
+                    Log(Error, "Reflection: unsupported resource type at set {} binding {}", var.set, var.binding);
+                    return false;
+                }
+                binding.type = *type;
+
+                outReflection->bindings.push_back(binding);
+                return true;
+            }
+
+            bool ReflectVertexInput(const IdInfo& var, uint32_t typeId, ShaderReflection* outReflection) const {
+                const IdInfo* type = FindId(typeId);
+                if (type == nullptr) { return MalformedId(Spv::OpVariable); }
+                bool isVector = type->opcode == Spv::OpTypeVector;
+                if (isVector && type->operands.size() < 2) { return MalformedId(type->opcode); }
+                const IdInfo* component = (isVector) ? FindOperandId(*type, 0) : type;
+                uint32_t componentCount = (isVector) ? type->operands[1] : 1;
+
+                bool isFloat = component != nullptr && component->opcode == Spv::OpTypeFloat && !component->operands.empty() && component->operands[0] == 32;
+                if (!isFloat || componentCount == 0 || componentCount > 4) {
+                    Log(Error, "Reflection: vertex input at location {} is not a 32 bit float scalar or vector", var.location);
+                    return false;
+                }
+
+                static constexpr EVertexAttributeFormat formats[] = {
+                    EVertexAttributeFormat::R32_SignedFloat,
+                    EVertexAttributeFormat::R32G32_SignedFloat,
+                    EVertexAttributeFormat::R32G32B32_SignedFloat,
+                    EVertexAttributeFormat::R32G32B32A32_SignedFloat,
+                };
+                outReflection->vertexInputs.push_back({
+                    .location = var.location,
+                    .format = formats[componentCount - 1],
+                    .size = componentCount * 4u
+                });
+                return true;
+            }
+
+            std::vector<uint32_t> m_words;
+            std::vector<IdInfo> m_ids;
+        };
+    } // anonymous
+
+    bool ReflectSpirv(std::span<const char> code, EShaderType stage, ShaderReflection* outReflection) {
+        if (code.size() % sizeof(uint32_t) != 0) {
+            Log(Error, "Reflection: SPIR-V size {} is not a multiple of 4", code.size());
+            return false;
+        }
+
+        //! File data has no alignment guarantee for words
+        std::vector<uint32_t> words(code.size() / sizeof(uint32_t));
+        std::memcpy(words.data(), code.data(), code.size());
+
+        SpirvParser parser{std::move(words)};
+        return parser.Parse() && parser.Reflect(stage, outReflection);
+    }
+} // Shift::VK
@@ -0,0 +1,45 @@
+#ifndef SHIFT_SHADERREFLECTION_HPP
+#define SHIFT_SHADERREFLECTION_HPP
+
+#include <span>
+#include <vector>
+
+#include "Graphics/RHI/Shader.hpp"
+#include "Graphics/RHI/Pipeline.hpp"
+
+namespace Shift::VK {
+    //! The interface of a shader module as declared in its SPIR-V: descriptor bindings, push constants and vertex inputs
+    struct ShaderReflection {
+        struct Binding {
+            uint32_t set = 0;
+            uint32_t binding = 0;
+            EBindingType type = EBindingType::UniformBuffer;
+            //! Array size, 0 for runtime sized arrays
+            uint32_t count = 1;
+        };
+
+        struct VertexInput {
+            uint32_t location = 0;
+            EVertexAttributeFormat format = EVertexAttributeFormat::R32G32B32_SignedFloat;
+            //! Size of the attribute in bytes
+            uint32_t size = 0;
+        };
+
+        EShaderType stage = EShaderType::Vertex;
+        std::vector<Binding> bindings;
+        //! Size of the push constant block in bytes, 0 if there is none
+        uint32_t pushConstantSize = 0;
+        //! Vertex shaders only, sorted by location. Built-ins are not in here
+        std::vector<VertexInput> vertexInputs;
+    };
+
+    //! Parse the declarations of a SPIR-V module. Only what a pipeline layout and vertex input state need is read,
+    //! everything else in the module is skipped.
+    //! \param code SPIR-V binary as loaded from disk
+    //! \param stage the stage the module is used for
+    //! \param outReflection filled on success
+    //! \return false if the binary is malformed or declares something we can't express
+    [[nodiscard]] bool ReflectSpirv(std::span<const char> code, EShaderType stage, ShaderReflection* outReflection);
+} // Shift::VK
+
+#endif //SHIFT_SHADERREFLECTION_HPP
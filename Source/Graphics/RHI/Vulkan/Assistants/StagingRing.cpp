@@ -0,0 +1,36 @@
+#include "StagingRing.hpp"
+
+namespace Shift::VK {
+    bool StagingRing::Init(const Device *device, uint64_t size, const char *name, EBufferType type) {
+        m_size = size;
+        //! Covers the texel block size of every format we upload and the 4 byte buffer->image rule
+        m_alignment = std::max<uint64_t>(16u, device->GetDeviceProperties().limits.optimalBufferCopyOffsetAlignment);
+
+        m_buffer.Init(device, BufferDescriptor{.size = m_size, .name = name, .type = type});
+        if (!m_buffer.IsValid() || m_buffer.GetMapped() == nullptr) {
+            Log(Error, "Failed to create a persistently mapped ring: {}", name);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint64_t StagingRing::TryAllocate(uint64_t size) {
+        if (size > m_size) { return UINT64_MAX; }
+
+        uint64_t start = (m_head + m_alignment - 1) & ~(m_alignment - 1);
+        //! Never straddle the end of the ring, skip to the start instead
+        if (start % m_size + size > m_size) {
+            start += m_size - start % m_size;
+        }
+
+        if (start + size - m_tail > m_size) { return UINT64_MAX; }
+
+        m_head = start + size;
+        return start % m_size;
+    }
+
+    void StagingRing::Destroy() {
+        m_buffer.Destroy();
+    }
+} // Shift::VK
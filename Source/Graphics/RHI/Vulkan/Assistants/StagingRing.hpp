@@ -0,0 +1,60 @@
+#ifndef SHIFT_STAGINGRING_HPP
+#define SHIFT_STAGINGRING_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKBuffer.hpp"
+
+namespace Shift::VK {
+    //! A persistently mapped staging buffer used as a ring. Positions are monotonic, the actual offset is pos % size.
+    //! The owner decides when memory is free again by releasing up to a head position it saved at submission.
+    //! With EBufferType::Readback the GPU writes and the host reads instead.
+    class StagingRing {
+    public:
+        //! Create the ring buffer
+        //! \param device Device wrapper ptr
+        //! \param size ring size in bytes
+        //! \param name debug name
+        //! \param type EBufferType::Staging to upload, EBufferType::Readback to read back
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, uint64_t size, const char* name, EBufferType type = EBufferType::Staging);
+
+        //! Allocate a region, never straddles the end of the ring
+        //! \param size size in bytes
+        //! \return Offset into the buffer, UINT64_MAX if there is no space until something gets released
+        [[nodiscard]] uint64_t TryAllocate(uint64_t size);
+
+        //! Mark everything allocated before the head position as free
+        //! \param headPosition a value previously returned by GetHead()
+        void Release(uint64_t headPosition) { m_tail = std::max(m_tail, headPosition); }
+
+        //! Copy data into an allocated region
+        void Write(const void* data, uint64_t size, uint64_t offset) { m_buffer.Fill(data, size, offset); }
+
+        //! Flush the host writes, only does something for non-coherent memory
+        void FlushWrites() { m_buffer.FlushMapped(0, VK_WHOLE_SIZE); }
+
+        //! Make the device writes of a region visible to the host, only does something for non-coherent memory
+        void InvalidateReads(uint64_t offset, uint64_t size) { m_buffer.InvalidateMapped(offset, size); }
+
+        //! Mapped memory of an allocated region
+        [[nodiscard]] std::byte* GetMapped(uint64_t offset) { return static_cast<std::byte*>(m_buffer.GetMapped()) + offset; }
+
+        [[nodiscard]] uint64_t GetHead() const { return m_head; }
+        [[nodiscard]] uint64_t GetSize() const { return m_size; }
+        [[nodiscard]] Buffer* GetBuffer() { return &m_buffer; }
+
+        void Destroy();
+        ~StagingRing() = default;
+    private:
+        Buffer m_buffer;
+        uint64_t m_size = 0;
+        uint64_t m_head = 0;
+        uint64_t m_tail = 0;
+        uint64_t m_alignment = 16;
+    };
+} // Shift::VK
+
+#endif //SHIFT_STAGINGRING_HPP
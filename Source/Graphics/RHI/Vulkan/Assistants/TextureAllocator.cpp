@@ -0,0 +1,195 @@
+#include "TextureAllocator.hpp"
+
+#include "Graphics/RHI/Vulkan/VKTexture.hpp"
+
+namespace Shift::VK {
+    bool TextureAllocator::Init(const Device *device) {
+        m_device = device;
+
+        //! Every class shares the memory type of a plain sampled image, images that can't live there fall back to VMA
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+        imageInfo.extent = {1024, 1024, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        if (VkCheck(vmaFindMemoryTypeIndexForImageInfo(m_device->GetAllocator(), &imageInfo, &allocInfo, &m_memoryTypeIdx))) {
+            Log(Error, "Failed to find a memory type for the texture pools");
+            return false;
+        }
+
+        for (uint32_t i = 0; i < Conf::SHIFT_TEXTURE_POOL_CLASS_COUNT; ++i) {
+            VmaPoolCreateInfo poolInfo{};
+            poolInfo.memoryTypeIndex = m_memoryTypeIdx;
+            poolInfo.blockSize = Conf::SHIFT_TEXTURE_POOL_BLOCK_SIZES[i];
+            poolInfo.priority = 1.0f;
+            if (VkCheck(vmaCreatePool(m_device->GetAllocator(), &poolInfo, &m_pools[i]))) {
+                Log(Error, "Failed to create texture pool of size class {}", i);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    VmaAllocationCreateInfo TextureAllocator::GetAllocationInfo(const TextureDescriptor &textureDesc,
+        const VkMemoryRequirements &requirements) const
+    {
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.priority = 1.0f;
+
+        bool isAttachment = (textureDesc.usageFlags & (ETextureUsageFlags::ColorAttachment | ETextureUsageFlags::DepthStencilAttachment)) != ETextureUsageFlags::None;
+        if (isAttachment && requirements.size >= Conf::SHIFT_TEXTURE_DEDICATED_SIZE) {
+            allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+            return allocInfo;
+        }
+
+        if ((requirements.memoryTypeBits & (1u << m_memoryTypeIdx)) != 0) {
+            for (uint32_t i = 0; i < Conf::SHIFT_TEXTURE_POOL_CLASS_COUNT; ++i) {
+                if (requirements.size <= Conf::SHIFT_TEXTURE_POOL_MAX_SIZES[i]) {
+                    allocInfo.pool = m_pools[i];
+                    return allocInfo;
+                }
+            }
+        }
+
+        //! Too big for the classes, VMA gives these memory of their own when it sees fit
+        return allocInfo;
+    }
+
+    void TextureAllocator::SetOwner(VmaAllocation allocation, TextureHandle owner) const {
+        //! The handle is packed into the pointer, 0 stays free for allocations without an owner
+        uint64_t packed = (static_cast<uint64_t>(owner.index) + 1) << 32 | owner.generation;
+        vmaSetAllocationUserData(m_device->GetAllocator(), allocation, reinterpret_cast<void*>(static_cast<uintptr_t>(packed)));
+    }
+
+    TextureHandle TextureAllocator::GetOwner(VmaAllocation allocation) const {
+        VmaAllocationInfo allocInfo;
+        vmaGetAllocationInfo(m_device->GetAllocator(), allocation, &allocInfo);
+
+        auto packed = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(allocInfo.pUserData));
+        if (packed == 0) { return {}; }
+        return {.index = static_cast<uint32_t>((packed >> 32) - 1), .generation = static_cast<uint32_t>(packed)};
+    }
+
+    void TextureAllocator::MarkPendingDestroy(VmaAllocation allocation) {
+        if (allocation != VK_NULL_HANDLE) {
+            m_pendingDestroys.insert(allocation);
+        }
+    }
+
+    void TextureAllocator::DestroyTexture(Texture &texture) {
+        VmaAllocation allocation = texture.GetAlloc();
+        if (allocation == VK_NULL_HANDLE || !m_isPassOpen) {
+            m_pendingDestroys.erase(allocation);
+            texture.Destroy();
+            return;
+        }
+
+        //! The image goes now, the memory waits for the pass
+        texture.VK_DestroyImage();
+        m_passFrees.push_back(allocation);
+    }
+
+    void TextureAllocator::BeginDefragmentation() {
+        if (IsDefragmenting()) { return; }
+
+        m_stats = {};
+        m_defragPoolIdx = UINT32_MAX;
+        NextDefragmentationPool();
+    }
+
+    std::span<VmaDefragmentationMove> TextureAllocator::BeginPass() {
+        if (!IsDefragmenting() || m_isPassOpen) { return {}; }
+
+        VkResult res = vmaBeginDefragmentationPass(m_device->GetAllocator(), m_context, &m_pass);
+        if (res == VK_INCOMPLETE) {
+            m_isPassOpen = true;
+            return {m_pass.pMoves, m_pass.moveCount};
+        }
+        if (res != VK_SUCCESS) {
+            Log(Warning, "Texture pool {} failed to start a defragmentation pass, skipping it", m_defragPoolIdx);
+        }
+
+        NextDefragmentationPool();
+        return {};
+    }
+
+    void TextureAllocator::EndPass() {
+        if (!m_isPassOpen) { return; }
+        m_isPassOpen = false;
+
+        VkResult res = vmaEndDefragmentationPass(m_device->GetAllocator(), m_context, &m_pass);
+        for (VmaAllocation allocation: m_passFrees) {
+            m_pendingDestroys.erase(allocation);
+            vmaFreeMemory(m_device->GetAllocator(), allocation);
+        }
+        m_passFrees.clear();
+        //! More to move in this pool
+        if (res == VK_INCOMPLETE) { return; }
+        if (res != VK_SUCCESS) {
+            Log(Warning, "Texture pool {} failed to end a defragmentation pass, skipping it", m_defragPoolIdx);
+        }
+
+        NextDefragmentationPool();
+    }
+
+    void TextureAllocator::NextDefragmentationPool() {
+        if (m_context != VK_NULL_HANDLE) {
+            VmaDefragmentationStats stats{};
+            vmaEndDefragmentation(m_device->GetAllocator(), m_context, &stats);
+            m_context = VK_NULL_HANDLE;
+
+            m_stats.bytesMoved += stats.bytesMoved;
+            m_stats.bytesFreed += stats.bytesFreed;
+            m_stats.allocationsMoved += stats.allocationsMoved;
+            m_stats.deviceMemoryBlocksFreed += stats.deviceMemoryBlocksFreed;
+        }
+
+        //! Pools that fail to start are skipped like the ones with nothing to move
+        while (++m_defragPoolIdx < Conf::SHIFT_TEXTURE_POOL_CLASS_COUNT) {
+            VmaDefragmentationInfo defragInfo{};
+            defragInfo.pool = m_pools[m_defragPoolIdx];
+            defragInfo.maxBytesPerPass = Conf::SHIFT_TEXTURE_DEFRAG_BYTES_PER_PASS;
+            defragInfo.maxAllocationsPerPass = Conf::SHIFT_TEXTURE_DEFRAG_MOVES_PER_PASS;
+            if (!VkCheck(vmaBeginDefragmentation(m_device->GetAllocator(), &defragInfo, &m_context))) { return; }
+
+            Log(Warning, "Failed to start defragmenting texture pool {}", m_defragPoolIdx);
+            m_context = VK_NULL_HANDLE;
+        }
+
+        Log(Info, "Texture defragmentation moved {} textures ({} bytes) and freed {} blocks ({} bytes)",
+            m_stats.allocationsMoved, m_stats.bytesMoved, m_stats.deviceMemoryBlocksFreed, m_stats.bytesFreed);
+    }
+
+    void TextureAllocator::Destroy() {
+        //! The caller ended the open pass, what is left of the context goes without moving anything
+        if (m_context != VK_NULL_HANDLE) {
+            vmaEndDefragmentation(m_device->GetAllocator(), m_context, nullptr);
+            m_context = VK_NULL_HANDLE;
+        }
+        m_isPassOpen = false;
+        for (VmaAllocation allocation: m_passFrees) {
+            vmaFreeMemory(m_device->GetAllocator(), allocation);
+        }
+        m_passFrees.clear();
+        m_pendingDestroys.clear();
+
+        for (VmaPool& pool: m_pools) {
+            if (pool != VK_NULL_HANDLE) {
+                vmaDestroyPool(m_device->GetAllocator(), pool);
+            }
+            pool = VK_NULL_HANDLE;
+        }
+    }
+} // Shift::VK
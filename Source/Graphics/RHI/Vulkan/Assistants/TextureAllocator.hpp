@@ -0,0 +1,83 @@
+#ifndef SHIFT_TEXTUREALLOCATOR_HPP
+#define SHIFT_TEXTUREALLOCATOR_HPP
+
+#include <array>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/Handle.hpp"
+#include "Graphics/RHI/Texture.hpp"
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+
+namespace Shift::VK {
+    class Texture;
+
+    //! Where texture memory comes from. Images are suballocated from size class pools (one VMA pool per class, blocks
+    //! sized for it), so loading many small textures doesn't cost a vkAllocateMemory each, and only render targets past
+    //! Conf::SHIFT_TEXTURE_DEDICATED_SIZE get memory of their own. The pools are defragmented in passes of a few moves,
+    //! one pool after the other. Only textures with an owner handle are moved, the RHI swaps them behind the handle.
+    //! Main thread only.
+    class TextureAllocator {
+    public:
+        //! Create the size class pools
+        //! \param device Device wrapper ptr
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device);
+
+        //! Where an image goes
+        //! \param textureDesc texture description, attachments past the dedicated size get memory of their own
+        //! \param requirements memory requirements of the image
+        //! \return allocation info for vmaAllocateMemoryForImage
+        [[nodiscard]] VmaAllocationCreateInfo GetAllocationInfo(const TextureDescriptor& textureDesc, const VkMemoryRequirements& requirements) const;
+
+        //! Let defragmentation move a texture, moves of allocations without an owner are ignored
+        void SetOwner(VmaAllocation allocation, TextureHandle owner) const;
+        //! \return invalid handle if the allocation has no owner
+        [[nodiscard]] TextureHandle GetOwner(VmaAllocation allocation) const;
+
+        //! The texture went to the deletion queue, defragmentation must not move its allocation
+        void MarkPendingDestroy(VmaAllocation allocation);
+        [[nodiscard]] bool IsPendingDestroy(VmaAllocation allocation) const { return m_pendingDestroys.contains(allocation); }
+        //! Destroy a texture the deletion queue let go of. VMA still reads the allocations of an open pass, even the ignored
+        //! moves, so the memory of a texture destroyed while one is open is freed by EndPass
+        void DestroyTexture(Texture& texture);
+
+        //! Start compacting the pools, no-op if it is running already
+        void BeginDefragmentation();
+        [[nodiscard]] bool IsDefragmenting() const { return m_context != VK_NULL_HANDLE; }
+
+        //! Next batch of moves, every move the caller can't do has to be set to VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE.
+        //! The allocations of the moves must not be freed until EndPass
+        //! \return moves of the pass, empty if there is nothing to move in the current pool
+        [[nodiscard]] std::span<VmaDefragmentationMove> BeginPass();
+        //! The contents are copied to the new images and the old images are destroyed, VMA swaps the memory over
+        void EndPass();
+        [[nodiscard]] bool IsPassOpen() const { return m_isPassOpen; }
+
+        void Destroy();
+        ~TextureAllocator() = default;
+    private:
+        //! Close the context of the current pool and open one for the next
+        void NextDefragmentationPool();
+
+        const Device* m_device = nullptr;
+
+        std::array<VmaPool, Conf::SHIFT_TEXTURE_POOL_CLASS_COUNT> m_pools{};
+        uint32_t m_memoryTypeIdx = UINT32_MAX;
+
+        VmaDefragmentationContext m_context = VK_NULL_HANDLE;
+        VmaDefragmentationPassMoveInfo m_pass{};
+        VmaDefragmentationStats m_stats{};
+        uint32_t m_defragPoolIdx = 0;
+        bool m_isPassOpen = false;
+
+        std::unordered_set<VmaAllocation> m_pendingDestroys;
+        //! Memory of textures destroyed while the pass was open
+        std::vector<VmaAllocation> m_passFrees;
+    };
+} // Shift::VK
+
+#endif //SHIFT_TEXTUREALLOCATOR_HPP
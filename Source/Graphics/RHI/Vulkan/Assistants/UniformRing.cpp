@@ -0,0 +1,54 @@
+#include "UniformRing.hpp"
+
+#include <algorithm>
+
+#include "Config/EngineConfig.hpp"
+
+namespace Shift::VK {
+    bool UniformRing::Init(const Device *device, uint32_t frameSize) {
+        m_alignment = std::max<uint32_t>(16u, static_cast<uint32_t>(device->GetDeviceProperties().limits.minUniformBufferOffsetAlignment));
+        //! Keeps every frame base aligned as well
+        m_frameSize = (frameSize + m_alignment - 1) & ~(m_alignment - 1);
+
+        m_buffer.Init(device, BufferDescriptor{
+            .size = static_cast<uint64_t>(m_frameSize) * Conf::SHIFT_MAX_FRAMES_IN_FLIGHT,
+            .name = "UniformRing",
+            .type = EBufferType::Uniform
+        });
+        if (!m_buffer.IsValid() || m_buffer.GetMapped() == nullptr) {
+            Log(Error, "Failed to create a persistently mapped uniform ring");
+            return false;
+        }
+
+        return true;
+    }
+
+    void UniformRing::BeginFrame(uint32_t frameIdx) {
+        m_frameBase = frameIdx * m_frameSize;
+        m_head = 0;
+    }
+
+    uint32_t UniformRing::Push(const void *data, uint32_t size) {
+        uint32_t start = (m_head + m_alignment - 1) & ~(m_alignment - 1);
+        if (start + size > m_frameSize) {
+            if (!m_overflowReported) {
+                Log(Error, "Uniform ring is out of space ({} bytes per frame), raise Conf::SHIFT_UNIFORM_RING_SIZE", m_frameSize);
+                m_overflowReported = true;
+            }
+            return UINT32_MAX;
+        }
+
+        m_head = start + size;
+        m_buffer.Fill(data, size, m_frameBase + start);
+        return m_frameBase + start;
+    }
+
+    void UniformRing::Flush() {
+        if (m_head == 0) { return; }
+        m_buffer.FlushMapped(m_frameBase, m_head);
+    }
+
+    void UniformRing::Destroy() {
+        m_buffer.Destroy();
+    }
+} // Shift::VK
@@ -0,0 +1,49 @@
+#ifndef SHIFT_UNIFORMRING_HPP
+#define SHIFT_UNIFORMRING_HPP
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKBuffer.hpp"
+
+namespace Shift::VK {
+    //! Per frame constants (per object, per view) written linearly into one persistently mapped uniform buffer.
+    //! Every frame in flight owns a region of the buffer, the region is rewound when the frame begins again, so there
+    //! is nothing to free. Shaders see the data through a single UNIFORM_BUFFER_DYNAMIC descriptor, the offsets returned
+    //! here are the dynamic offsets to bind it with. Main thread only.
+    class UniformRing {
+    public:
+        //! Create the buffer
+        //! \param device Device wrapper ptr
+        //! \param frameSize bytes every frame in flight can push
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, uint32_t frameSize);
+
+        //! Rewind the region of the frame, its fence has to have signaled
+        //! \param frameIdx current frame in flight
+        void BeginFrame(uint32_t frameIdx);
+
+        //! Copy the data into the frame region
+        //! \param data source data, the whole descriptor range has to be pushed (sizeof of the shader block)
+        //! \param size data size
+        //! \return dynamic offset of the data, UINT32_MAX if the frame region is full
+        [[nodiscard]] uint32_t Push(const void* data, uint32_t size);
+
+        //! Make the writes of the frame visible, only does something for non-coherent memory
+        void Flush();
+
+        //! The buffer the dynamic descriptors point at (offset 0, range of the block)
+        [[nodiscard]] const Buffer& GetBuffer() const { return m_buffer; }
+        [[nodiscard]] uint32_t GetUsedThisFrame() const { return m_head; }
+
+        void Destroy();
+        ~UniformRing() = default;
+    private:
+        Buffer m_buffer;
+        uint32_t m_frameSize = 0;
+        uint32_t m_frameBase = 0;
+        uint32_t m_head = 0;
+        uint32_t m_alignment = 256;
+        bool m_overflowReported = false;
+    };
+} // Shift::VK
+
+#endif //SHIFT_UNIFORMRING_HPP
@@ -0,0 +1,196 @@
+#include "UploadManager.hpp"
+
+#include "Utility/Vulkan/VKUtilRHI.hpp"
+
+namespace Shift::VK {
+    bool UploadManager::Init(const Device *device, const Instance *ins, VkCommandPool pool, ResourceStateTracker *tracker, uint64_t ringSize) {
+        m_device = device;
+        m_tracker = tracker;
+
+        if (!m_ring.Init(m_device, ringSize, "UploadRing")) { return false; }
+
+        for (auto& frame: m_frames) {
+            if (!frame.cmd.Init(m_device, ins, pool, EPoolQueueType::Graphics)) {
+                Log(Error, "Failed to create upload command buffer!");
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void UploadManager::BeginFrame(uint32_t frameIdx) {
+        m_currentFrame = frameIdx;
+        Retire(m_frames[m_currentFrame]);
+
+        m_stats.bytesThisFrame = 0;
+        m_stats.copiesThisFrame = 0;
+        m_stats.submitsThisFrame = 0;
+    }
+
+    bool UploadManager::UploadToBuffer(const void *data, uint64_t size, const BufferOpDescriptor &dstBuf) {
+        BufferOpDescriptor src{};
+        if (!Stage(data, size, &src)) { return false; }
+
+        m_frames[m_currentFrame].cmd.CopyBufferToBuffer(src, dstBuf, static_cast<uint32_t>(size));
+        return true;
+    }
+
+    bool UploadManager::UploadToTexture(const void *data, uint64_t size, const TextureCopyDescriptor &dstTex, EResourceLayout finalLayout) {
+        BufferOpDescriptor src{};
+        if (!Stage(data, size, &src)) { return false; }
+
+        const CommandBuffer& cmd = m_frames[m_currentFrame].cmd;
+        const Texture* tex = dstTex.texture;
+        VkImageSubresourceRange range = Util::ShiftToVKSubresourceRange(dstTex.subresourceRange);
+
+        m_tracker->RecordTextureTransition(cmd, *tex, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR);
+        cmd.CopyBufferToTexture(src, dstTex);
+        m_tracker->RecordTextureTransition(cmd, *tex, range, Util::ShiftToVKResourceLayout(finalLayout), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR);
+
+        return true;
+    }
+
+    bool UploadManager::CopyBufferToBuffer(const BufferOpDescriptor &srcBuf, const BufferOpDescriptor &dstBuf, uint32_t size) {
+        if (!EnsureRecording()) { return false; }
+
+        m_frames[m_currentFrame].cmd.CopyBufferToBuffer(srcBuf, dstBuf, size);
+        ++m_stats.copiesThisFrame;
+        return true;
+    }
+
+    bool UploadManager::CopyBufferToTexture(const BufferOpDescriptor &srcBuf, const TextureCopyDescriptor &dstTex) {
+        if (!EnsureRecording()) { return false; }
+
+        m_frames[m_currentFrame].cmd.CopyBufferToTexture(srcBuf, dstTex);
+        ++m_stats.copiesThisFrame;
+        return true;
+    }
+
+    bool UploadManager::Flush() {
+        FrameData& frame = m_frames[m_currentFrame];
+        if (!frame.isRecording) { return true; }
+
+        //! Make every transfer write of the batch visible to whatever the frame is going to read
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+                                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+        frame.cmd.VK_SetPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, {}, {&barrier, 1}, {}, 0);
+
+        frame.isRecording = false;
+        if (!frame.cmd.End()) { return false; }
+
+        m_ring.FlushWrites();
+
+        frame.ringHead = m_ring.GetHead();
+        frame.isInFlight = true;
+        ++m_stats.submitsThisFrame;
+
+        return frame.cmd.Submit();
+    }
+
+    bool UploadManager::FlushAndWait() {
+        bool res = Flush();
+        Retire(m_frames[m_currentFrame]);
+        return res;
+    }
+
+    uint64_t UploadManager::AllocateRing(uint64_t size) {
+        if (size > m_ring.GetSize()) { return UINT64_MAX; }
+
+        uint64_t offset = m_ring.TryAllocate(size);
+        while (offset == UINT64_MAX) {
+            //! Out of ring space, retire the oldest in flight batch
+            FrameData* oldest = nullptr;
+            for (auto& frame: m_frames) {
+                if (frame.isInFlight && (oldest == nullptr || frame.ringHead < oldest->ringHead)) {
+                    oldest = &frame;
+                }
+            }
+
+            if (oldest == nullptr) {
+                //! The only thing holding the ring is the batch we are recording, push it out
+                if (!m_frames[m_currentFrame].isRecording || !Flush()) { return UINT64_MAX; }
+                offset = m_ring.TryAllocate(size);
+                continue;
+            }
+
+            ++m_stats.ringStalls;
+            Retire(*oldest);
+            offset = m_ring.TryAllocate(size);
+        }
+
+        return offset;
+    }
+
+    bool UploadManager::Stage(const void *data, uint64_t size, BufferOpDescriptor *outSrc) {
+        //! Recording first, starting a batch retires what this slot had in flight and that must not touch the new space
+        if (!EnsureRecording()) { return false; }
+        uint64_t offset = AllocateRing(size);
+        //! A full ring may have pushed the batch out to make room, the copy goes into a new one
+        if (!EnsureRecording()) { return false; }
+
+        FrameData& frame = m_frames[m_currentFrame];
+        if (offset != UINT64_MAX) {
+            m_ring.Write(data, size, offset);
+            *outSrc = {m_ring.GetBuffer(), static_cast<uint32_t>(offset)};
+        } else {
+            Buffer& tmp = frame.overflowBuffers.emplace_back();
+            tmp.Init(m_device, BufferDescriptor{.size = size, .name = "UploadOverflow", .type = EBufferType::Staging});
+            if (!tmp.IsValid()) {
+                Log(Error, "Failed to create an overflow staging buffer of size: {}", size);
+                frame.overflowBuffers.pop_back();
+                return false;
+            }
+            tmp.Fill(data, size, 0);
+            tmp.FlushMapped(0, VK_WHOLE_SIZE);
+            ++m_stats.overflowAllocations;
+            *outSrc = {&tmp, 0};
+        }
+
+        m_stats.bytesThisFrame += size;
+        ++m_stats.copiesThisFrame;
+
+        return true;
+    }
+
+    bool UploadManager::EnsureRecording() {
+        FrameData& frame = m_frames[m_currentFrame];
+        if (frame.isRecording) { return true; }
+
+        //! Uploaded more after a flush in the same frame, this slot has to be done before we can reuse it
+        Retire(frame);
+
+        frame.cmd.Reset();
+        if (!frame.cmd.Begin()) { return false; }
+        frame.isRecording = true;
+
+        //! The frame before this one might still be reading what we are about to overwrite
+        frame.cmd.VK_SetPipelineBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, {}, {}, {}, 0);
+
+        return true;
+    }
+
+    void UploadManager::Retire(FrameData &frame) {
+        if (!frame.isInFlight) { return; }
+
+        frame.cmd.Wait();
+        frame.isInFlight = false;
+        m_ring.Release(frame.ringHead);
+
+        for (auto& buf: frame.overflowBuffers) {
+            buf.Destroy();
+        }
+        frame.overflowBuffers.clear();
+    }
+
+    void UploadManager::Destroy() {
+        for (auto& frame: m_frames) {
+            Retire(frame);
+            frame.cmd.Destroy();
+        }
+        m_ring.Destroy();
+    }
+} // Shift::VK
@@ -0,0 +1,128 @@
+#ifndef SHIFT_UPLOADMANAGER_HPP
+#define SHIFT_UPLOADMANAGER_HPP
+
+#include <array>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/Vulkan/VKDevice.hpp"
+#include "Graphics/RHI/Vulkan/VKBuffer.hpp"
+#include "Graphics/RHI/Vulkan/VKTexture.hpp"
+#include "Graphics/RHI/Vulkan/VKCommandBuffer.hpp"
+
+#include "StagingRing.hpp"
+#include "ResourceStateTracker.hpp"
+
+namespace Shift::VK {
+    //! Batches host->device uploads through one persistently mapped staging ring.
+    //! All copies of a frame are recorded into a single command buffer and go out with a single submit at Flush(),
+    //! the ring memory of that frame is reclaimed once the frame fence signals (checked in BeginFrame()).
+    //! Uploads are submitted on the graphics queue right before the frame commands, so no ownership transfers
+    //! or semaphores are needed, the trailing memory barrier makes the data visible to the frame.
+    class UploadManager {
+    public:
+        struct Stats {
+            uint64_t bytesThisFrame = 0;
+            uint32_t copiesThisFrame = 0;
+            uint32_t submitsThisFrame = 0;
+            //! Uploads that did not fit the ring and got a temporary staging buffer
+            uint32_t overflowAllocations = 0;
+            //! How many times we had to block on the GPU to free ring space
+            uint32_t ringStalls = 0;
+        };
+
+        //! Initialize the upload manager
+        //! \param device Device wrapper ptr
+        //! \param ins Instance wrapper ptr
+        //! \param pool The command pool to allocate the upload command buffers from (has to be graphics)
+        //! \param tracker The state tracker texture uploads take the layouts from and move them through
+        //! \param ringSize Staging ring size in bytes
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, const Instance* ins, VkCommandPool pool, ResourceStateTracker* tracker, uint64_t ringSize);
+
+        //! Start a new frame, reclaims the ring space of the frame that used this slot before
+        //! \param frameIdx frame in flight index
+        void BeginFrame(uint32_t frameIdx);
+
+        //! Queue a buffer upload, the data is copied into the ring immediately
+        //! \param data source data
+        //! \param size data size
+        //! \param dstBuf destination buffer + offset
+        //! \return false if failed
+        bool UploadToBuffer(const void* data, uint64_t size, const BufferOpDescriptor& dstBuf);
+
+        //! Queue a texture upload, the data is copied into the ring immediately.
+        //! The texture is transitioned to TransferDst before the copy and to finalLayout after it, through the tracker.
+        //! The upload runs before the frame buffer, so the frame must not use the texture before the call.
+        //! \param data tightly packed texel data
+        //! \param size data size
+        //! \param dstTex destination texture + region + subresource
+        //! \param finalLayout the layout the texture is left in
+        //! \return false if failed
+        bool UploadToTexture(const void* data, uint64_t size, const TextureCopyDescriptor& dstTex, EResourceLayout finalLayout);
+
+        //! Record a GPU buffer to buffer copy into the batch. Both buffers have to stay alive until the batch retires.
+        //! \param srcBuf buffer + offset into the buffer
+        //! \param dstBuf buffer + offset into the buffer
+        //! \param size size to copy
+        //! \return false if failed
+        bool CopyBufferToBuffer(const BufferOpDescriptor& srcBuf, const BufferOpDescriptor& dstBuf, uint32_t size);
+
+        //! Record a buffer to texture copy into the batch, the texture has to be in TransferDst already.
+        //! \param srcBuf buffer + offset into the buffer
+        //! \param dstTex texture + region + subresource
+        //! \return false if failed
+        bool CopyBufferToTexture(const BufferOpDescriptor& srcBuf, const TextureCopyDescriptor& dstTex);
+
+        //! Submit all the recorded uploads of this frame (1 submit), does nothing if there is nothing to submit
+        //! \return false if submission failed
+        bool Flush();
+
+        //! Submit and block until the uploads are done, meant for load time
+        //! \return false if submission failed
+        bool FlushAndWait();
+
+        [[nodiscard]] bool HasPendingWork() const { return m_frames[m_currentFrame].isRecording; }
+        [[nodiscard]] const Stats& GetStats() const { return m_stats; }
+
+        void Destroy();
+        ~UploadManager() = default;
+    private:
+        struct FrameData {
+            CommandBuffer cmd;
+            //! Ring head at the moment of submission, everything before it is free once the fence signals
+            uint64_t ringHead = 0;
+            bool isRecording = false;
+            bool isInFlight = false;
+            //! Staging buffers for uploads that were bigger than the ring
+            std::vector<Buffer> overflowBuffers;
+        };
+
+        //! Allocate size bytes from the ring, may block on old frames if the ring is full
+        //! \return The ring offset or UINT64_MAX if the allocation can't fit at all
+        uint64_t AllocateRing(uint64_t size);
+
+        //! Get a staging region for the data, either the ring or a temporary buffer
+        //! \return false if failed
+        bool Stage(const void* data, uint64_t size, BufferOpDescriptor* outSrc);
+
+        //! Make sure the frame command buffer is recording
+        bool EnsureRecording();
+
+        //! Wait for the frame slot and reclaim its ring region and temporaries
+        void Retire(FrameData& frame);
+
+        const Device* m_device = nullptr;
+        ResourceStateTracker* m_tracker = nullptr;
+
+        StagingRing m_ring;
+
+        std::array<FrameData, Conf::SHIFT_MAX_FRAMES_IN_FLIGHT> m_frames;
+        uint32_t m_currentFrame = 0;
+
+        Stats m_stats{};
+    };
+} // Shift::VK
+
+#endif //SHIFT_UPLOADMANAGER_HPP
@@ -18,13 +18,22 @@ namespace Shift::VK {
                 flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
                 flags |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
                 break;
-            //! TODO [FEATURE] need to test whether support for these buffers works
+            //! Filled by uploads, cleared and read back with transfers
             case EBufferType::Storage:
+                flags |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+                flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
                 flags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
                 break;
+            //! Compute shaders write the arguments, so they are storage buffers too
             case EBufferType::Indirect:
+                flags |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+                flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                flags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
                 flags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
                 break;
+            case EBufferType::Readback:
+                flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                break;
         }
 
         return flags;
@@ -41,10 +50,14 @@ namespace Shift::VK {
             case EBufferType::Vertex:
             case EBufferType::Index:
                 break;
-            //! TODO [FEATURE] need to test whether support for these buffers works
             case EBufferType::Storage:
             case EBufferType::Indirect:
                 break;
+            //! Read by the CPU, so it wants cached memory
+            case EBufferType::Readback:
+                flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+                flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+                break;
         }
 
         return flags;
@@ -58,6 +71,13 @@ namespace Shift::VK {
         bufCreateInfo.size = m_desc.size;
         bufCreateInfo.usage = BufferTypeToUsageFlags(m_desc.type);
         bufCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        //! What async compute works on is shared with graphics, so it needs no ownership transfers between the queues
+        std::span<const uint32_t> sharingFamilies = m_device->GetComputeSharingFamilies();
+        if ((m_desc.type == EBufferType::Storage || m_desc.type == EBufferType::Indirect) && !sharingFamilies.empty()) {
+            bufCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(sharingFamilies.size());
+            bufCreateInfo.pQueueFamilyIndices = sharingFamilies.data();
+        }
 
         VmaAllocationCreateInfo allocCreateInfo = {};
         //! TODO [OPTIMIZATION]: Look into PREFER_GPU/CPU flags
@@ -84,6 +104,18 @@ namespace Shift::VK {
         vmaUnmapMemory(m_device->GetAllocator(), m_allocation);
     }
 
+    void Buffer::FlushMapped(uint64_t offset, uint64_t size) {
+        if ( VkCheck(vmaFlushAllocation(m_device->GetAllocator(), m_allocation, offset, size)) ) {
+            Log(Error, "Failed to flush buffer: {}", m_desc.name);
+        }
+    }
+
+    void Buffer::InvalidateMapped(uint64_t offset, uint64_t size) {
+        if ( VkCheck(vmaInvalidateAllocation(m_device->GetAllocator(), m_allocation, offset, size)) ) {
+            Log(Error, "Failed to invalidate buffer: {}", m_desc.name);
+        }
+    }
+
     void Buffer::Destroy() {
         vmaDestroyBuffer(m_device->GetAllocator(), m_buffer, m_allocation);
     }
@@ -11,6 +11,9 @@ namespace Shift::VK {
     class Buffer {
         friend Shift::VK::ResourceSet;
         friend Shift::VK::CommandBuffer;
+        friend class AsyncTransferQueue;
+        friend class BindlessHeap;
+        friend class ResourceStateTracker;
     public:
         Buffer() = default;
 
@@ -35,6 +38,16 @@ namespace Shift::VK {
         //! Unmap the mapped buffer
         void UnMap();
 
+        //! Flush host writes of a mapped range, a no-op for host coherent memory
+        //! \param offset offset into the buffer
+        //! \param size size of the range, VK_WHOLE_SIZE for everything
+        void FlushMapped(uint64_t offset, uint64_t size);
+
+        //! Make device writes of a mapped range visible to host reads, a no-op for host coherent memory
+        //! \param offset offset into the buffer
+        //! \param size size of the range, VK_WHOLE_SIZE for everything
+        void InvalidateMapped(uint64_t offset, uint64_t size);
+
         //! Fill buffer with data, works on MAPPED BUFFERS ONLY
         //! \tparam T data type
         //! \param data data
@@ -3,8 +3,10 @@
 #include "Utility/Vulkan/VKUtilInfo.hpp"
 #include "Utility/Vulkan/VKUtilRHI.hpp"
 #include <iostream>
+#include <algorithm>
 #include <array>
-#include <winsock2.h>
+#include <cassert>
+#include <vector>
 
 #include "VKBuffer.hpp"
 #include "VKPipeline.hpp"
@@ -12,16 +14,17 @@
 #include "VKTexture.hpp"
 
 namespace Shift::VK {
-    bool CommandBuffer::Init(const Device* device, const Instance* ins, VkCommandPool commandPool, EPoolQueueType type) {
+    bool CommandBuffer::Init(const Device* device, const Instance* ins, VkCommandPool commandPool, EPoolQueueType type, ECommandBufferLevel level) {
         m_device = device;
         m_ins = ins;
         m_poolType = type;
+        m_level = level;
 
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocInfo.commandPool = commandPool;
         // Primary can be submitted to the queue, secondary can be called from primary buffers and inversely
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.level = (IsSecondary()) ? VK_COMMAND_BUFFER_LEVEL_SECONDARY: VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         allocInfo.commandBufferCount = 1;
 
         if ( VkCheck(vkAllocateCommandBuffers(m_device->Get(), &allocInfo, &m_buffer)) ) {
@@ -30,10 +33,12 @@ namespace Shift::VK {
             return false;
         }
 
+        if (IsSecondary()) { return true; }
         return m_fence.Init(m_device, true);
     }
 
     void CommandBuffer::ResetFence() const {
+       if (IsSecondary()) { return; }
        m_fence.Reset();
     }
 
@@ -57,6 +62,23 @@ namespace Shift::VK {
         return true;
     }
 
+    bool CommandBuffer::VK_BeginSecondary(const VkCommandBufferInheritanceRenderingInfoKHR& renderingInfo) const {
+        assert(IsSecondary());
+
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext = &renderingInfo;
+
+        auto info = Util::CreateBeginCommandBufferInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT);
+        info.pInheritanceInfo = &inheritanceInfo;
+        if ( VkCheckV(vkBeginCommandBuffer(m_buffer, &info), res) ) {
+            Log(Error, "Failed to begin secondary command buffer! Code: {}", static_cast<int>(res));
+            return false;
+        }
+
+        return true;
+    }
+
     bool CommandBuffer::End() const {
         if ( VkCheckV(vkEndCommandBuffer(m_buffer), res)) {
             Log(Error, "Failed to end command buffer! Code: %d", static_cast<int>(res));
@@ -74,16 +96,20 @@ namespace Shift::VK {
         vkCmdCopyBuffer(m_buffer, srcBuf.buffer->VK_Get(), dstBuf.buffer->VK_Get(), 1, &copyRegion);
     }
 
+    void CommandBuffer::FillBuffer(const BufferOpDescriptor &dstBuf, uint64_t size, uint32_t value) const {
+        vkCmdFillBuffer(m_buffer, dstBuf.buffer->VK_Get(), dstBuf.offset, size, value);
+    }
+
     void CommandBuffer::CopyBufferToTexture(const BufferOpDescriptor& srcBuf, const TextureCopyDescriptor& dstTex) const {
         VkBufferImageCopy region{};
-        region.bufferOffset = 0;
+        region.bufferOffset = srcBuf.offset;
         region.bufferRowLength = 0;
         region.bufferImageHeight = 0;
 
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
+        region.imageSubresource.aspectMask = Util::ShiftToVKTextureAspect(dstTex.subresourceRange.aspect);
+        region.imageSubresource.mipLevel = dstTex.subresourceRange.baseMipLevel;
+        region.imageSubresource.baseArrayLayer = dstTex.subresourceRange.baseArrayLayer;
+        region.imageSubresource.layerCount = dstTex.subresourceRange.layerCount;
 
         region.imageOffset = {dstTex.offset.x, dstTex.offset.y, dstTex.offset.z };
         region.imageExtent = {
@@ -100,6 +126,58 @@ namespace Shift::VK {
         );
     }
 
+    void CommandBuffer::CopyTextureToBuffer(const TextureCopyDescriptor &srcTex, const BufferOpDescriptor &dstBuf) const {
+        VkBufferImageCopy region{};
+        region.bufferOffset = dstBuf.offset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+
+        region.imageSubresource.aspectMask = Util::ShiftToVKTextureAspect(srcTex.subresourceRange.aspect);
+        region.imageSubresource.mipLevel = srcTex.subresourceRange.baseMipLevel;
+        region.imageSubresource.baseArrayLayer = srcTex.subresourceRange.baseArrayLayer;
+        region.imageSubresource.layerCount = srcTex.subresourceRange.layerCount;
+
+        region.imageOffset = {srcTex.offset.x, srcTex.offset.y, srcTex.offset.z };
+        region.imageExtent = {
+                srcTex.size.x, srcTex.size.y, srcTex.size.z
+        };
+
+        vkCmdCopyImageToBuffer(
+            m_buffer,
+            srcTex.texture->GetImage(),
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            dstBuf.buffer->VK_Get(),
+            1,
+            &region
+        );
+    }
+
+    void CommandBuffer::VK_CopyImage(VkImage srcImage, VkImage dstImage, VkImageAspectFlags aspect, VkExtent3D extent,
+        uint32_t mipCount, uint32_t layerCount, uint32_t srcBaseMip) const
+    {
+        std::vector<VkImageCopy> regions(mipCount);
+        for (uint32_t mip = 0; mip < mipCount; ++mip) {
+            VkImageCopy& region = regions[mip];
+            region.srcSubresource = {aspect, srcBaseMip + mip, 0, layerCount};
+            region.dstSubresource = {aspect, mip, 0, layerCount};
+            region.extent = {
+                std::max(extent.width >> mip, 1u),
+                std::max(extent.height >> mip, 1u),
+                std::max(extent.depth >> mip, 1u)
+            };
+        }
+
+        vkCmdCopyImage(
+            m_buffer,
+            srcImage,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            dstImage,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(regions.size()),
+            regions.data()
+        );
+    }
+
     void CommandBuffer::VK_TransferImageLayout(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
                                             VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage,
                                             VkImageSubresourceRange subresourceRange) const {
@@ -186,7 +264,21 @@ namespace Shift::VK {
         VK_TransferImageLayout(image, oldLayout, newLayout, srcStage, dstStage, subresourceRange);
     }
 
+    void CommandBuffer::ExecuteCommands(std::span<CommandBuffer* const> secondaries) const {
+        if (secondaries.empty()) { return; }
+
+        std::vector<VkCommandBuffer> buffers;
+        buffers.reserve(secondaries.size());
+        for (const CommandBuffer* cmd: secondaries) {
+            assert(cmd->IsSecondary());
+            buffers.push_back(cmd->VK_Get());
+        }
+
+        vkCmdExecuteCommands(m_buffer, static_cast<uint32_t>(buffers.size()), buffers.data());
+    }
+
     void CommandBuffer::Destroy() {
+        if (IsSecondary()) { return; }
         m_fence.Destroy();
     }
 
@@ -208,6 +300,26 @@ namespace Shift::VK {
         );
     }
 
+    void CommandBuffer::VK_PipelineBarrier2(const VkDependencyInfoKHR &dependencyInfo) const {
+        m_ins->CallPipelineBarrier2External(m_buffer, dependencyInfo);
+    }
+
+    void CommandBuffer::VK_ResetQueryPool(VkQueryPool pool, uint32_t firstQuery, uint32_t queryCount) const {
+        vkCmdResetQueryPool(m_buffer, pool, firstQuery, queryCount);
+    }
+
+    void CommandBuffer::VK_WriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool pool, uint32_t query) const {
+        vkCmdWriteTimestamp(m_buffer, stage, pool, query);
+    }
+
+    void CommandBuffer::VK_BeginQuery(VkQueryPool pool, uint32_t query, VkQueryControlFlags flags) const {
+        vkCmdBeginQuery(m_buffer, pool, query, flags);
+    }
+
+    void CommandBuffer::VK_EndQuery(VkQueryPool pool, uint32_t query) const {
+        vkCmdEndQuery(m_buffer, pool, query);
+    }
+
     void CommandBuffer::VK_SetPipelineBarrierImage(
         VkPipelineStageFlags srcStage,
         VkPipelineStageFlags dstStage,
@@ -217,20 +329,24 @@ namespace Shift::VK {
         VK_SetPipelineBarrier(srcStage, dstStage, {&imgBarrier, 1}, {}, {}, flags);
     }
 
-    bool CommandBuffer::Submit() const {
-        VkSubmitInfo info = Util::CreateSubmitInfo({}, {}, {&m_buffer, 1}, 0);
-        VkQueue submitQueue;
+    VkQueue CommandBuffer::GetSubmitQueue() const {
         switch (m_poolType) {
             case EPoolQueueType::Graphics:
-                submitQueue = m_device->GetGraphicsQueue();
-                break;
+                return m_device->GetGraphicsQueue();
             case EPoolQueueType::Transfer:
-                submitQueue = m_device->GetTransferQueue();
-                break;
+                return m_device->GetTransferQueue();
+            case EPoolQueueType::Compute:
+                return m_device->GetComputeQueue();
             default:
                 Log(Error, "Invalid pool type!");
-                return false;
+                return VK_NULL_HANDLE;
         }
+    }
+
+    bool CommandBuffer::Submit() const {
+        VkSubmitInfo info = Util::CreateSubmitInfo({}, {}, {&m_buffer, 1}, 0);
+        VkQueue submitQueue = GetSubmitQueue();
+        if (submitQueue == VK_NULL_HANDLE) { return false; }
 
         if (int res = vkQueueSubmit(submitQueue,
                                     1,
@@ -250,19 +366,57 @@ namespace Shift::VK {
                 std::span{&m_buffer, 1},
                 waitStages.data()
         );
-        VkQueue submitQueue;
-        switch (m_poolType) {
-            case EPoolQueueType::Graphics:
-                submitQueue = m_device->GetGraphicsQueue();
-                break;
-            case EPoolQueueType::Transfer:
-                submitQueue = m_device->GetTransferQueue();
-                break;
-            default:
-                Log(Error, "Invalid pool type!");
-                return false;
+        VkQueue submitQueue = GetSubmitQueue();
+        if (submitQueue == VK_NULL_HANDLE) { return false; }
+
+        if (int res = vkQueueSubmit(submitQueue,
+                                    1,
+                                    &info,
+                                    m_fence.Get()); res != VK_SUCCESS) {
+            Log(Error, "Failed to submit to queue! Code: {}", res);
+            return false;
+        }
+        return true;
+    }
+
+    bool CommandBuffer::VK_Submit(std::span<const VkSemaphore> waitSemaphores,
+                                  std::span<const VkPipelineStageFlags> waitStages,
+                                  std::span<const uint64_t> waitValues,
+                                  std::span<const VkSemaphore> sigSemaphores,
+                                  std::span<const uint64_t> sigValues,
+                                  std::span<const VkCommandBuffer> precedingBuffers) const
+    {
+        assert(waitSemaphores.size() == waitStages.size());
+        assert(waitValues.empty() || waitValues.size() == waitSemaphores.size());
+        assert(sigValues.empty() || sigValues.size() == sigSemaphores.size());
+
+        VkSubmitInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        info.pWaitSemaphores = waitSemaphores.data();
+        info.pWaitDstStageMask = waitStages.data();
+        info.signalSemaphoreCount = static_cast<uint32_t>(sigSemaphores.size());
+        info.pSignalSemaphores = sigSemaphores.data();
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(sigValues.size());
+        timelineInfo.pSignalSemaphoreValues = sigValues.data();
+        if (!waitValues.empty() || !sigValues.empty()) {
+            info.pNext = &timelineInfo;
         }
 
+        //! Within a batch the buffers start in order, this one goes last
+        std::vector<VkCommandBuffer> buffers(precedingBuffers.begin(), precedingBuffers.end());
+        buffers.push_back(m_buffer);
+        info.commandBufferCount = static_cast<uint32_t>(buffers.size());
+        info.pCommandBuffers = buffers.data();
+
+        VkQueue submitQueue = GetSubmitQueue();
+        if (submitQueue == VK_NULL_HANDLE) { return false; }
+
         if (int res = vkQueueSubmit(submitQueue,
                                     1,
                                     &info,
@@ -324,6 +478,23 @@ namespace Shift::VK {
         vkCmdBindPipeline(m_buffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.VK_Get());
     }
 
+    void CommandBuffer::BindComputePipeline(const Pipeline &pipeline) const {
+        vkCmdBindPipeline(m_buffer, VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.VK_Get());
+    }
+
+    void CommandBuffer::PushConstants(const Pipeline &pipeline, const void *data, uint32_t size, uint32_t offset) const {
+        //! Every stage of every range the bytes overlap has to be named, pushes should not straddle ranges of different stages
+        VkShaderStageFlags stages = 0;
+        for (const auto& range: pipeline.GetDescriptor().pushConstantRanges) {
+            if (offset < range.offset + range.size && range.offset < offset + size) {
+                stages |= Util::ShiftToVKBindingVisibility(range.stages);
+            }
+        }
+        assert(stages != 0 && "Push constants outside of the pipeline push constant ranges!");
+
+        vkCmdPushConstants(m_buffer, pipeline.VK_GetLayout(), stages, offset, size, data);
+    }
+
     void CommandBuffer::VK_BeginRenderPass(VkRenderingInfoKHR info) const {
         m_ins->CallBeginRenderingExternal(m_buffer, info);
     }
@@ -364,6 +535,23 @@ namespace Shift::VK {
         vkCmdDraw(m_buffer, drawConf.vertexCount, drawConf.instanceCount, drawConf.firstVertex, drawConf.firstInstance);
     }
 
+    void CommandBuffer::DrawIndexedIndirect(const BufferOpDescriptor &args, uint32_t drawCount, uint32_t stride) const {
+        static_assert(sizeof(DrawIndexedConfig) == sizeof(VkDrawIndexedIndirectCommand), "Indirect buffers hold DrawIndexedConfig as is");
+        vkCmdDrawIndexedIndirect(m_buffer, args.buffer->VK_Get(), args.offset, drawCount, stride);
+    }
+
+    void CommandBuffer::DrawIndexedIndirectCount(const BufferOpDescriptor &args, const BufferOpDescriptor &count, uint32_t maxDrawCount, uint32_t stride) const {
+        vkCmdDrawIndexedIndirectCount(m_buffer, args.buffer->VK_Get(), args.offset, count.buffer->VK_Get(), count.offset, maxDrawCount, stride);
+    }
+
+    void CommandBuffer::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const {
+        vkCmdDispatch(m_buffer, groupCountX, groupCountY, groupCountZ);
+    }
+
+    void CommandBuffer::DispatchIndirect(const BufferOpDescriptor &buffer) const {
+        vkCmdDispatchIndirect(m_buffer, buffer.buffer->VK_Get(), buffer.offset);
+    }
+
     void
     CommandBuffer::BlitTexture(const TextureBlitData& srcTexture, const TextureBlitData& dstTexture, const TextureBlitRegion& blitRegion, EFilterMode filter) const {
 
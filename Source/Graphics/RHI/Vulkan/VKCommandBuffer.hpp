@@ -14,9 +14,11 @@ namespace Shift::VK {
     public:
         CommandBuffer() = default;
 
-        [[nodiscard]] bool Init(const Device* device, const Instance* ins, VkCommandPool commandPool, EPoolQueueType type);
+        //! Allocate the buffer from the pool, secondary buffers get no fence as they are never submitted directly
+        [[nodiscard]] bool Init(const Device* device, const Instance* ins, VkCommandPool commandPool, EPoolQueueType type, ECommandBufferLevel level = ECommandBufferLevel::Primary);
 
         [[nodiscard]] bool IsAvailable() const { return m_fence.Status() == VK_SUCCESS; }
+        [[nodiscard]] bool IsSecondary() const { return m_level == ECommandBufferLevel::Secondary; }
 
         ///! ------------------- Basic Buffer Commands ------------------- !///
 
@@ -30,7 +32,13 @@ namespace Shift::VK {
         //! \return true if successful, false otherwise
         [[nodiscard]] bool Begin() const;
 
-        //! Begin command buffer
+        //! [VK backend only function] Begin a secondary command buffer that continues a dynamic rendering pass.
+        //! The attachment formats have to match the pass it gets executed in, dynamic state is not inherited.
+        //! \param renderingInfo formats of the pass attachments
+        //! \return true if successful, false otherwise
+        [[nodiscard]] bool VK_BeginSecondary(const VkCommandBufferInheritanceRenderingInfoKHR& renderingInfo) const;
+
+        //! End command buffer
         //! \return true if successful, false otherwise
         [[nodiscard]] bool End() const;
 
@@ -59,6 +67,22 @@ namespace Shift::VK {
         //! \return true if successful, false otherwise
         [[nodiscard]] bool Submit(const Semaphore& waitSemaphore, const Semaphore& sigSemaphore) const;
 
+        //! [VK backend only function] Submit with an arbitrary set of binary and timeline semaphores.
+        //! Values are parallel to the semaphore spans, binary semaphores take 0. Leave the value spans empty when no timeline is involved.
+        //! \param waitSemaphores semaphores to wait on
+        //! \param waitStages stage each wait semaphore blocks
+        //! \param waitValues timeline values to wait for
+        //! \param sigSemaphores semaphores to signal
+        //! \param sigValues timeline values to signal
+        //! \param precedingBuffers primary buffers submitted in the same batch right before this one, covered by this buffer's fence
+        //! \return true if successful, false otherwise
+        [[nodiscard]] bool VK_Submit(std::span<const VkSemaphore> waitSemaphores,
+                                     std::span<const VkPipelineStageFlags> waitStages,
+                                     std::span<const uint64_t> waitValues,
+                                     std::span<const VkSemaphore> sigSemaphores,
+                                     std::span<const uint64_t> sigValues,
+                                     std::span<const VkCommandBuffer> precedingBuffers = {}) const;
+
         //! Submit the buffer to a GPU queue (default info) and Wait for completion
         //! \return true if successful, false otherwise
         [[nodiscard]] bool SubmitAndWait() const;
@@ -81,8 +105,28 @@ namespace Shift::VK {
         //! \param srcTex texture + size to copy + offset + subresource range
         void CopyBufferToTexture(const BufferOpDescriptor& srcBuf, const TextureCopyDescriptor& dstTex) const;
 
-        // TODO: [FEATURE]
-        // void CopyTextureToBuffer(TextureCopyDescriptor srcTex, BufferOpDescriptor dstBuf, uint32_t size);
+        //! [VK backend only function] Copy the mips and layers of an image into an image of the same format, source mip
+        //! srcBaseMip + i goes to destination mip i
+        //! \param srcImage image in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+        //! \param dstImage image in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+        //! \param aspect aspects to copy
+        //! \param extent size of destination mip 0
+        //! \param mipCount mips to copy, every destination mip
+        //! \param layerCount layer count of both images
+        //! \param srcBaseMip first source mip, above 0 to drop the top mips
+        void VK_CopyImage(VkImage srcImage, VkImage dstImage, VkImageAspectFlags aspect, VkExtent3D extent, uint32_t mipCount, uint32_t layerCount, uint32_t srcBaseMip = 0) const;
+
+        //! Fill a buffer range with a repeated 32 bit value, outside of a render pass
+        //! \param dstBuf buffer + offset into the buffer, multiple of 4
+        //! \param size bytes to fill, multiple of 4
+        //! \param value the value
+        void FillBuffer(const BufferOpDescriptor& dstBuf, uint64_t size, uint32_t value) const;
+
+        //! Copy a texture region into a buffer, tightly packed
+        //! \param srcTex texture in TransferSrcOptimal + size to copy + offset + subresource range
+        //! \param dstBuf buffer + offset into the buffer
+        void CopyTextureToBuffer(const TextureCopyDescriptor& srcTex, const BufferOpDescriptor& dstBuf) const;
+
         // TODO: [FEATURE]
         // void CopyTextureToTexture(TextureCopyDescriptor srcTex, TextureCopyDescriptor dstTex);
 
@@ -113,6 +157,17 @@ namespace Shift::VK {
         //! \param pipeline The Pipeline wrapper
         void BindGraphicsPipeline(const Pipeline& pipeline) const;
 
+        //! Bind the compute pipeline, it doesn't disturb the bound graphics pipeline
+        //! \param pipeline The Pipeline wrapper
+        void BindComputePipeline(const Pipeline& pipeline) const;
+
+        //! Update push constants, the stages are the ones of the pipeline ranges the bytes fall into
+        //! \param pipeline pipeline whose layout the constants are pushed through
+        //! \param data source data
+        //! \param size data size, multiple of 4
+        //! \param offset offset into the push constant block, multiple of 4
+        void PushConstants(const Pipeline& pipeline, const void* data, uint32_t size, uint32_t offset) const;
+
         //! [VK backend only function] Expects a higher level RHI manager to fill in the API specific data
         //! \param descriptorSets range of ds
         //! \param dynamicOffsets dynamic offsets if any
@@ -133,6 +188,32 @@ namespace Shift::VK {
         //! \param drawConf draw configuration
         void Draw(const DrawConfig& drawConf) const;
 
+        //! Draw indexed with the commands read from a buffer
+        //! \param args buffer + offset of the first DrawIndexedConfig (laid out like VkDrawIndexedIndirectCommand)
+        //! \param drawCount commands to draw
+        //! \param stride bytes between the commands
+        void DrawIndexedIndirect(const BufferOpDescriptor& args, uint32_t drawCount, uint32_t stride) const;
+
+        //! Draw indexed with the commands and their count read from buffers, needs Device::HasDrawIndirectCount
+        //! \param args buffer + offset of the first DrawIndexedConfig
+        //! \param count buffer + offset of the uint32_t draw count
+        //! \param maxDrawCount upper bound of the count
+        //! \param stride bytes between the commands
+        void DrawIndexedIndirectCount(const BufferOpDescriptor& args, const BufferOpDescriptor& count, uint32_t maxDrawCount, uint32_t stride) const;
+
+        //! Run the bound compute pipeline, outside of a render pass
+        //! \param groupCountX workgroups in x
+        //! \param groupCountY workgroups in y
+        //! \param groupCountZ workgroups in z
+        void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const;
+
+        //! Run the bound compute pipeline with the workgroup counts read from a buffer
+        //! \param buffer buffer + offset of a VkDispatchIndirectCommand, the offset is a multiple of 4
+        void DispatchIndirect(const BufferOpDescriptor& buffer) const;
+
+        //! Execute secondary command buffers, inside a render pass it has to be begun with secondary contents
+        //! \param secondaries recorded and ended secondary buffers
+        void ExecuteCommands(std::span<CommandBuffer* const> secondaries) const;
 
         ///! ------------------- Mics Buffer Commands ------------------- !///
 
@@ -165,6 +246,10 @@ namespace Shift::VK {
                                    std::span<VkBufferMemoryBarrier> bufMemSpan,
                                    VkDependencyFlags flags) const;
 
+        //! [VK backend only function] Record a synchronization2 barrier batch
+        //! \param dependencyInfo all the barriers of the batch
+        void VK_PipelineBarrier2(const VkDependencyInfoKHR& dependencyInfo) const;
+
         //! [VK backend only function] Set image pipeline barrier at transition
         //! \param srcStage
         //! \param dstStage
@@ -205,6 +290,31 @@ namespace Shift::VK {
                 VkPipelineStageFlags dstStage,
                 bool isDepth = false) const;
 
+        ///! ------------------- Query Commands ------------------- !///
+
+        //! [VK backend only function] Reset a range of queries, has to happen outside of a render pass
+        //! \param pool query pool
+        //! \param firstQuery first query to reset
+        //! \param queryCount query count
+        void VK_ResetQueryPool(VkQueryPool pool, uint32_t firstQuery, uint32_t queryCount) const;
+
+        //! [VK backend only function] Write a timestamp once the previous commands are done with the stage
+        //! \param stage pipeline stage
+        //! \param pool timestamp query pool
+        //! \param query query index
+        void VK_WriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool pool, uint32_t query) const;
+
+        //! [VK backend only function] Begin a query, a query begun inside a render pass has to end in it
+        //! \param pool query pool
+        //! \param query query index
+        //! \param flags VK_QUERY_CONTROL_PRECISE_BIT for exact occlusion counts
+        void VK_BeginQuery(VkQueryPool pool, uint32_t query, VkQueryControlFlags flags) const;
+
+        //! [VK backend only function] End a query
+        //! \param pool query pool
+        //! \param query query index
+        void VK_EndQuery(VkQueryPool pool, uint32_t query) const;
+
         // TODO: Temporary
         [[nodiscard]] VkCommandBuffer VK_Get() const { return m_buffer; }
         [[nodiscard]] const VkCommandBuffer* VK_Ptr() const { return &m_buffer; }
@@ -212,6 +322,9 @@ namespace Shift::VK {
         void Destroy();
         ~CommandBuffer() = default;
     private:
+        //! Get the queue matching the pool type, VK_NULL_HANDLE for unsupported pools
+        [[nodiscard]] VkQueue GetSubmitQueue() const;
+
         const Device* m_device = nullptr;
         const Instance* m_ins = nullptr;
 
@@ -220,6 +333,7 @@ namespace Shift::VK {
         Fence m_fence;
 
         EPoolQueueType m_poolType = EPoolQueueType::Graphics;
+        ECommandBufferLevel m_level = ECommandBufferLevel::Primary;
     };
 
     ASSERT_INTERFACE(ICommandBuffer, CommandBuffer);
@@ -4,11 +4,16 @@
 
 #include "VKMacros.hpp"
 
+#include <algorithm>
+#include <string_view>
+
 namespace Shift::VK {
     bool Device::Init(const Instance &inst, VkSurfaceKHR surface, const VkPhysicalDeviceFeatures& deviceFeatures) {
         if (!PickPhysicalDevice(inst.Get(), surface)) return false;
         if (!CreateLogicalDevice(deviceFeatures, surface))  return false;
         if (!CreateAllocator(inst.Get()))  return false;
+
+        return true;
     }
 
     void Device::Destroy() {
@@ -25,12 +30,15 @@ namespace Shift::VK {
         std::set<uint32_t> uniqueQueueFamilies = {
                 m_queueFamilyIndices.graphicsFamily.value(),
                 m_queueFamilyIndices.presentFamily.value(),
-                m_queueFamilyIndices.transferFamily.value()
+                m_queueFamilyIndices.transferFamily.value(),
+                m_queueFamilyIndices.computeFamily.value()
         };
 
         Log(Trace, "Graphics family: " + std::to_string(*m_queueFamilyIndices.graphicsFamily));
         Log(Trace, "Transfer family: " + std::to_string(*m_queueFamilyIndices.transferFamily));
         Log(Trace, "Present family: " + std::to_string(*m_queueFamilyIndices.presentFamily));
+        Log(Trace, "Compute family: " + std::to_string(*m_queueFamilyIndices.computeFamily));
+        m_computeSharingFamilies = {m_queueFamilyIndices.graphicsFamily.value(), m_queueFamilyIndices.computeFamily.value()};
 
         for (uint32_t queueFamily : uniqueQueueFamilies) {
             VkDeviceQueueCreateInfo queueCreateInfo{};
@@ -46,19 +54,73 @@ namespace Shift::VK {
         // TODO: make this congigurable through constructor
         VkPhysicalDeviceFeatures physDeviceFeatures{ deviceFeatures };
 
-        const VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeature {
+        //! Profiling only, passes just don't get the counters where these are missing
+        VkPhysicalDeviceFeatures supportedFeatures{};
+        vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+        physDeviceFeatures.pipelineStatisticsQuery |= supportedFeatures.pipelineStatisticsQuery;
+        physDeviceFeatures.occlusionQueryPrecise |= supportedFeatures.occlusionQueryPrecise;
+        //! GPU driven draws, many commands per indirect call that pick their instance data through firstInstance
+        physDeviceFeatures.multiDrawIndirect |= supportedFeatures.multiDrawIndirect;
+        physDeviceFeatures.drawIndirectFirstInstance |= supportedFeatures.drawIndirectFirstInstance;
+        m_enabledFeatures = physDeviceFeatures;
+
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeature {
                 .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
                 .dynamicRendering = VK_TRUE
         };
 
+        //! The resource state tracker flushes its barriers with vkCmdPipelineBarrier2
+        VkPhysicalDeviceSynchronization2FeaturesKHR sync2Feature {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
+                .pNext = &dynamicRenderingFeature,
+                .synchronization2 = VK_TRUE
+        };
+
+        //! Timeline semaphores are a required 1.2 feature, they drive the async transfer tokens
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12Features.pNext = &sync2Feature;
+        vulkan12Features.timelineSemaphore = VK_TRUE;
+        //! Descriptor indexing for the bindless heap, support is checked when rating the devices
+        vulkan12Features.descriptorIndexing = VK_TRUE;
+        vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+        vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+        //! Optional, without it the draw count of indirect draws can't come from a buffer
+        VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+        supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceFeatures2 supportedFeatures2{};
+        supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures2.pNext = &supportedVulkan12Features;
+        vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supportedFeatures2);
+        vulkan12Features.drawIndirectCount = supportedVulkan12Features.drawIndirectCount;
+        m_hasDrawIndirectCount = supportedVulkan12Features.drawIndirectCount == VK_TRUE;
+
+        //! Optional, without it VMA estimates the budget from the heap sizes
+        std::vector<const char*> extensions = Util::GetDeviceExtensions(surface == VK_NULL_HANDLE);
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> supportedExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, supportedExtensions.data());
+        m_hasMemoryBudget = std::ranges::any_of(supportedExtensions, [](const VkExtensionProperties& ext) {
+            return std::string_view{ext.extensionName} == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+        });
+        if (m_hasMemoryBudget) {
+            extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        createInfo.pNext = &dynamicRenderingFeature;
+        createInfo.pNext = &vulkan12Features;
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
         createInfo.pEnabledFeatures = &physDeviceFeatures;
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(Util::DEVICE_EXTENSIONS.size());
-        createInfo.ppEnabledExtensionNames = Util::DEVICE_EXTENSIONS.data();
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+        createInfo.ppEnabledExtensionNames = extensions.data();
 #if SHIFT_VALIDATION
             createInfo.enabledLayerCount = static_cast<uint32_t>(Util::VALIDATION_LAYERS.size());
             createInfo.ppEnabledLayerNames = Util::VALIDATION_LAYERS.data();
@@ -74,6 +136,7 @@ namespace Shift::VK {
         vkGetDeviceQueue(m_device, m_queueFamilyIndices.graphicsFamily.value(), 0, &m_graphicsQueue);
         vkGetDeviceQueue(m_device, m_queueFamilyIndices.presentFamily.value(), 0, &m_presentQueue);
         vkGetDeviceQueue(m_device, m_queueFamilyIndices.transferFamily.value(), 0, &m_transferQueue);
+        vkGetDeviceQueue(m_device, m_queueFamilyIndices.computeFamily.value(), 0, &m_computeQueue);
 
         return true;
     }
@@ -110,6 +173,9 @@ namespace Shift::VK {
         }
 
         vkGetPhysicalDeviceProperties(m_physicalDevice, &m_deviceProperties);
+        if (m_deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU) {
+            Log(Warning, "No GPU found, running on the software device {}", m_deviceProperties.deviceName);
+        }
 
         if (m_deviceProperties.limits.timestampPeriod == 0) {
             LogVerbose(Critical, "GPU does not support timestemp queries!");
@@ -177,6 +243,12 @@ namespace Shift::VK {
         vkDestroyCommandPool(m_device, pool, nullptr);
     }
 
+    void Device::ResetCommandPool(VkCommandPool pool) const {
+        if ( VkCheck(vkResetCommandPool(m_device, pool, 0)) ) {
+            Log(Error, "Failed to reset VkCommandPool!");
+        }
+    }
+
     VkRenderPass Device::CreateRenderPass(const VkRenderPassCreateInfo &info) const {
         VkRenderPass pass;
         if (VkCheck(vkCreateRenderPass(m_device, &info, nullptr, &pass)) ) {
@@ -205,19 +277,41 @@ namespace Shift::VK {
         vkDestroyShaderModule(m_device, module, nullptr);
     }
 
-    VkPipeline Device::CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo &info) const {
+    VkPipeline Device::CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo &info, VkPipelineCache cache) const {
         VkPipeline pipeline;
-        if ( VkCheck(vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &info, nullptr, &pipeline)) ) {
+        if ( VkCheck(vkCreateGraphicsPipelines(m_device, cache, 1, &info, nullptr, &pipeline)) ) {
             Log(Error, "Failed to create VkPipeline!");
             return VK_NULL_HANDLE;
         }
         return pipeline;
     }
 
+    VkPipeline Device::CreateComputePipeline(const VkComputePipelineCreateInfo &info, VkPipelineCache cache) const {
+        VkPipeline pipeline;
+        if ( VkCheck(vkCreateComputePipelines(m_device, cache, 1, &info, nullptr, &pipeline)) ) {
+            Log(Error, "Failed to create compute VkPipeline!");
+            return VK_NULL_HANDLE;
+        }
+        return pipeline;
+    }
+
     void Device::DestroyPipeline(VkPipeline pipeline) const {
         vkDestroyPipeline(m_device, pipeline, nullptr);
     }
 
+    VkPipelineCache Device::CreatePipelineCache(const VkPipelineCacheCreateInfo &info) const {
+        VkPipelineCache cache;
+        if ( VkCheck(vkCreatePipelineCache(m_device, &info, nullptr, &cache)) ) {
+            Log(Error, "Failed to create VkPipelineCache!");
+            return VK_NULL_HANDLE;
+        }
+        return cache;
+    }
+
+    void Device::DestroyPipelineCache(VkPipelineCache cache) const {
+        vkDestroyPipelineCache(m_device, cache, nullptr);
+    }
+
     VkPipelineLayout Device::CreatePipelineLayout(const VkPipelineLayoutCreateInfo& info) const {
         VkPipelineLayout pipelineLayout;
         if ( VkCheck(vkCreatePipelineLayout(m_device, &info, nullptr, &pipelineLayout)) ) {
@@ -257,6 +351,19 @@ namespace Shift::VK {
         vkDestroyDescriptorPool(m_device, pool, nullptr);
     }
 
+    VkDescriptorUpdateTemplate Device::CreateDescriptorUpdateTemplate(const VkDescriptorUpdateTemplateCreateInfo &info) const {
+        VkDescriptorUpdateTemplate updateTemplate;
+        if ( VkCheck(vkCreateDescriptorUpdateTemplate(m_device, &info, nullptr, &updateTemplate)) ) {
+            Log(Error, "Failed to create VkDescriptorUpdateTemplate!");
+            return VK_NULL_HANDLE;
+        }
+        return updateTemplate;
+    }
+
+    void Device::DestroyDescriptorUpdateTemplate(VkDescriptorUpdateTemplate updateTemplate) const {
+        vkDestroyDescriptorUpdateTemplate(m_device, updateTemplate, nullptr);
+    }
+
     VkDescriptorSet Device::AllocateDescriptorSet(const VkDescriptorSetAllocateInfo &info, VkResult *result) const {
         VkDescriptorSet dset;
         *result = vkAllocateDescriptorSets(m_device, &info, &dset);
@@ -265,7 +372,8 @@ namespace Shift::VK {
 
     bool Device::CreateAllocator(VkInstance instance) {
         VmaAllocatorCreateInfo allocatorCreateInfo{};
-        allocatorCreateInfo.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        //! The flag needs the extension enabled on the device, VMA queries the real budget through it
+        allocatorCreateInfo.flags = m_hasMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0;
         allocatorCreateInfo.vulkanApiVersion = Conf::VULKAN_VERSION;
         allocatorCreateInfo.physicalDevice = m_physicalDevice;
         allocatorCreateInfo.device = m_device;
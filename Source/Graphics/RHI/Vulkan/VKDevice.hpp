@@ -5,6 +5,9 @@
 #ifndef SHIFT_VKDEVICE_HPP
 #define SHIFT_VKDEVICE_HPP
 
+#include <array>
+#include <span>
+
 #include "vk_mem_alloc.h"
 
 #include "Utility/Vulkan/VKUtilCore.hpp"
@@ -20,7 +23,7 @@ namespace Shift::VK {
 
         //! Initialize the device
         //! \param inst Instance Vulkan Wrapper
-        //! \param surface Window surface
+        //! \param surface Window surface, VK_NULL_HANDLE for a headless device without a swapchain
         //! \param deviceFeaturesThe physical device features that we want to have supported
         //! \return false if init failed, else true
         bool Init(const Instance &inst, VkSurfaceKHR surface, const VkPhysicalDeviceFeatures& deviceFeatures = { .samplerAnisotropy = VK_TRUE });
@@ -68,6 +71,9 @@ namespace Shift::VK {
         //! Destroy a VkCommandPool
         //! \param pool VkCommandPool to destroy
         void DestroyCommandPool(VkCommandPool pool) const;
+        //! Reset every command buffer allocated from the pool at once
+        //! \param pool VkCommandPool to reset
+        void ResetCommandPool(VkCommandPool pool) const;
 
         //! Create a VkShaderModule
         //! \param info VkShaderModuleCreateInfo
@@ -87,12 +93,26 @@ namespace Shift::VK {
 
         //! Create a VkPipeline
         //! \param info VkGraphicsPipelineCreateInfo
+        //! \param cache pipeline cache to use, can be VK_NULL_HANDLE
+        //! \return VK_NULL_HANDLE if creation failed, else VkPipeline
+        [[nodiscard]] VkPipeline CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo& info, VkPipelineCache cache = VK_NULL_HANDLE) const;
+        //! Create a compute VkPipeline
+        //! \param info VkComputePipelineCreateInfo
+        //! \param cache pipeline cache to use, can be VK_NULL_HANDLE
         //! \return VK_NULL_HANDLE if creation failed, else VkPipeline
-        [[nodiscard]] VkPipeline CreateGraphicsPipeline(const VkGraphicsPipelineCreateInfo& info) const;
+        [[nodiscard]] VkPipeline CreateComputePipeline(const VkComputePipelineCreateInfo& info, VkPipelineCache cache = VK_NULL_HANDLE) const;
         //! Destroy a VkPipeline
         //! \param pool VkPipeline to destroy
         void DestroyPipeline(VkPipeline pipeline) const;
 
+        //! Create a VkPipelineCache
+        //! \param info VkPipelineCacheCreateInfo
+        //! \return VK_NULL_HANDLE if creation failed, else VkPipelineCache
+        [[nodiscard]] VkPipelineCache CreatePipelineCache(const VkPipelineCacheCreateInfo& info) const;
+        //! Destroy a VkPipelineCache
+        //! \param cache VkPipelineCache to destroy
+        void DestroyPipelineCache(VkPipelineCache cache) const;
+
         //! Create a VkPipelineLayout
         //! \param info VkPipelineLayoutCreateInfo
         //! \return VK_NULL_HANDLE if creation failed, else VkPipelineLayout
@@ -120,6 +140,14 @@ namespace Shift::VK {
         //! \param pool VkDescriptorPool to reset
         void ResetDescriptorPool(VkDescriptorPool pool) const;
 
+        //! Create a VkDescriptorUpdateTemplate
+        //! \param info VkDescriptorUpdateTemplateCreateInfo
+        //! \return VK_NULL_HANDLE if creation failed, else VkDescriptorUpdateTemplate
+        [[nodiscard]] VkDescriptorUpdateTemplate CreateDescriptorUpdateTemplate(const VkDescriptorUpdateTemplateCreateInfo& info) const;
+        //! Destroy a VkDescriptorUpdateTemplate
+        //! \param updateTemplate VkDescriptorUpdateTemplate to destroy
+        void DestroyDescriptorUpdateTemplate(VkDescriptorUpdateTemplate updateTemplate) const;
+
         //! Create a VkDescriptorSet
         //! \param info VkDescriptorSetAllocateInfo
         //! \param info result - a pointer to the error code - for external ckecking
@@ -149,7 +177,21 @@ namespace Shift::VK {
         [[nodiscard]] VkQueue GetGraphicsQueue() const { return m_graphicsQueue; }
         [[nodiscard]] VkQueue GetPresentQueue() const { return m_presentQueue; }
         [[nodiscard]] VkQueue GetTransferQueue() const { return m_transferQueue; }
+        [[nodiscard]] VkQueue GetComputeQueue() const { return m_computeQueue; }
         [[nodiscard]] const Util::QueueFamilyIndices& GetQueueFamilyIndices() const { return m_queueFamilyIndices; }
+        //! Requested features plus the optional ones the device happens to support (query precision and statistics)
+        [[nodiscard]] const VkPhysicalDeviceFeatures& GetEnabledFeatures() const { return m_enabledFeatures; }
+        //! Whether VK_EXT_memory_budget is enabled, the heap budgets are estimates without it
+        [[nodiscard]] bool HasMemoryBudget() const { return m_hasMemoryBudget; }
+        //! Whether vkCmdDrawIndexedIndirectCount can be used (drawIndirectCount)
+        [[nodiscard]] bool HasDrawIndirectCount() const { return m_hasDrawIndirectCount; }
+        //! Whether the compute queue is of a family of its own and can run next to the graphics one
+        [[nodiscard]] bool HasAsyncCompute() const { return m_queueFamilyIndices.computeFamily != m_queueFamilyIndices.graphicsFamily; }
+        //! Families that resources used by both graphics and async compute are shared between (concurrent sharing mode),
+        //! empty when there is no async compute and they stay exclusive
+        [[nodiscard]] std::span<const uint32_t> GetComputeSharingFamilies() const {
+            return (HasAsyncCompute()) ? std::span<const uint32_t>{m_computeSharingFamilies} : std::span<const uint32_t>{};
+        }
 
         void Destroy();
         ~Device() = default;
@@ -174,13 +216,19 @@ namespace Shift::VK {
         VkDevice m_device = VK_NULL_HANDLE;
         VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
         VkPhysicalDeviceProperties m_deviceProperties{};
+        VkPhysicalDeviceFeatures m_enabledFeatures{};
         VmaAllocator m_allocator = VK_NULL_HANDLE;
+        bool m_hasMemoryBudget = false;
+        bool m_hasDrawIndirectCount = false;
 
         VkQueue m_graphicsQueue = VK_NULL_HANDLE;
         VkQueue m_presentQueue = VK_NULL_HANDLE;
         VkQueue m_transferQueue = VK_NULL_HANDLE;
+        VkQueue m_computeQueue = VK_NULL_HANDLE;
 
         Util::QueueFamilyIndices m_queueFamilyIndices;
+        //! Graphics and compute families
+        std::array<uint32_t, 2> m_computeSharingFamilies{};
     };
 } // Shift::VK
 
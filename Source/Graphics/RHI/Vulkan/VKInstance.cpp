@@ -4,7 +4,7 @@
 #include "Config/EngineConfig.hpp"
 
 namespace Shift::VK {
-    bool Instance::Init(const std::string& appName, uint32_t appVersion, const std::string& engName, uint32_t engVersion)
+    bool Instance::Init(const std::string& appName, uint32_t appVersion, const std::string& engName, uint32_t engVersion, bool headless)
     {
         if (SHIFT_VALIDATION && !Util::CheckValidationLayerSupport()) {
             LogVerbose(Error, "Validation Layers are not available!");
@@ -25,7 +25,7 @@ namespace Shift::VK {
         createInfo.pApplicationInfo = &appInfo;
 
         // Handle extensions
-        auto extensions = Util::GetRequiredExtensions();
+        auto extensions = Util::GetRequiredExtensions(headless);
 
         // This here specifies extension data for vulkan
         createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
@@ -50,6 +50,7 @@ namespace Shift::VK {
         }
 
         if (!PollDynamicRenderingFunctions()) return false;
+        if (!PollSynchronization2Functions()) return false;
 
 #if SHIFT_VALIDATION
         if (!SetupDebugMessenger()) return false;
@@ -81,6 +82,17 @@ namespace Shift::VK {
         return true;
     }
 
+    bool Instance::PollSynchronization2Functions() {
+        vkCmdPipelineBarrier2KHR = (PFN_vkCmdPipelineBarrier2KHR) vkGetInstanceProcAddr(m_instance, "vkCmdPipelineBarrier2KHR");
+        if (!vkCmdPipelineBarrier2KHR)
+        {
+            LogVerbose(Critical, "Failed polling vkCmdPipelineBarrier2KHR function!");
+            return false;
+        }
+        Log(Info, "Polled vkCmdPipelineBarrier2KHR function!");
+        return true;
+    }
+
     void Instance::Destroy() {
 #if SHIFT_VALIDATION
             Util::DestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr);
@@ -23,8 +23,9 @@ namespace Shift::VK {
         //! \param appVersion The application version
         //! \param engName The name of the Engine (Always Shift)
         //! \param engVersion The engine version
+        //! \param headless No window surface will be created, so none of the GLFW extensions are requested
         //! \return True if initialization successful, false otherwise
-        bool Init(const std::string& appName, uint32_t appVersion, const std::string& engName, uint32_t engVersion);
+        bool Init(const std::string& appName, uint32_t appVersion, const std::string& engName, uint32_t engVersion, bool headless = false);
 
         //! Returns a Vk Instance handle
         //! \return VkInstance
@@ -37,6 +38,10 @@ namespace Shift::VK {
         //! Call the ext function EndRendering
         //! \param buff the command buffer
         void CallEndRenderingExternal(VkCommandBuffer buff) const { vkCmdEndRenderingKHR(buff); }
+        //! Call the ext function PipelineBarrier2
+        //! \param buff the command buffer
+        //! \param info dependency info with all the barriers
+        void CallPipelineBarrier2External(VkCommandBuffer buff, const VkDependencyInfoKHR& info) const { vkCmdPipelineBarrier2KHR(buff, &info); }
 
         //! Free the instance, should be done last
         void Destroy();
@@ -44,12 +49,14 @@ namespace Shift::VK {
     private:
         bool SetupDebugMessenger();
         bool PollDynamicRenderingFunctions();
+        bool PollSynchronization2Functions();
 
         VkInstance m_instance = VK_NULL_HANDLE;
         VkDebugUtilsMessengerEXT m_debugMessenger = VK_NULL_HANDLE;
 
         PFN_vkCmdBeginRenderingKHR vkCmdBeginRenderingKHR = VK_NULL_HANDLE;
         PFN_vkCmdEndRenderingKHR   vkCmdEndRenderingKHR = VK_NULL_HANDLE;
+        PFN_vkCmdPipelineBarrier2KHR vkCmdPipelineBarrier2KHR = VK_NULL_HANDLE;
     };
 } // Shift::VK
 
@@ -0,0 +1,31 @@
+#include "VKMemoryBlock.hpp"
+
+namespace Shift::VK {
+    bool MemoryBlock::Init(const Device *device, const TextureMemoryRequirements &requirements) {
+        m_device = device;
+
+        VkMemoryRequirements memoryRequirements{};
+        memoryRequirements.size = requirements.size;
+        memoryRequirements.alignment = requirements.alignment;
+        memoryRequirements.memoryTypeBits = requirements.memoryTypeBits;
+
+        //! No resource to deduce the usage from, so the flags are spelled out
+        VmaAllocationCreateInfo allocCreateInfo = {};
+        allocCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        allocCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        allocCreateInfo.priority = 1.0f;
+
+        if (VkCheck(vmaAllocateMemory(m_device->GetAllocator(), &memoryRequirements, &allocCreateInfo, &m_allocation, &m_allocationInfo))) {
+            Log(Warning, "Failed to allocate a {} byte memory block!", requirements.size);
+            m_allocation = VK_NULL_HANDLE;
+            return false;
+        }
+        return true;
+    }
+
+    void MemoryBlock::Destroy() {
+        if (m_allocation == VK_NULL_HANDLE) { return; }
+        vmaFreeMemory(m_device->GetAllocator(), m_allocation);
+        m_allocation = VK_NULL_HANDLE;
+    }
+} // Shift::VK
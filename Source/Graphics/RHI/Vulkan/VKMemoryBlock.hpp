@@ -0,0 +1,38 @@
+#ifndef SHIFT_VKMEMORYBLOCK_HPP
+#define SHIFT_VKMEMORYBLOCK_HPP
+
+#include "VKDevice.hpp"
+
+#include "Graphics/RHI/Texture.hpp"
+
+namespace Shift::VK {
+    //! A raw device local allocation with no resource bound to it, textures get placed into it at offsets and
+    //! textures whose lifetimes don't overlap can share the same bytes (transient render targets)
+    class MemoryBlock {
+    public:
+        MemoryBlock() = default;
+
+        //! Allocate the memory
+        //! \param device Device wrapper ptr
+        //! \param requirements size, alignment and the memory types every placed resource accepts
+        //! \return false if failed
+        [[nodiscard]] bool Init(const Device* device, const TextureMemoryRequirements& requirements);
+
+        [[nodiscard]] bool IsValid() const { return m_allocation != VK_NULL_HANDLE; }
+        [[nodiscard]] uint64_t GetSize() const { return m_allocationInfo.size; }
+
+        //! [VK backend only function]
+        [[nodiscard]] VmaAllocation VK_Get() const { return m_allocation; }
+
+        //! Every texture placed into the block has to be destroyed first
+        void Destroy();
+        ~MemoryBlock() = default;
+    private:
+        const Device* m_device = nullptr;
+
+        VmaAllocation m_allocation = VK_NULL_HANDLE;
+        VmaAllocationInfo m_allocationInfo{};
+    };
+} // Shift::VK
+
+#endif //SHIFT_VKMEMORYBLOCK_HPP
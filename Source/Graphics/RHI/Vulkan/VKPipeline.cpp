@@ -1,12 +1,38 @@
 #include "VKPipeline.hpp"
 
+#include <algorithm>
+
+#include "Config/EngineConfig.hpp"
+
 #include "Utility/Vulkan/VKUtilRHI.hpp"
 #include "Utility/Vulkan/VKUtilInfo.hpp"
 
 namespace Shift::VK {
-    void Pipeline::Init(const Device *device, const PipelineDescriptor &descriptor, const std::vector<ShaderStageDesc>& shaders, std::span<VkDescriptorSetLayout> descLayouts) {
+    void Pipeline::Init(const Device *device, const PipelineDescriptor &descriptor, const std::vector<ShaderStageDesc>& shaders, VkPipelineLayout layout, VkPipelineCache cache) {
         m_device = device;
         m_desc = descriptor;
+        m_layout = layout;
+
+        m_usesBindless = m_desc.descriptorLayouts.size() > Conf::SHIFT_BINDLESS_SET &&
+            std::ranges::any_of(m_desc.descriptorLayouts[Conf::SHIFT_BINDLESS_SET].bindings, &PipelineLayoutDescriptor::LayoutBindingDesc::isBindless);
+
+        if ( !(VkNullCheck(m_layout)) ) {
+            valid = false;
+            return;
+        }
+
+        auto computeStage = std::ranges::find(shaders, EShaderType::Compute, &ShaderStageDesc::type);
+        if (computeStage != shaders.end()) {
+            if (shaders.size() != 1) {
+                Log(Error, "A compute pipeline takes exactly one shader stage!");
+                valid = false;
+                return;
+            }
+            m_bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
+            m_pipeline = CreateCompute(*computeStage, cache);
+            valid = VkNullCheck(m_pipeline);
+            return;
+        }
 
         //! Shaders
         std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
@@ -70,20 +96,6 @@ namespace Shift::VK {
                                                       Util::ShiftToVKTextureFormat(descriptor.depthStencilConfig.stencilFormat)
                                                   );
 
-        //! Pipeline Layout
-        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descLayouts.size());
-        pipelineLayoutInfo.pSetLayouts = descLayouts.data();
-        pipelineLayoutInfo.pushConstantRangeCount = 0;
-        pipelineLayoutInfo.pPushConstantRanges = nullptr;
-
-        m_layout = m_device->CreatePipelineLayout(pipelineLayoutInfo);
-        if ( !(VkNullCheck(m_layout)) ) {
-            valid = false;
-            return;
-        }
-
         //! Pipeline itself
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -107,14 +119,24 @@ namespace Shift::VK {
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
         pipelineInfo.basePipelineIndex = -1; // Optional
 
-        m_pipeline = m_device->CreateGraphicsPipeline(pipelineInfo);
+        m_pipeline = m_device->CreateGraphicsPipeline(pipelineInfo, cache);
 
         valid = VkNullCheck(m_pipeline);
     }
 
-    //! Destroys pipeline and layout
+    VkPipeline Pipeline::CreateCompute(const ShaderStageDesc &shader, VkPipelineCache cache) const {
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage = shader.handle->VK_GetStageInfo();
+        pipelineInfo.layout = m_layout;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineInfo.basePipelineIndex = -1;
+
+        return m_device->CreateComputePipeline(pipelineInfo, cache);
+    }
+
+    //! Destroys the pipeline, the layout is shared and belongs to the layout cache
     void Pipeline::Destroy() {
         m_device->DestroyPipeline(m_pipeline);
-        m_device->DestroyPipelineLayout(m_layout);
     }
 } // shift
\ No newline at end of file
@@ -2,7 +2,6 @@
 #define SHIFT_VKPIPELINE_HPP
 
 #include <optional>
-#include <span>
 
 #include "VKDevice.hpp"
 #include "VKShader.hpp"
@@ -14,33 +13,45 @@ namespace Shift::VK {
     public:
         Pipeline() = default;
 
-        //! Initialize a pipeline
+        //! Initialize a pipeline, a single compute stage makes it a compute pipeline and the graphics state is ignored
         //! \param device
         //! \param descriptor The pipeline desc struct
         //! \param shaders The runtime built shader strcutures with type and Data
-        //! \param descLayouts The desc layouts have to already be created, for now we expect the API to create them beforehand
+        //! \param layout Shared pipeline layout matching the descriptor layouts, owned by the PipelineLayoutCache
+        //! \param cache pipeline cache to compile through, can be VK_NULL_HANDLE
         //! \return true if successful, false otherwise
-        [[nodiscard]] void Init(const Device* device, const PipelineDescriptor& descriptor, const std::vector<ShaderStageDesc>& shaders, std::span<VkDescriptorSetLayout> descLayouts);
+        [[nodiscard]] void Init(const Device* device, const PipelineDescriptor& descriptor, const std::vector<ShaderStageDesc>& shaders, VkPipelineLayout layout, VkPipelineCache cache = VK_NULL_HANDLE);
 
         [[nodiscard]] bool IsValid() const { return valid; }
+        [[nodiscard]] bool IsCompute() const { return m_bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE; }
 
         //! API SPECIFIC, DO NOT USE UNLESS NESSESARY IN RHI SPECIFIC CODE
         //! \return VkPipeline
         [[nodiscard]] VkPipeline VK_Get() const { return m_pipeline; }
         //! API SPECIFIC, DO NOT USE UNLESS NESSESARY IN RHI SPECIFIC CODE
-        //! \return VkPipelineLayout
+        //! \return VkPipelineLayout, shared with every pipeline of the same layout
         [[nodiscard]] VkPipelineLayout VK_GetLayout() const { return m_layout; }
+        //! API SPECIFIC, DO NOT USE UNLESS NESSESARY IN RHI SPECIFIC CODE
+        //! \return where sets and the pipeline itself get bound
+        [[nodiscard]] VkPipelineBindPoint VK_GetBindPoint() const { return m_bindPoint; }
         [[nodiscard]] const PipelineDescriptor& GetDescriptor() const { return m_desc; }
+        //! Whether the layout has the bindless heap at Conf::SHIFT_BINDLESS_SET
+        [[nodiscard]] bool UsesBindless() const { return m_usesBindless; }
 
         void Destroy();
         ~Pipeline() = default;
     private:
+        //! \return compute VkPipeline, VK_NULL_HANDLE if failed
+        [[nodiscard]] VkPipeline CreateCompute(const ShaderStageDesc& shader, VkPipelineCache cache) const;
+
         const Device* m_device = nullptr;
 
         VkPipeline m_pipeline = VK_NULL_HANDLE;
         VkPipelineLayout m_layout = VK_NULL_HANDLE;
+        VkPipelineBindPoint m_bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 
         PipelineDescriptor m_desc;
+        bool m_usesBindless = false;
         bool valid = false;
     };
 
@@ -16,6 +16,7 @@
 #include "VKResourceSet.hpp"
 #include "VKSemaphore.hpp"
 #include "VKTexture.hpp"
+#include "VKMemoryBlock.hpp"
 #include "VKCommandBuffer.hpp"
 #include "VKFence.hpp"
 
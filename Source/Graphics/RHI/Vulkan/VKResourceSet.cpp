@@ -1,5 +1,7 @@
 #include "VKResourceSet.hpp"
 
+#include <algorithm>
+
 #include "VKBuffer.hpp"
 #include "VKTexture.hpp"
 #include "VKSampler.hpp"
@@ -7,14 +9,15 @@
 #include "Utility/Vulkan/VKUtilRHI.hpp"
 
 namespace Shift::VK {
-    void ResourceSet::Init(const Device *device, VkDescriptorSet set) {
+    void ResourceSet::Init(const Device *device, VkDescriptorSet set, const DescriptorUpdateTemplate* updateTemplate) {
         m_device = device;
+        m_template = updateTemplate;
 
-        static constexpr uint32_t DEFAULT_INFO_SIZE = 16;
-
-        m_imageInfos.reserve(DEFAULT_INFO_SIZE);
-        m_bufferInfos.reserve(DEFAULT_INFO_SIZE);
-        m_samplerInfos.reserve(DEFAULT_INFO_SIZE);
+        if (UsesTemplate()) {
+            m_templateData.assign(m_template->slotCount, DescriptorData{});
+            m_slotWritten.assign(m_template->slotCount, false);
+            m_dirtySlots.reserve(m_template->slotCount);
+        }
 
         m_set = set;
 
@@ -25,60 +28,122 @@ namespace Shift::VK {
         UpdateUBO(bind, InputBuffer, InputBuffer.GetSize(), 0);
     }
 
-    void ResourceSet::UpdateUBO(uint32_t bind, const VK::Buffer &InputBuffer, uint32_t size, uint32_t offset) {
-        m_bufferInfos.emplace_back(InputBuffer.VK_Get(), offset, size);
+    void ResourceSet::UpdateUBO(uint32_t bind, const VK::Buffer &InputBuffer, uint32_t size, uint32_t offset, uint32_t arrayElement) {
+        BeginUpdate();
 
-        VkWriteDescriptorSet writeSet{};
+        //! The layout decides between plain and dynamic, the offset is the base the dynamic offset gets added to
+        if (DescriptorData* slot = GetSlot(bind, arrayElement, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)) {
+            slot->buffer = {InputBuffer.VK_Get(), offset, size};
+        }
+    }
 
-        writeSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeSet.dstBinding = bind;
-        writeSet.dstSet = m_set;
-        writeSet.dstArrayElement = 0;
-        writeSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        writeSet.descriptorCount = 1;
-        writeSet.pBufferInfo = &m_bufferInfos.back();
+    void ResourceSet::UpdateStorageBuffer(uint32_t bind, const VK::Buffer &InputBuffer, uint32_t size, uint32_t offset, uint32_t arrayElement) {
+        BeginUpdate();
 
-        m_writeSets.push_back(writeSet);
+        if (DescriptorData* slot = GetSlot(bind, arrayElement, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)) {
+            slot->buffer = {InputBuffer.VK_Get(), offset, (size == 0) ? VK_WHOLE_SIZE : size};
+        }
     }
 
-    void ResourceSet::UpdateTexture(uint32_t bind, const VK::Texture &InputTexture) {
-        m_imageInfos.emplace_back(VK_NULL_HANDLE, InputTexture.GetView(), Util::ShiftToVKResourceLayout(InputTexture.GetResourceLayout()));
+    void ResourceSet::UpdateTexture(uint32_t bind, const VK::Texture &InputTexture, uint32_t arrayElement) {
+        BeginUpdate();
 
-        VkWriteDescriptorSet writeSet{};
+        //! Leaves the sampler alone, so a combined image sampler binding is an UpdateTexture + UpdateSampler
+        if (DescriptorData* slot = GetSlot(bind, arrayElement, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE)) {
+            slot->image.imageView = InputTexture.GetView();
+            slot->image.imageLayout = Util::ShiftToVKResourceLayout(InputTexture.GetResourceLayout());
+        }
+    }
 
-        writeSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeSet.dstSet = m_set;
-        writeSet.dstBinding = bind;
-        writeSet.dstArrayElement = 0;
-        writeSet.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-        writeSet.descriptorCount = 1;
-        writeSet.pImageInfo = &m_imageInfos.back();
+    void ResourceSet::UpdateStorageImage(uint32_t bind, const VK::Texture &InputTexture, uint32_t arrayElement) {
+        BeginUpdate();
 
-        m_writeSets.push_back(writeSet);
+        //! Storage images are only ever accessed in the general layout, whatever the texture is in right now
+        if (DescriptorData* slot = GetSlot(bind, arrayElement, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)) {
+            slot->image = {VK_NULL_HANDLE, InputTexture.GetView(), VK_IMAGE_LAYOUT_GENERAL};
+        }
     }
 
-    void ResourceSet::UpdateSampler(uint32_t bind, const VK::Sampler &InputSampler) {
-        // TODO [SANITY_CHECK] @gronk is this correct?
-        m_samplerInfos.emplace_back(InputSampler.VK_Get());
+    void ResourceSet::UpdateSampler(uint32_t bind, const VK::Sampler &InputSampler, uint32_t arrayElement) {
+        BeginUpdate();
+
+        if (DescriptorData* slot = GetSlot(bind, arrayElement, VK_DESCRIPTOR_TYPE_SAMPLER)) {
+            slot->image.sampler = InputSampler.VK_Get();
+        }
+    }
 
-        VkWriteDescriptorSet writeSet{};
+    void ResourceSet::Apply() {
+        DescriptorWriteBatcher batcher;
+        batcher.Init(m_device);
+        VK_Apply(&batcher);
+        batcher.Flush();
+    }
 
-        writeSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeSet.dstSet = m_set;
-        writeSet.dstBinding = bind;
-        writeSet.dstArrayElement = 0;
-        writeSet.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-        writeSet.descriptorCount = 1;
-        writeSet.pImageInfo = &m_imageInfos.back();
+    void ResourceSet::VK_Apply(DescriptorWriteBatcher *batcher) {
+        m_applied = true;
+
+        if (UsesTemplate()) {
+            if (m_dirtySlots.empty()) { return; }
+
+            //! Complete set, one memcpy-like update of the whole thing. Until then only the written slots are valid
+            if (m_writtenSlotCount == m_template->slotCount) {
+                vkUpdateDescriptorSetWithTemplate(m_device->Get(), m_set, m_template->handle, m_templateData.data());
+            } else {
+                for (uint32_t slot: m_dirtySlots) {
+                    auto entry = std::ranges::find_if(m_template->entries, [slot](const DescriptorUpdateTemplate::Entry& e) {
+                        return slot >= e.firstSlot && slot < e.firstSlot + e.count;
+                    });
+                    batcher->Write(m_set, entry->binding, slot - entry->firstSlot, entry->type, &m_templateData[slot]);
+                }
+            }
+            m_dirtySlots.clear();
+            return;
+        }
+
+        for (const auto& pending: m_pendingWrites) {
+            batcher->Write(m_set, pending.binding, pending.arrayElement, pending.type, &pending.data);
+        }
+    }
 
-        m_writeSets.push_back(writeSet);
+    DescriptorData* ResourceSet::GetSlot(uint32_t bind, uint32_t arrayElement, VkDescriptorType fallbackType) {
+        const DescriptorUpdateTemplate::Entry* entry = nullptr;
+        if (m_template != nullptr) {
+            entry = m_template->FindEntry(bind);
+            if (entry == nullptr) {
+                Log(Error, "Resource set has no binding {}", bind);
+                return nullptr;
+            }
+            if (arrayElement >= entry->count) {
+                Log(Error, "Resource set binding {} has {} elements, can't update element {}", bind, entry->count, arrayElement);
+                return nullptr;
+            }
+        }
+
+        if (!UsesTemplate()) {
+            auto pending = std::ranges::find_if(m_pendingWrites, [bind, arrayElement](const PendingWrite& write) {
+                return write.binding == bind && write.arrayElement == arrayElement;
+            });
+            if (pending != m_pendingWrites.end()) { return &pending->data; }
+
+            VkDescriptorType type = (entry != nullptr) ? entry->type : fallbackType;
+            return &m_pendingWrites.emplace_back(PendingWrite{bind, arrayElement, type, DescriptorData{}}).data;
+        }
+
+        uint32_t slot = entry->firstSlot + arrayElement;
+        if (!m_slotWritten[slot]) {
+            m_slotWritten[slot] = true;
+            ++m_writtenSlotCount;
+        }
+        if (std::ranges::find(m_dirtySlots, slot) == m_dirtySlots.end()) {
+            m_dirtySlots.push_back(slot);
+        }
+        return &m_templateData[slot];
     }
 
-    void ResourceSet::Apply() {
-        vkUpdateDescriptorSets(m_device->Get(), static_cast<uint32_t>(m_writeSets.size()), m_writeSets.data(), 0, nullptr);
-        m_writeSets.clear();
-        m_imageInfos.clear();
-        m_bufferInfos.clear();
-        m_samplerInfos.clear();
+    void ResourceSet::BeginUpdate() {
+        if (m_applied) {
+            m_pendingWrites.clear();
+            m_applied = false;
+        }
     }
-} // Shift::VK
\ No newline at end of file
+} // Shift::VK
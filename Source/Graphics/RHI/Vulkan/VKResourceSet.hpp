@@ -4,6 +4,7 @@
 #include "VKDevice.hpp"
 
 #include "Graphics/RHI/ResourceSet.hpp"
+#include "Graphics/RHI/Vulkan/Assistants/DescriptorUpdate.hpp"
 
 namespace Shift::VK {
     class ResourceSet {
@@ -13,7 +14,10 @@ namespace Shift::VK {
         //! Init the resource set (just fills infos, the api related logic is in the RHI wrapper)
         //! \param device - device lol
         //! \param set - descriptor set
-        void Init(const Device* device, VkDescriptorSet set);
+        //! \param updateTemplate - template of the set layout, with it the updates go into one packed array that is
+        //! written with a single vkUpdateDescriptorSetWithTemplate. One without a handle falls back to plain writes typed
+        //! by its entries, nullptr to plain writes of the default type of each update function
+        void Init(const Device* device, VkDescriptorSet set, const DescriptorUpdateTemplate* updateTemplate = nullptr);
 
         [[nodiscard]] bool IsValid() const { return valid; }
 
@@ -27,32 +31,80 @@ namespace Shift::VK {
         //! \param InputBuffer
         //! \param offset
         //! \param size
-        void UpdateUBO(uint32_t bind, const Buffer& InputBuffer, uint32_t size, uint32_t offset);
+        //! \param arrayElement element of an array binding
+        void UpdateUBO(uint32_t bind, const Buffer& InputBuffer, uint32_t size, uint32_t offset, uint32_t arrayElement = 0);
+
+        //! Update SSBO at custom buffer size and offset, size 0 binds the rest of the buffer
+        //! \param bind
+        //! \param InputBuffer buffer created with the Storage or Indirect type
+        //! \param size
+        //! \param offset
+        //! \param arrayElement element of an array binding
+        void UpdateStorageBuffer(uint32_t bind, const Buffer& InputBuffer, uint32_t size = 0, uint32_t offset = 0, uint32_t arrayElement = 0);
 
         //! Update Image
         //! \param bind
         //! \param InputTexture
-        void UpdateTexture(uint32_t bind, const Texture& InputTexture);
+        //! \param arrayElement element of an array binding
+        void UpdateTexture(uint32_t bind, const Texture& InputTexture, uint32_t arrayElement = 0);
+
+        //! Update storage image, it is bound in the general layout the texture has to be transitioned to
+        //! \param bind
+        //! \param InputTexture texture with Storage usage
+        //! \param arrayElement element of an array binding
+        void UpdateStorageImage(uint32_t bind, const Texture& InputTexture, uint32_t arrayElement = 0);
 
         //! Update Sampler
         //! \param bind
         //! \param InputSampler
-        void UpdateSampler(uint32_t bind, const Sampler& InputSampler);
+        //! \param arrayElement element of an array binding
+        void UpdateSampler(uint32_t bind, const Sampler& InputSampler, uint32_t arrayElement = 0);
 
         //! Apply the updates, if this is not called after the update functions, none will stick!
         void Apply();
 
+        //! [VK backend only function] Apply through a batcher shared by many sets. Once every descriptor of a templated
+        //! set has been written the whole set is updated with the template right away, otherwise the writes are queued.
+        //! Don't update the set again until the batcher has been flushed, the queued writes point into it.
+        //! \param batcher the batcher to queue the writes into
+        void VK_Apply(DescriptorWriteBatcher* batcher);
+
+        [[nodiscard]] VkDescriptorSet VK_Get() const { return m_set; }
+
         ~ResourceSet()=default;
     private:
+        //! Data of one descriptor to fill, the template slot or the pending plain write of it. Image and sampler of a
+        //! combined image sampler land in the same one
+        //! \param bind binding of the set layout
+        //! \param arrayElement element of an array binding
+        //! \param fallbackType descriptor type of plain writes when the layout is unknown
+        //! \return nullptr if the binding or element is not in the layout
+        [[nodiscard]] DescriptorData* GetSlot(uint32_t bind, uint32_t arrayElement, VkDescriptorType fallbackType);
+
+        [[nodiscard]] bool UsesTemplate() const { return m_template != nullptr && m_template->IsValid(); }
+
+        //! Drop the writes the last apply queued, the batcher is done with them by now
+        void BeginUpdate();
+
+        //! Plain write path, self contained so nothing points into a vector that can still grow
+        struct PendingWrite {
+            uint32_t binding;
+            uint32_t arrayElement;
+            VkDescriptorType type;
+            DescriptorData data;
+        };
+
         const Device* m_device;
 
-        // There are needed to keep the stucts "alive before update"
-        // TODO: [OPTIMIZATION] Can you remove them?
-        std::vector<VkDescriptorBufferInfo> m_bufferInfos;
-        std::vector<VkDescriptorImageInfo> m_imageInfos;
-        std::vector<VkDescriptorImageInfo> m_samplerInfos;
+        const DescriptorUpdateTemplate* m_template = nullptr;
+        //! Template path, one slot per descriptor of the layout (every element of an array), sized once at init
+        std::vector<DescriptorData> m_templateData;
+        std::vector<bool> m_slotWritten;
+        uint32_t m_writtenSlotCount = 0;
+        std::vector<uint32_t> m_dirtySlots;
 
-        std::vector<VkWriteDescriptorSet> m_writeSets;
+        std::vector<PendingWrite> m_pendingWrites;
+        bool m_applied = false;
 
         VkDescriptorSet m_set = VK_NULL_HANDLE;
         bool valid = false;
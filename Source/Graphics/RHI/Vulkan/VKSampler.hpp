@@ -8,6 +8,7 @@
 namespace Shift::VK {
     class Sampler {
         friend VK::ResourceSet;
+        friend class BindlessHeap;
     public:
         Sampler()=default;
 
@@ -12,4 +12,39 @@ namespace Shift::VK {
     void Semaphore::Destroy() {
         m_device->DestroySemaphore(m_semaphore);
     }
+
+    bool TimelineSemaphore::Init(const Device *device, uint64_t initialValue) {
+        m_device = device;
+
+        VkSemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = initialValue;
+
+        VkSemaphoreCreateInfo info = Util::CreateSemaphoreInfo();
+        info.pNext = &typeInfo;
+
+        m_semaphore = m_device->CreateSemaphore(info);
+        return VkNullCheck(m_semaphore);
+    }
+
+    uint64_t TimelineSemaphore::GetValue() const {
+        uint64_t value = 0;
+        vkGetSemaphoreCounterValue(m_device->Get(), m_semaphore, &value);
+        return value;
+    }
+
+    bool TimelineSemaphore::Wait(uint64_t value, uint64_t limit) const {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_semaphore;
+        waitInfo.pValues = &value;
+
+        return vkWaitSemaphores(m_device->Get(), &waitInfo, limit) == VK_SUCCESS;
+    }
+
+    void TimelineSemaphore::Destroy() {
+        m_device->DestroySemaphore(m_semaphore);
+    }
 } // Shift::VK
@@ -30,6 +30,40 @@ namespace Shift::VK {
     };
 
     ASSERT_INTERFACE(ISemaphore, Semaphore);
+
+    //! A timeline semaphore (core in Vulkan 1.2), a monotonically increasing counter that the GPU signals and the CPU can poll
+    class TimelineSemaphore {
+    public:
+        TimelineSemaphore() = default;
+
+        //! Initialize a timeline VkSemaphore
+        //! \param device The device wrapper ptr
+        //! \param initialValue the starting counter value
+        //! \return false if failed to initialize
+        bool Init(const Device* device, uint64_t initialValue = 0);
+
+        //! Get the current counter value, does not block
+        [[nodiscard]] uint64_t GetValue() const;
+
+        //! Block until the counter reaches the value
+        //! \param value value to wait for
+        //! \param limit timeout in ns
+        //! \return true if the value was reached
+        bool Wait(uint64_t value, uint64_t limit = UINT64_MAX) const;
+
+        [[nodiscard]] VkSemaphore Get() const { return m_semaphore; }
+        [[nodiscard]] const VkSemaphore* Ptr() const { return &m_semaphore; }
+
+        //! Free the VkSemaphore
+        void Destroy();
+        ~TimelineSemaphore() = default;
+    private:
+        const Device* m_device = nullptr;
+
+        VkSemaphore m_semaphore = VK_NULL_HANDLE;
+    };
+
+    ASSERT_INTERFACE(ISemaphore, TimelineSemaphore);
 } // Shift::VK
 
 #endif //SHIFT_VKSEMAPHORE_HPP
@@ -1,5 +1,7 @@
 #include "VKShader.hpp"
 
+#include <algorithm>
+
 #include "Utility/Vulkan/VKUtilInfo.hpp"
 #include "Utility/Vulkan/VKUtilRHI.hpp"
 
@@ -7,18 +9,29 @@ namespace Shift::VK {
     using namespace Shift::Util;
 
     void Shader::Init(const Device* device, const ShaderDescriptor& desc) {
+        auto code = ReadFile(desc.path);
+        VK_Init(device, desc, code);
+    }
+
+    void Shader::VK_Init(const Device* device, const ShaderDescriptor& desc, std::span<const char> code) {
         m_device = device;
         m_type = desc.type;
-        m_path = desc.path.c_str();
-        m_entry = desc.entry.c_str();
+        if (desc.entry.size() >= MAX_ENTRY_LENGTH) {
+            Log(Error, "Shader entry point name {} is too long!", desc.entry);
+            valid = false;
+            return;
+        }
+        std::copy(desc.entry.begin(), desc.entry.end(), m_entry);
 
-        auto code = ReadFile(m_path);
+        m_hash = HashFNV1a(code.data(), code.size());
+        m_hash = HashFNV1a(m_entry, desc.entry.size(), m_hash);
+        m_hash = HashFNV1a(&m_type, sizeof(m_type), m_hash);
 
         m_module = m_device->CreateShaderModule(Util::CreateShaderModuleInfo(code));
 
         m_stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         m_stageInfo.module = m_module;
-        m_stageInfo.pName = m_entry;
+        //! pName is filled in by VK_GetStageInfo
         // You can set constant explicitly which alloes vulkan to optimize shader code based on the constants
         m_stageInfo.pSpecializationInfo = nullptr;
 
@@ -1,6 +1,8 @@
 #ifndef SHIFT_VKSHADER_HPP
 #define SHIFT_VKSHADER_HPP
 
+#include <span>
+
 #include "VKDevice.hpp"
 #include "Graphics/RHI/Shader.hpp"
 
@@ -20,23 +22,38 @@ namespace Shift::VK {
         //! \return false if failed to create module
         void Init(const Device* device, const ShaderDescriptor& desc);
 
+        //! Same as Init but with the code already loaded, so the RHI reads the file once for the module and the reflection
+        //! \param code SPIR-V binary of desc.path
+        void VK_Init(const Device* device, const ShaderDescriptor& desc, std::span<const char> code);
+
         [[nodiscard]] bool IsValid() const { return valid; }
 
         [[nodiscard]] EShaderType GetType() const { return m_type; }
 
+        //! Identity of the shader: code, entry point and stage. Equal hashes mean interchangeable shaders
+        [[nodiscard]] uint64_t GetHash() const { return m_hash; }
+
         void Destroy();
         ~Shader() = default;
     private:
         //! This is to be called by the VK pipeline only! Which is a friend class of the shader
         //! This is a Vulkan only function and is ONLY mean to be called by the Vulkan backend
-        //! \return
-        [[nodiscard]] VkPipelineShaderStageCreateInfo VK_GetStageInfo() const { return m_stageInfo; }
+        //! \return The stage info, its name points into this shader, so the shader has to outlive the pipeline creation
+        [[nodiscard]] VkPipelineShaderStageCreateInfo VK_GetStageInfo() const {
+            //! Set here and not at Init, shaders are copied around and a stored pointer would keep the old object's name
+            VkPipelineShaderStageCreateInfo info = m_stageInfo;
+            info.pName = m_entry;
+            return info;
+        }
 
         const Device* m_device = nullptr;
 
-        const char* m_path = nullptr;
-        const char* m_entry = nullptr;
+        static constexpr size_t MAX_ENTRY_LENGTH = 64;
+
+        //! The stage info from VK_GetStageInfo points here
+        char m_entry[MAX_ENTRY_LENGTH]{};
         EShaderType m_type = EShaderType::Vertex;
+        uint64_t m_hash = 0;
 
         bool valid = false;
         VkShaderModule m_module = VK_NULL_HANDLE;
@@ -8,6 +8,7 @@
 #include "Utility/Assertions.hpp"
 #include "Utility/Vulkan/VKUtilInfo.hpp"
 #include "Utility/Vulkan/VKUtilRHI.hpp"
+#include "Assistants/DeletionQueue.hpp"
 
 namespace Shift::VK {
     bool Swapchain::Init(const Device *device, const WindowSurface* windowSurface, uint32_t width, uint32_t height) {
@@ -78,7 +79,15 @@ namespace Shift::VK {
             return false;
         }
 
-        if (oldSwapchain != VK_NULL_HANDLE) {
+        if (oldSwapchain != VK_NULL_HANDLE && m_deletionQueue != nullptr) {
+            //! Frames in flight may still render into the old views, they go once those frames retire
+            m_deletionQueue->Push([device = m_device, views = m_swapChainImageViews, oldSwapchain]() {
+                for (VkImageView view: views) {
+                    device->DestroyImageView(view);
+                }
+                vkDestroySwapchainKHR(device->Get(), oldSwapchain, nullptr);
+            });
+        } else if (oldSwapchain != VK_NULL_HANDLE) {
             DestroyImageViews();
             vkDestroySwapchainKHR(m_device->Get(), oldSwapchain, nullptr);
         }
@@ -137,7 +146,9 @@ namespace Shift::VK {
     }
 
     bool Swapchain::Recreate(uint32_t width, uint32_t height) {
-        vkDeviceWaitIdle(m_device->Get());
+        if (m_deletionQueue == nullptr) {
+            vkDeviceWaitIdle(m_device->Get());
+        }
         FillSwapchainDescription(width, height);
         CreateSwapChain();
         CreateImageViews();
@@ -12,6 +12,8 @@
 #include "Window/ShiftWindow.hpp"
 
 namespace Shift::VK {
+    class DeletionQueue;
+
     struct SwapchainDescription {
         VkSurfaceFormatKHR surfaceFormat;
         ETextureFormat swapChainImageFormat;
@@ -35,7 +37,8 @@ namespace Shift::VK {
         //! \param timeout max time to wait until success, default is UINT64_MAX
         //! \return The image index or UINT32_MAX if error
         [[nodiscard]] uint32_t AquireNextImage(const Semaphore& semaphore, bool* wasChanged, uint64_t timeout = UINT64_MAX);
-        //! Wait for device commands and manually recreate the swapchain
+        //! Recreate the swapchain, the old one and its views are handed to the deletion queue if there is one set,
+        //! otherwise this waits for the device to go idle first
         //! \param width
         //! \param height
         //! \return Whether recreation was a success
@@ -47,6 +50,9 @@ namespace Shift::VK {
         //! \return false at total failure (no recreation possible), else true
         [[nodiscard]] bool Present(const Semaphore& semaphore, uint32_t imageIdx, bool* isOld);
 
+        //! [VK backend only function] Retire old swapchains through the queue instead of idling the device
+        void VK_SetDeletionQueue(DeletionQueue* deletionQueue) { m_deletionQueue = deletionQueue; }
+
         [[nodiscard]] VkSwapchainKHR Get() const { return m_swapChain; }
         [[nodiscard]] const std::vector<VkImageView>& GetImageViews() const { return m_swapChainImageViews; }
         [[nodiscard]] const std::vector<VkImage>& GetImages() const { return m_swapChainImages; }
@@ -71,6 +77,7 @@ namespace Shift::VK {
 
         const Device* m_device = nullptr;
         const WindowSurface* m_windowSurface = nullptr;
+        DeletionQueue* m_deletionQueue = nullptr;
 
         Viewport m_viewPort{};
         Rect2D m_scissor{};
@@ -3,38 +3,177 @@
 #include "Utility/Vulkan/VKUtilInfo.hpp"
 #include "Utility/Vulkan/VKUtilRHI.hpp"
 
+#include "Assistants/TextureAllocator.hpp"
+
 namespace Shift::VK {
-    void Texture::Init(const Device *device, const TextureDescriptor &textureDesc) {
+    void Texture::Init(const Device *device, const TextureDescriptor &textureDesc, const TextureAllocator *allocator) {
         m_device = device;
         m_textureDesc = textureDesc;
 
-        VkImageCreateInfo imageInfo{};
-        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        imageInfo.imageType = Util::ShiftToVKTextureType(textureDesc.textureType);
+        VkImageCreateInfo imageInfo = CreateImageInfo(m_device, m_textureDesc);
 
-        imageInfo.extent.width = m_textureDesc.width;
-        imageInfo.extent.height = m_textureDesc.height;
-        imageInfo.extent.depth = m_textureDesc.depth;
-        imageInfo.mipLevels = m_textureDesc.mips;
-        imageInfo.arrayLayers = m_textureDesc.levels;
-        imageInfo.format = Util::ShiftToVKTextureFormat(m_textureDesc.format);
-        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageInfo.initialLayout = Util::ShiftToVKResourceLayout(textureDesc.resourceLayout);
-        imageInfo.usage = Util::ShiftToVKTextureUsageFlags(textureDesc.usageFlags);
-        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        //! The image goes first, the pool is picked by its real memory requirements
+        if ( VkCheck(vkCreateImage(m_device->Get(), &imageInfo, nullptr, &m_image)) ) {
+            Log(Warning, "Failed to create VkImage!");
+            valid = false;
+            return;
+        }
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(m_device->Get(), m_image, &memoryRequirements);
 
         VmaAllocationCreateInfo allocCreateInfo = {};
         allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
         allocCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
         allocCreateInfo.priority = 1.0f;
+        if (allocator != nullptr) {
+            allocCreateInfo = allocator->GetAllocationInfo(m_textureDesc, memoryRequirements);
+        }
+
+        VkResult res = vmaAllocateMemoryForImage(m_device->GetAllocator(), m_image, &allocCreateInfo, &m_allocation, &m_allocationInfo);
+        if (res == VK_ERROR_OUT_OF_DEVICE_MEMORY && (allocCreateInfo.pool != VK_NULL_HANDLE || allocCreateInfo.flags != 0)) {
+            //! A full pool or heap, let VMA pick any memory that takes the image, slower memory beats no texture
+            VmaAllocationCreateInfo fallbackInfo{};
+            fallbackInfo.usage = VMA_MEMORY_USAGE_AUTO;
+            res = vmaAllocateMemoryForImage(m_device->GetAllocator(), m_image, &fallbackInfo, &m_allocation, &m_allocationInfo);
+        }
+        if ( VkCheck(res) ) {
+            Log(Warning, "Failed to allocate VkImage memory!");
+            vkDestroyImage(m_device->Get(), m_image, nullptr);
+            m_image = VK_NULL_HANDLE;
+            m_allocation = VK_NULL_HANDLE;
+            valid = false;
+            return;
+        }
+        if ( VkCheck(vmaBindImageMemory(m_device->GetAllocator(), m_allocation, m_image)) ) {
+            Log(Warning, "Failed to bind VkImage memory!");
+            vmaDestroyImage(m_device->GetAllocator(), m_image, m_allocation);
+            m_image = VK_NULL_HANDLE;
+            m_allocation = VK_NULL_HANDLE;
+            valid = false;
+            return;
+        }
+
+        valid = CreateView();
+    }
+
+    void Texture::InitPlaced(const Device *device, const TextureDescriptor &textureDesc, const MemoryBlock &block, uint64_t offset) {
+        m_device = device;
+        m_textureDesc = textureDesc;
 
-        if ( VkCheck(vmaCreateImage(m_device->GetAllocator(), &imageInfo, &allocCreateInfo, &m_image, &m_allocation, &m_allocationInfo)) ) {
-            Log(Warning, "Failed to allocate VkImage!");
+        VkImageCreateInfo imageInfo = CreateImageInfo(m_device, m_textureDesc);
+        //! Placed textures always start undefined, whatever was in the bytes before is garbage to them
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        m_textureDesc.resourceLayout = EResourceLayout::Undefined;
+
+        if ( VkCheck(vmaCreateAliasingImage2(m_device->GetAllocator(), block.VK_Get(), offset, &imageInfo, &m_image)) ) {
+            Log(Warning, "Failed to place VkImage into a memory block!");
             valid = false;
             return;
         }
 
+        //! No allocation of its own, Destroy only drops the image
+        m_allocation = VK_NULL_HANDLE;
+        valid = CreateView();
+    }
+
+    TextureMemoryRequirements Texture::VK_GetMemoryRequirements(const Device *device, const TextureDescriptor &textureDesc) {
+        VkImageCreateInfo imageInfo = CreateImageInfo(device, textureDesc);
+
+        //! A throwaway image, the requirements can't be known without one on 1.2
+        VkImage image = VK_NULL_HANDLE;
+        if (VkCheck(vkCreateImage(device->Get(), &imageInfo, nullptr, &image))) {
+            Log(Warning, "Failed to create VkImage for the memory requirements!");
+            return {};
+        }
+
+        VkMemoryRequirements memoryRequirements;
+        vkGetImageMemoryRequirements(device->Get(), image, &memoryRequirements);
+        vkDestroyImage(device->Get(), image, nullptr);
+
+        return {
+            .size = memoryRequirements.size,
+            .alignment = memoryRequirements.alignment,
+            .memoryTypeBits = memoryRequirements.memoryTypeBits
+        };
+    }
+
+    Texture Texture::VK_CreateMoved(VmaAllocation dstAllocation) const {
+        Texture moved = *this;
+        moved.m_image = VK_NULL_HANDLE;
+        moved.m_imageView = VK_NULL_HANDLE;
+        moved.m_stageFlags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        moved.m_textureDesc.resourceLayout = EResourceLayout::Undefined;
+        moved.valid = false;
+
+        VkImageCreateInfo imageInfo = CreateImageInfo(m_device, moved.m_textureDesc);
+        if (VkCheck(vkCreateImage(m_device->Get(), &imageInfo, nullptr, &moved.m_image))) {
+            Log(Warning, "Failed to create VkImage for a defragmentation move!");
+            moved.m_image = VK_NULL_HANDLE;
+            return moved;
+        }
+
+        //! Bound to the temporary allocation, VMA swaps that memory in behind m_allocation when the pass ends
+        if (VkCheck(vmaBindImageMemory(m_device->GetAllocator(), dstAllocation, moved.m_image)) || !moved.CreateView()) {
+            Log(Warning, "Failed to bind VkImage to its defragmentation move!");
+            moved.VK_DestroyImage();
+            return moved;
+        }
+
+        moved.valid = true;
+        return moved;
+    }
+
+    void Texture::VK_DestroyImage() {
+        m_device->DestroyImageView(m_imageView);
+        vkDestroyImage(m_device->Get(), m_image, nullptr);
+        m_imageView = VK_NULL_HANDLE;
+        m_image = VK_NULL_HANDLE;
+        valid = false;
+    }
+
+    void Texture::VK_RefreshAllocationInfo() {
+        if (m_allocation != VK_NULL_HANDLE) {
+            vmaGetAllocationInfo(m_device->GetAllocator(), m_allocation, &m_allocationInfo);
+        }
+    }
+
+    void Texture::Destroy() {
+        m_device->DestroyImageView(m_imageView);
+        if (m_allocation == VK_NULL_HANDLE) {
+            vkDestroyImage(m_device->Get(), m_image, nullptr);
+        } else {
+            vmaDestroyImage(m_device->GetAllocator(), m_image, m_allocation);
+        }
+    }
+
+    VkImageCreateInfo Texture::CreateImageInfo(const Device* device, const TextureDescriptor &textureDesc) {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = Util::ShiftToVKTextureType(textureDesc.textureType);
+
+        imageInfo.extent.width = textureDesc.width;
+        imageInfo.extent.height = textureDesc.height;
+        imageInfo.extent.depth = textureDesc.depth;
+        imageInfo.mipLevels = textureDesc.mips;
+        imageInfo.arrayLayers = textureDesc.levels;
+        imageInfo.format = Util::ShiftToVKTextureFormat(textureDesc.format);
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = Util::ShiftToVKResourceLayout(textureDesc.resourceLayout);
+        imageInfo.usage = Util::ShiftToVKTextureUsageFlags(textureDesc.usageFlags);
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        //! Storage images are what async compute writes, shared so graphics reads them without ownership transfers
+        std::span<const uint32_t> sharingFamilies = device->GetComputeSharingFamilies();
+        if ((textureDesc.usageFlags & ETextureUsageFlags::Storage) != ETextureUsageFlags::None && !sharingFamilies.empty()) {
+            imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(sharingFamilies.size());
+            imageInfo.pQueueFamilyIndices = sharingFamilies.data();
+        }
+        return imageInfo;
+    }
+
+    bool Texture::CreateView() {
         // TODO: [FEATURE]: For now does not support cubemaps
         VkImageViewType viewType = Util::ShiftToVKTextureViewType(m_textureDesc.textureViewType) ;
         VkImageAspectFlags textureType = Util::ShiftToVKTextureAspect(m_textureDesc.textureAspect);
@@ -49,11 +188,6 @@ namespace Shift::VK {
 
         m_imageView = m_device->CreateImageView(Util::CreateImageViewInfo(m_image, viewType, Util::ShiftToVKTextureFormat(m_textureDesc.format), sRange));
 
-        valid = m_imageView != VK_NULL_HANDLE;
-    }
-
-    void Texture::Destroy() {
-        m_device->DestroyImageView(m_imageView);
-        vmaDestroyImage(m_device->GetAllocator(), m_image, m_allocation);
+        return m_imageView != VK_NULL_HANDLE;
     }
-} // Shift::VK
\ No newline at end of file
+} // Shift::VK
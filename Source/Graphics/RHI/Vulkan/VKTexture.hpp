@@ -2,10 +2,13 @@
 #define SHIFT_VKTEXTURE_HPP
 
 #include "VKDevice.hpp"
+#include "VKMemoryBlock.hpp"
 
 #include "Graphics/RHI/Texture.hpp"
 
 namespace Shift::VK {
+    class TextureAllocator;
+
     //! A RAII Wrapper for texture creation/destriction logic, it not mean to be used raw as has a ton of configs
     //! Meant to be used as a base class
     class Texture {
@@ -13,7 +16,30 @@ namespace Shift::VK {
     public:
         Texture() = default;
 
-        void Init(const Device* device, const TextureDescriptor& textureDesc);
+        //! Create the texture in memory of its own
+        //! \param device Device wrapper ptr
+        //! \param textureDesc texture description
+        //! \param allocator picks a size class pool or dedicated memory, nullptr for dedicated memory
+        void Init(const Device* device, const TextureDescriptor& textureDesc, const TextureAllocator* allocator = nullptr);
+
+        //! Create the texture in memory it doesn't own, it may alias other textures placed into the same bytes
+        //! \param device Device wrapper ptr
+        //! \param textureDesc texture description
+        //! \param block memory to place the texture into, has to outlive the texture
+        //! \param offset offset into the block, aligned to VK_GetMemoryRequirements().alignment
+        void InitPlaced(const Device* device, const TextureDescriptor& textureDesc, const MemoryBlock& block, uint64_t offset);
+
+        //! [VK backend only function] What a texture of this description needs from its memory
+        [[nodiscard]] static TextureMemoryRequirements VK_GetMemoryRequirements(const Device* device, const TextureDescriptor& textureDesc);
+
+        //! [VK backend only function] The texture in the memory a defragmentation move gives it: a new image and view bound
+        //! to the move destination, same allocation handle. It starts undefined, the contents are copied over by the caller
+        //! \param dstAllocation VmaDefragmentationMove::dstTmpAllocation
+        [[nodiscard]] Texture VK_CreateMoved(VmaAllocation dstAllocation) const;
+        //! [VK backend only function] Destroy the image and view of a moved texture, the allocation went to its new image
+        void VK_DestroyImage();
+        //! [VK backend only function] Read the allocation info again after VMA moved the allocation
+        void VK_RefreshAllocationInfo();
 
         [[nodiscard]] bool IsValid() const { return valid; }
 
@@ -28,13 +54,14 @@ namespace Shift::VK {
 
         [[nodiscard]] uint32_t GetWidth() const { return m_textureDesc.width; }
         [[nodiscard]] uint32_t GetHeight() const { return m_textureDesc.height; }
-        [[nodiscard]] uint32_t GetDepth() const { return m_textureDesc.height; }
+        [[nodiscard]] uint32_t GetDepth() const { return m_textureDesc.depth; }
         [[nodiscard]] uint32_t GetMipCount() const { return m_textureDesc.mips; }
         [[nodiscard]] uint32_t GetLevels() const { return m_textureDesc.levels; }
         [[nodiscard]] ETextureFormat GetFormat() const { return m_textureDesc.format; }
         [[nodiscard]] ETextureType GetType() const { return m_textureDesc.textureType; }
         [[nodiscard]] ETextureAspect GetAspect() const { return m_textureDesc.textureAspect; }
         [[nodiscard]] ETextureUsageFlags GetUsageFlags() const { return m_textureDesc.usageFlags; }
+        [[nodiscard]] const TextureDescriptor& GetDescriptor() const { return m_textureDesc; }
 
         void SetResourceLayout(EResourceLayout layout) const { m_textureDesc.resourceLayout = layout; }
         [[nodiscard]] EResourceLayout GetResourceLayout() const { return m_textureDesc.resourceLayout; }
@@ -45,6 +72,9 @@ namespace Shift::VK {
         //! TODO
         void GenerateMips();
 
+        [[nodiscard]] static VkImageCreateInfo CreateImageInfo(const Device* device, const TextureDescriptor& textureDesc);
+        [[nodiscard]] bool CreateView();
+
         const Device* m_device = nullptr;
 
         VkImage m_image = VK_NULL_HANDLE;
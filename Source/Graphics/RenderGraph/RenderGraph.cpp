@@ -0,0 +1,525 @@
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Utility/Logging/LogMacros.hpp"
+
+namespace Shift::gfx {
+    ///! ------------------- Pass declarations ------------------- !///
+
+    RenderGraphPass& RenderGraphPass::ColorAttachment(RGResource resource, EAttachmentLoadOperation load, const AttachmentClearValue &clear) {
+        assert(resource.IsValid());
+        m_colorAttachments.push_back({resource.index, load, clear});
+        return Access(resource, EResourceLayout::ColorAttachmentOptimal, EPipelineStageFlags::ColorAttachmentOutputBit, load == EAttachmentLoadOperation::Load, true);
+    }
+
+    RenderGraphPass& RenderGraphPass::DepthAttachment(RGResource resource, EAttachmentLoadOperation load, const AttachmentClearValue &clear) {
+        assert(resource.IsValid() && !m_depthAttachment.has_value());
+        m_depthAttachment = Attachment{resource.index, load, clear};
+        return Access(resource, EResourceLayout::DepthStencilAttachmentOptimal,
+                      EPipelineStageFlags::EarlyFragmentTestsBit | EPipelineStageFlags::LateFragmentTestsBit,
+                      load == EAttachmentLoadOperation::Load, true);
+    }
+
+    RenderGraphPass& RenderGraphPass::Read(RGResource resource, EPipelineStageFlags stages) {
+        return Access(resource, EResourceLayout::ShaderReadOnlyOptimal, stages, true, false);
+    }
+
+    RenderGraphPass& RenderGraphPass::Access(RGResource resource, EResourceLayout layout, EPipelineStageFlags stages, bool isRead, bool isWrite) {
+        assert(resource.IsValid());
+        m_accesses.push_back({
+            .resource = resource.index,
+            .layout = layout,
+            .bufferAccess = EBufferAccess::ShaderRead,
+            .stages = stages,
+            .isRead = isRead,
+            .isWrite = isWrite
+        });
+        return *this;
+    }
+
+    RenderGraphPass& RenderGraphPass::BufferAccess(RGResource resource, EBufferAccess access, EPipelineStageFlags stages) {
+        assert(resource.IsValid());
+        bool isWrite = access == EBufferAccess::ShaderWrite || access == EBufferAccess::TransferWrite;
+        m_accesses.push_back({
+            .resource = resource.index,
+            .layout = EResourceLayout::Undefined,
+            .bufferAccess = access,
+            .stages = stages,
+            .isRead = !isWrite,
+            .isWrite = isWrite
+        });
+        return *this;
+    }
+
+    ///! ------------------- Declaration ------------------- !///
+
+    void RenderGraph::Init(GraphRHI *rhi) {
+        m_rhi = rhi;
+    }
+
+    void RenderGraph::Reset() {
+        //! A frame without the graph leaves the set unused, under pressure its memory is worth more elsewhere
+        if (!m_isCompiled && !m_transients.blocks.empty() && m_rhi->GetMemoryPressure() != EMemoryPressure::None) {
+            ReleaseTransients();
+        }
+
+        m_resources.clear();
+        m_resourceNames.clear();
+        m_passes.clear();
+        m_backbuffer.reset();
+        m_placements.clear();
+        m_blockRequirements.clear();
+        m_isCompiled = false;
+    }
+
+    void RenderGraph::ReleaseTransients() {
+        DestroyTransients(&m_transients);
+        m_transientKey.clear();
+    }
+
+    RGResource RenderGraph::AddResource(Resource&& resource) {
+        if (m_resourceNames.contains(resource.name)) {
+            Log(Error, "Render graph resource {} is declared twice!", resource.name);
+            return {};
+        }
+
+        auto idx = static_cast<uint32_t>(m_resources.size());
+        m_resourceNames.emplace(resource.name, idx);
+        m_resources.push_back(std::move(resource));
+        return {idx};
+    }
+
+    RGResource RenderGraph::CreateTexture(const std::string &name, const TextureDescriptor &desc) {
+        return AddResource({.name = name, .type = EResourceType::Transient, .desc = desc});
+    }
+
+    RGResource RenderGraph::ImportTexture(const std::string &name, Texture *texture) {
+        return AddResource({.name = name, .type = EResourceType::ImportedTexture, .texture = texture});
+    }
+
+    RGResource RenderGraph::ImportBuffer(const std::string &name, const Buffer *buffer) {
+        return AddResource({.name = name, .type = EResourceType::ImportedBuffer, .buffer = buffer});
+    }
+
+    RGResource RenderGraph::ImportBackbuffer(uint32_t imageIdx) {
+        if (m_rhi->IsHeadless()) {
+            Log(Error, "There is no backbuffer when headless, render into an imported texture instead!");
+            return {};
+        }
+        RGResource res = AddResource({.name = "SwapchainBackbuffer", .type = EResourceType::Backbuffer, .imageIdx = imageIdx});
+        if (res.IsValid()) {
+            m_backbuffer = res.index;
+        }
+        return res;
+    }
+
+    RGResource RenderGraph::FindResource(const std::string &name) const {
+        auto it = m_resourceNames.find(name);
+        return (it == m_resourceNames.end()) ? RGResource{}: RGResource{it->second};
+    }
+
+    const Texture* RenderGraph::GetTexture(RGResource resource) const {
+        if (!resource.IsValid() || resource.index >= m_resources.size()) { return nullptr; }
+
+        const Resource& res = m_resources[resource.index];
+        if (res.type == EResourceType::ImportedTexture) { return res.texture; }
+        if (res.type == EResourceType::Transient && m_isCompiled && res.placement != UINT32_MAX) {
+            return &m_transients.textures[res.placement];
+        }
+        return nullptr;
+    }
+
+    RenderGraphPass& RenderGraph::AddPass(const std::string &name, RenderGraphPass::ExecuteFunc execute) {
+        RenderGraphPass& pass = m_passes.emplace_back();
+        pass.m_name = name;
+        pass.m_execute = std::move(execute);
+        return pass;
+    }
+
+    ///! ------------------- Compilation ------------------- !///
+
+    bool RenderGraph::Compile() {
+        for (const auto& pass: m_passes) {
+            if (pass.m_colorAttachments.empty() && !pass.m_depthAttachment.has_value()) { continue; }
+
+            for (const auto& att: pass.m_colorAttachments) {
+                EResourceType type = m_resources[att.resource].type;
+                if (type == EResourceType::ImportedBuffer) {
+                    Log(Error, "Pass {} uses buffer {} as an attachment!", pass.m_name, m_resources[att.resource].name);
+                    return false;
+                }
+                //! The RHI only begins swapchain passes with the swapchain image as the only color attachment
+                if (type == EResourceType::Backbuffer && pass.m_colorAttachments.size() != 1) {
+                    Log(Error, "Pass {} renders to the backbuffer, it can't have other color attachments!", pass.m_name);
+                    return false;
+                }
+            }
+        }
+
+        CullPasses();
+        ComputeLifetimes();
+        PlaceTransients();
+
+        m_isCompiled = RealizeTransients();
+        return m_isCompiled;
+    }
+
+    void RenderGraph::CullPasses() {
+        std::vector<bool> isNeeded(m_resources.size(), false);
+        for (uint32_t i = 0; i < m_resources.size(); ++i) {
+            isNeeded[i] = m_resources[i].type != EResourceType::Transient;
+        }
+
+        for (auto it = m_passes.rbegin(); it != m_passes.rend(); ++it) {
+            RenderGraphPass& pass = *it;
+
+            bool isAlive = pass.m_hasSideEffects;
+            for (const auto& access: pass.m_accesses) {
+                isAlive |= access.isWrite && isNeeded[access.resource];
+            }
+            pass.m_isCulled = !isAlive;
+            if (!isAlive) { continue; }
+
+            //! Whatever the pass overwrites completely is not needed from the passes before it, unless it's an output
+            for (const auto& access: pass.m_accesses) {
+                if (access.isWrite && !access.isRead && m_resources[access.resource].type == EResourceType::Transient) {
+                    isNeeded[access.resource] = false;
+                }
+            }
+            for (const auto& access: pass.m_accesses) {
+                if (access.isRead) {
+                    isNeeded[access.resource] = true;
+                }
+            }
+        }
+    }
+
+    void RenderGraph::ComputeLifetimes() {
+        for (uint32_t passIdx = 0; passIdx < m_passes.size(); ++passIdx) {
+            const RenderGraphPass& pass = m_passes[passIdx];
+            if (pass.m_isCulled) { continue; }
+
+            for (const auto& access: pass.m_accesses) {
+                Resource& res = m_resources[access.resource];
+                res.firstPass = std::min(res.firstPass, passIdx);
+                res.lastPass = std::max(res.lastPass, passIdx);
+            }
+        }
+    }
+
+    void RenderGraph::PlaceTransients() {
+        for (uint32_t i = 0; i < m_resources.size(); ++i) {
+            Resource& res = m_resources[i];
+            //! Transients no surviving pass touches are never created
+            if (res.type != EResourceType::Transient || res.firstPass == UINT32_MAX) { continue; }
+
+            res.placement = static_cast<uint32_t>(m_placements.size());
+            m_placements.push_back({.resource = i, .requirements = GetRequirements(res.desc)});
+        }
+
+        //! Biggest first, the small ones fill the gaps between them
+        std::vector<uint32_t> order(m_placements.size());
+        for (uint32_t i = 0; i < order.size(); ++i) { order[i] = i; }
+        std::ranges::stable_sort(order, [this](uint32_t a, uint32_t b) {
+            return m_placements[a].requirements.size > m_placements[b].requirements.size;
+        });
+
+        auto livesWith = [this](const Placement& a, const Placement& b) {
+            const Resource& ra = m_resources[a.resource];
+            const Resource& rb = m_resources[b.resource];
+            return ra.firstPass <= rb.lastPass && rb.firstPass <= ra.lastPass;
+        };
+        auto sharesBytes = [](const Placement& a, const Placement& b) {
+            return a.block == b.block && a.offset < b.offset + b.requirements.size && b.offset < a.offset + a.requirements.size;
+        };
+
+        std::vector<uint32_t> placed;
+        for (uint32_t idx: order) {
+            Placement& p = m_placements[idx];
+
+            //! A block per set of memory types, every texture in it has to accept its memory
+            auto blockIt = std::ranges::find(m_blockRequirements, p.requirements.memoryTypeBits, &TextureMemoryRequirements::memoryTypeBits);
+            p.block = static_cast<uint32_t>(std::distance(m_blockRequirements.begin(), blockIt));
+            if (blockIt == m_blockRequirements.end()) {
+                m_blockRequirements.push_back({.size = 0, .alignment = 1, .memoryTypeBits = p.requirements.memoryTypeBits});
+            }
+
+            std::vector<const Placement*> taken;
+            for (uint32_t other: placed) {
+                const Placement& o = m_placements[other];
+                if (o.block == p.block && livesWith(p, o)) {
+                    taken.push_back(&o);
+                }
+            }
+            std::ranges::sort(taken, {}, &Placement::offset);
+
+            //! First fit: the lowest aligned offset that doesn't hit a texture alive at the same time
+            uint64_t alignment = std::max<uint64_t>(p.requirements.alignment, 1);
+            uint64_t offset = 0;
+            for (const Placement* o: taken) {
+                if (offset + p.requirements.size <= o->offset) { break; }
+                offset = std::max(offset, (o->offset + o->requirements.size + alignment - 1) / alignment * alignment);
+            }
+            p.offset = offset;
+
+            TextureMemoryRequirements& block = m_blockRequirements[p.block];
+            block.size = std::max(block.size, p.offset + p.requirements.size);
+            block.alignment = std::max(block.alignment, alignment);
+
+            placed.push_back(idx);
+        }
+
+        for (auto& p: m_placements) {
+            for (uint32_t other = 0; other < m_placements.size(); ++other) {
+                const Placement& o = m_placements[other];
+                if (&o != &p && sharesBytes(p, o) && !livesWith(p, o)) {
+                    p.aliased.push_back(other);
+                }
+            }
+        }
+    }
+
+    bool RenderGraph::RealizeTransients() {
+        std::string key;
+        //! Field by field, the requirements struct has trailing padding that isn't the same from frame to frame
+        for (const auto& block: m_blockRequirements) {
+            key.append(reinterpret_cast<const char*>(&block.size), sizeof(block.size));
+            key.append(reinterpret_cast<const char*>(&block.alignment), sizeof(block.alignment));
+            key.append(reinterpret_cast<const char*>(&block.memoryTypeBits), sizeof(block.memoryTypeBits));
+        }
+        key.push_back('|');
+        for (const auto& p: m_placements) {
+            key.append(GetDescKey(m_resources[p.resource].desc));
+            key.append(reinterpret_cast<const char*>(&p.block), sizeof(p.block));
+            key.append(reinterpret_cast<const char*>(&p.offset), sizeof(p.offset));
+        }
+
+        if (key == m_transientKey) { return true; }
+
+        DestroyTransients(&m_transients);
+        m_transientKey.clear();
+
+        for (const auto& requirements: m_blockRequirements) {
+            MemoryBlock block = m_rhi->CreateMemoryBlock(requirements);
+            m_transients.blocks.push_back(block);
+            if (!block.IsValid()) {
+                DestroyTransients(&m_transients);
+                return false;
+            }
+        }
+
+        for (const auto& p: m_placements) {
+            const Resource& res = m_resources[p.resource];
+            Texture texture = m_rhi->CreatePlacedTexture(res.desc, m_transients.blocks[p.block], p.offset);
+            m_transients.textures.push_back(texture);
+            if (!texture.IsValid()) {
+                Log(Error, "Failed to place render graph texture {}!", res.name);
+                DestroyTransients(&m_transients);
+                return false;
+            }
+        }
+
+        m_transientKey = std::move(key);
+        return true;
+    }
+
+    void RenderGraph::DestroyTransients(TransientSet *set) {
+        for (auto& texture: set->textures) {
+            if (texture.IsValid()) {
+                m_rhi->DestroyTexture(texture);
+            }
+        }
+        //! Queued after the textures, so they are freed after the textures placed into them
+        for (auto& block: set->blocks) {
+            if (block.IsValid()) {
+                m_rhi->DestroyMemoryBlock(block);
+            }
+        }
+        set->textures.clear();
+        set->blocks.clear();
+    }
+
+    const TextureMemoryRequirements& RenderGraph::GetRequirements(const TextureDescriptor &desc) {
+        std::string key = GetDescKey(desc);
+        if (auto it = m_requirementsCache.find(key); it != m_requirementsCache.end()) {
+            return it->second;
+        }
+        return m_requirementsCache.emplace(std::move(key), m_rhi->GetTextureMemoryRequirements(desc)).first->second;
+    }
+
+    std::string RenderGraph::GetDescKey(const TextureDescriptor &desc) {
+        //! Everything the image is created from, the name and the tracked layout don't matter
+        const uint32_t fields[] = {
+            desc.width, desc.height, desc.depth, desc.mips, desc.levels,
+            static_cast<uint32_t>(desc.format), static_cast<uint32_t>(desc.usageFlags), static_cast<uint32_t>(desc.textureType),
+            static_cast<uint32_t>(desc.textureViewType), static_cast<uint32_t>(desc.textureAspect)
+        };
+        return {reinterpret_cast<const char*>(fields), sizeof(fields)};
+    }
+
+    ///! ------------------- Execution ------------------- !///
+
+    void RenderGraph::Execute() {
+        if (!m_isCompiled) {
+            Log(Error, "Render graph has to be compiled before it is executed!");
+            return;
+        }
+
+        for (uint32_t passIdx = 0; passIdx < m_passes.size(); ++passIdx) {
+            RenderGraphPass& pass = m_passes[passIdx];
+            if (pass.m_isCulled) { continue; }
+
+            TransitionResources(passIdx, pass);
+
+            //! The barriers of the pass go out inside its timer, they are part of what it costs
+            GraphRHI::GpuTimerScope timer{*m_rhi, pass.m_name.c_str()};
+            m_rhi->BeginPassStatistics(pass.m_name.c_str());
+            if (pass.m_colorAttachments.empty() && !pass.m_depthAttachment.has_value()) {
+                if (pass.m_execute) {
+                    pass.m_execute(*m_rhi);
+                }
+            } else {
+                RecordRenderPass(passIdx, pass);
+            }
+            m_rhi->EndPassStatistics();
+        }
+
+        if (m_backbuffer.has_value()) {
+            m_rhi->TransitionSwapchainTexture(m_resources[*m_backbuffer].imageIdx, EResourceLayout::Present, EPipelineStageFlags::BottomOfPipeBit);
+        }
+    }
+
+    void RenderGraph::TransitionResources(uint32_t passIdx, const RenderGraphPass &pass) {
+        //! Transients start their lifetime here, after everything that used their bytes before
+        for (const auto& access: pass.m_accesses) {
+            const Resource& res = m_resources[access.resource];
+            if (res.type != EResourceType::Transient || res.firstPass != passIdx) { continue; }
+
+            const Placement& p = m_placements[res.placement];
+            std::vector<const Texture*> aliased;
+            aliased.reserve(p.aliased.size());
+            for (uint32_t other: p.aliased) {
+                aliased.push_back(&m_transients.textures[other]);
+            }
+            m_rhi->DiscardTexture(m_transients.textures[res.placement], aliased);
+        }
+
+        for (const auto& access: pass.m_accesses) {
+            const Resource& res = m_resources[access.resource];
+            switch (res.type) {
+                case EResourceType::Backbuffer:
+                    m_rhi->TransitionSwapchainTexture(res.imageIdx, access.layout, access.stages);
+                    break;
+                case EResourceType::ImportedTexture:
+                    m_rhi->TransitionTexture(*res.texture, access.layout, access.stages);
+                    break;
+                case EResourceType::Transient:
+                    m_rhi->TransitionTexture(m_transients.textures[res.placement], access.layout, access.stages);
+                    break;
+                case EResourceType::ImportedBuffer:
+                    m_rhi->TransitionBuffer(*res.buffer, access.bufferAccess, access.stages);
+                    break;
+            }
+        }
+    }
+
+    void RenderGraph::RecordRenderPass(uint32_t passIdx, RenderGraphPass &pass) {
+        RenderPassDescriptor desc;
+
+        auto attachmentInfo = [this, passIdx](const RenderGraphPass::Attachment& att, EResourceLayout layout) {
+            const Resource& res = m_resources[att.resource];
+            //! Nobody reads a transient after its last pass, its contents don't have to be written out
+            bool isDead = res.type == EResourceType::Transient && res.lastPass == passIdx;
+            return RenderPassDescriptor::RenderPassAttachmentInfo{
+                .renderTargetName = res.name.c_str(),
+                .renderTargetLayout = layout,
+                .loadOperation = att.load,
+                .storeOperation = (isDead) ? EAttachmentStoreOperation::DontCare: EAttachmentStoreOperation::Store,
+                .clearValue = att.clear
+            };
+        };
+
+        std::vector<Texture*> colorTextures;
+        std::optional<Texture*> depthTexture;
+        bool toSwapchain = false;
+        for (const auto& att: pass.m_colorAttachments) {
+            desc.colorAttachments.push_back(attachmentInfo(att, EResourceLayout::ColorAttachmentOptimal));
+
+            Resource& res = m_resources[att.resource];
+            toSwapchain |= res.type == EResourceType::Backbuffer;
+            colorTextures.push_back((res.type == EResourceType::Transient) ? &m_transients.textures[res.placement]: res.texture);
+        }
+        if (pass.m_depthAttachment.has_value()) {
+            desc.depthAttachment = attachmentInfo(*pass.m_depthAttachment, EResourceLayout::DepthStencilAttachmentOptimal);
+
+            Resource& res = m_resources[pass.m_depthAttachment->resource];
+            depthTexture = (res.type == EResourceType::Transient) ? &m_transients.textures[res.placement]: res.texture;
+        }
+
+        //! The render area is the first attachment, the RHI expects them all to be the same size
+        if (toSwapchain) {
+            desc.extent = m_rhi->GetSwapchain().GetExtent();
+        } else {
+            const Texture* first = (colorTextures.empty()) ? *depthTexture: colorTextures.front();
+            desc.extent.x = first->GetWidth();
+            desc.extent.y = first->GetHeight();
+        }
+
+        if (toSwapchain) {
+            m_rhi->BeginRenderPassToSwapchain(desc, m_resources[pass.m_colorAttachments.front().resource].imageIdx, depthTexture);
+        } else {
+            m_rhi->BeginRenderPass(desc, colorTextures, depthTexture);
+        }
+
+        //! Same flipped viewport as the swapchain one
+        m_rhi->SetViewport({
+            .x = 0.0f,
+            .y = static_cast<float>(desc.extent.y),
+            .width = static_cast<float>(desc.extent.x),
+            .height = -static_cast<float>(desc.extent.y),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f
+        });
+        Rect2D scissor;
+        scissor.extent = desc.extent;
+        m_rhi->SetScissor(scissor);
+
+        if (pass.m_execute) {
+            pass.m_execute(*m_rhi);
+        }
+
+        m_rhi->EndRenderPass();
+    }
+
+    ///! ------------------- Stats ------------------- !///
+
+    uint64_t RenderGraph::GetTransientMemorySize() const {
+        uint64_t size = 0;
+        for (const auto& block: m_blockRequirements) {
+            size += block.size;
+        }
+        return size;
+    }
+
+    uint64_t RenderGraph::GetTransientRequestedSize() const {
+        uint64_t size = 0;
+        for (const auto& p: m_placements) {
+            size += p.requirements.size;
+        }
+        return size;
+    }
+
+    void RenderGraph::Destroy() {
+        ReleaseTransients();
+        m_requirementsCache.clear();
+
+        m_resources.clear();
+        m_resourceNames.clear();
+        m_passes.clear();
+        m_placements.clear();
+        m_blockRequirements.clear();
+        m_isCompiled = false;
+    }
+} // Shift::gfx
@@ -0,0 +1,205 @@
+#ifndef SHIFT_RENDERGRAPH_HPP
+#define SHIFT_RENDERGRAPH_HPP
+
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/RHI.hpp"
+
+namespace Shift::gfx {
+#ifdef SHIFT_VULKAN_BACKEND
+    using GraphRHI = RenderHardwareInterface<RHI::Vulkan>;
+#endif
+
+    //! A resource declared in the graph, only valid for the frame it was declared in
+    struct RGResource {
+        uint32_t index = UINT32_MAX;
+
+        [[nodiscard]] bool IsValid() const { return index != UINT32_MAX; }
+    };
+
+    //! A pass of the graph and what it touches. Passes with attachments get their render pass begun and ended by the
+    //! graph, with the viewport and scissor covering the attachments. Every access becomes a transition before the pass
+    class RenderGraphPass {
+        friend class RenderGraph;
+    public:
+        using ExecuteFunc = std::function<void(GraphRHI& rhi)>;
+
+        //! Render into a color texture, loading the previous contents makes it a read too
+        RenderGraphPass& ColorAttachment(RGResource resource, EAttachmentLoadOperation load = EAttachmentLoadOperation::Clear, const AttachmentClearValue& clear = {.color = {0.0f, 0.0f, 0.0f, 1.0f}});
+        //! Use a depth texture as the depth attachment, loading the previous contents makes it a read too
+        RenderGraphPass& DepthAttachment(RGResource resource, EAttachmentLoadOperation load = EAttachmentLoadOperation::Clear, const AttachmentClearValue& clear = {.depthStencil = {1.0f, 0u}});
+        //! Sample a texture in the given stages
+        RenderGraphPass& Read(RGResource resource, EPipelineStageFlags stages = EPipelineStageFlags::FragmentShaderBit);
+        //! Any other texture access (transfers, storage images)
+        RenderGraphPass& Access(RGResource resource, EResourceLayout layout, EPipelineStageFlags stages, bool isRead, bool isWrite);
+        //! Access an imported buffer, ShaderWrite and TransferWrite are writes
+        RenderGraphPass& BufferAccess(RGResource resource, EBufferAccess access, EPipelineStageFlags stages);
+        //! The pass does something the graph can't see (readbacks, queries), it's never culled
+        RenderGraphPass& SideEffects() { m_hasSideEffects = true; return *this; }
+
+        [[nodiscard]] const std::string& GetName() const { return m_name; }
+        [[nodiscard]] bool IsCulled() const { return m_isCulled; }
+    private:
+        struct ResourceAccess {
+            uint32_t resource;
+            EResourceLayout layout;
+            EBufferAccess bufferAccess;
+            EPipelineStageFlags stages;
+            bool isRead;
+            bool isWrite;
+        };
+
+        struct Attachment {
+            uint32_t resource;
+            EAttachmentLoadOperation load;
+            AttachmentClearValue clear;
+        };
+
+        std::string m_name;
+        ExecuteFunc m_execute;
+
+        std::vector<ResourceAccess> m_accesses;
+        std::vector<Attachment> m_colorAttachments;
+        std::optional<Attachment> m_depthAttachment;
+
+        bool m_hasSideEffects = false;
+        bool m_isCulled = false;
+    };
+
+    //! A frame graph over the RHI, declared again every frame: resources and passes, then Compile and Execute.
+    //! Passes run in the order they were added, so a pass can only read what an earlier pass wrote. Compile culls the
+    //! passes nothing observable depends on (imported resources and side effects are observable), derives the
+    //! transitions from the declared accesses and places the transient textures into shared memory blocks, so the ones
+    //! whose lifetimes don't overlap take the same bytes. The placed textures are kept while the transients of the
+    //! frames stay the same, a change rebuilds them and the old ones go through the deferred destroys of the RHI.
+    class RenderGraph {
+    public:
+        //! \param rhi the RHI the graph records with
+        void Init(GraphRHI* rhi);
+
+        //! Drop the declarations of the last frame, call after BeginCmds
+        void Reset();
+        //! Let go of the realized transients, the next compile builds them again. Reset does it on its own when the
+        //! last frame didn't compile the graph and the RHI reports memory pressure
+        void ReleaseTransients();
+
+        //! A texture that only lives inside the graph, its contents don't survive the frame
+        //! \param name unique name, render pass descriptors reference attachments by it
+        //! \param desc texture description, the usage has to cover every pass access
+        [[nodiscard]] RGResource CreateTexture(const std::string& name, const TextureDescriptor& desc);
+        //! A texture owned outside of the graph, the passes writing it are never culled
+        [[nodiscard]] RGResource ImportTexture(const std::string& name, Texture* texture);
+        //! A buffer owned outside of the graph, the passes writing it are never culled
+        [[nodiscard]] RGResource ImportBuffer(const std::string& name, const Buffer* buffer);
+        //! The swapchain image of the frame, it's left in the present layout after the graph
+        [[nodiscard]] RGResource ImportBackbuffer(uint32_t imageIdx);
+
+        //! Invalid handle if there is no such resource this frame
+        [[nodiscard]] RGResource FindResource(const std::string& name) const;
+        //! The texture behind a resource, transients only exist after Compile
+        [[nodiscard]] const Texture* GetTexture(RGResource resource) const;
+
+        //! Add a pass, the returned pass is used to declare its accesses
+        //! \param name pass name
+        //! \param execute records the pass, runs inside the render pass if the pass has attachments
+        RenderGraphPass& AddPass(const std::string& name, RenderGraphPass::ExecuteFunc execute);
+
+        //! Cull, compute the lifetimes and place the transients
+        //! \return false if the declarations are invalid or the transients couldn't be created
+        [[nodiscard]] bool Compile();
+
+        //! Record every pass that survived culling, each in a GPU timer and pass statistics scope of its name
+        void Execute();
+
+        //! Bytes of the memory blocks the transients live in
+        [[nodiscard]] uint64_t GetTransientMemorySize() const;
+        //! Bytes the transients would take without aliasing
+        [[nodiscard]] uint64_t GetTransientRequestedSize() const;
+
+        void Destroy();
+        ~RenderGraph() = default;
+    private:
+        enum class EResourceType : uint8_t {
+            Transient,
+            ImportedTexture,
+            ImportedBuffer,
+            Backbuffer
+        };
+
+        struct Resource {
+            std::string name;
+            EResourceType type = EResourceType::Transient;
+            TextureDescriptor desc{};
+            Texture* texture = nullptr;
+            const Buffer* buffer = nullptr;
+            uint32_t imageIdx = 0;
+            //! First and last pass that survived culling and uses it, firstPass is UINT32_MAX if none
+            uint32_t firstPass = UINT32_MAX;
+            uint32_t lastPass = 0;
+            //! Index into m_placements for transients
+            uint32_t placement = UINT32_MAX;
+        };
+
+        //! Where a transient lives
+        struct Placement {
+            uint32_t resource;
+            TextureMemoryRequirements requirements;
+            uint32_t block = 0;
+            uint64_t offset = 0;
+            //! Placements sharing bytes with this one at other times of the frame
+            std::vector<uint32_t> aliased;
+        };
+
+        //! The realized transients
+        struct TransientSet {
+            std::vector<MemoryBlock> blocks;
+            std::vector<Texture> textures;
+        };
+
+        RGResource AddResource(Resource&& resource);
+
+        //! Reverse walk, a pass survives if a later surviving pass reads what it writes or it writes an output
+        void CullPasses();
+        void ComputeLifetimes();
+        //! First fit into the blocks, textures only share bytes if their lifetimes don't overlap
+        void PlaceTransients();
+        //! Create the textures, or keep the ones of the last frames if the placement didn't change
+        [[nodiscard]] bool RealizeTransients();
+        //! Deferred through the RHI, frames in flight may still render with the set
+        void DestroyTransients(TransientSet* set);
+
+        void TransitionResources(uint32_t passIdx, const RenderGraphPass& pass);
+        void RecordRenderPass(uint32_t passIdx, RenderGraphPass& pass);
+
+        [[nodiscard]] const TextureMemoryRequirements& GetRequirements(const TextureDescriptor& desc);
+        [[nodiscard]] static std::string GetDescKey(const TextureDescriptor& desc);
+
+        GraphRHI* m_rhi = nullptr;
+
+        std::vector<Resource> m_resources;
+        std::unordered_map<std::string, uint32_t> m_resourceNames;
+        //! Stable references for the pass declarations
+        std::deque<RenderGraphPass> m_passes;
+        std::optional<uint32_t> m_backbuffer;
+
+        std::vector<Placement> m_placements;
+        //! One per block, the size is the end of the last placement in it
+        std::vector<TextureMemoryRequirements> m_blockRequirements;
+        std::unordered_map<std::string, TextureMemoryRequirements> m_requirementsCache;
+
+        //! Placements of the realized set, it's rebuilt when these change
+        std::string m_transientKey;
+        TransientSet m_transients;
+
+        bool m_isCompiled = false;
+    };
+} // Shift::gfx
+
+#endif //SHIFT_RENDERGRAPH_HPP
@@ -11,6 +11,8 @@ namespace Shift::gfx {
     bool Renderer::Init() {
 
         CheckCritical(m_SRHI.Init(m_window.GetHandle(), m_window.GetWidth(), m_window.GetHeight(), "TestApp", "1.0.0", "Shift", "2.0.0"), "Failed to initialize RHI!");
+        m_graph.Init(&m_SRHI);
+        CheckCritical(m_culling.Init(&m_SRHI), "Failed to initialize GPU culling!");
 
         LoadScene();
 
@@ -30,28 +32,18 @@ namespace Shift::gfx {
                 {EShaderType::Fragment, &ps},
             };
 
-        pipelineDescriptor.vertexConfig.vertexBindings.emplace_back(
-            0, 12, EVertexInputRate::PerVertex
-        );
-        pipelineDescriptor.vertexConfig.attributeDescs.emplace_back(
-            0, 0, 0, EVertexAttributeFormat::R32G32B32_SignedFloat
-        );
+        //! Vertex input and descriptor layouts come from the shader reflection
         pipelineDescriptor.colorBlendConfig.attachments.push_back({.format = ETextureFormat::B8G8R8A8_SRGB});
 
-        p = m_SRHI.CreatePipeline(pipelineDescriptor, stages);
+        m_pipeline = m_SRHI.RequestPipeline(pipelineDescriptor, stages);
 
         uint32_t bufSize = 3 * sizeof(float) * 3;
-        BufferDescriptor bufferDescriptor;
-        bufferDescriptor.type = EBufferType::Staging;
-        bufferDescriptor.name = "Stage";
-        bufferDescriptor.size = bufSize;
-        Buffer staging = m_SRHI.CreateBuffer(bufferDescriptor);
-
         BufferDescriptor bufferDescriptor2;
         bufferDescriptor2.type = EBufferType::Vertex;
         bufferDescriptor2.name = "Vertex";
         bufferDescriptor2.size = bufSize;
-        vertex = m_SRHI.CreateBuffer(bufferDescriptor2);
+        vertex = m_SRHI.CreateBufferHandle(bufferDescriptor2);
+        CheckCritical(vertex.IsValid(), "Failed to create the vertex buffer!");
 
         std::vector<float> vertexData = {
             0.5f,  0.5f, 0.5f,
@@ -59,9 +51,22 @@ namespace Shift::gfx {
             0.5f, -0.5f, 0.5f
         };
 
-        staging.Fill(vertexData.data(), bufSize, 0);
-        m_SRHI.CopyBufferToBuffer({&staging, 0}, {&vertex, 0}, bufSize);
-        staging.Destroy();
+        m_vertexToken = m_SRHI.UploadToBufferAsync(vertexData.data(), bufSize, {m_SRHI.GetBuffer(vertex), 0});
+        CheckCritical(m_vertexToken.IsValid(), "Failed to upload the vertex data!");
+        CheckCritical(m_SRHI.SubmitAsyncUploads(), "Failed to submit the vertex data upload!");
+
+        //! Same vertex layout as the triangle, so the culled quad is drawn with its pipeline
+        const float quadVertices[] = {
+            -0.9f, -0.9f, 0.5f,
+            -0.5f, -0.9f, 0.5f,
+            -0.5f, -0.5f, 0.5f,
+            -0.9f, -0.5f, 0.5f
+        };
+        const uint32_t quadIndices[] = {0, 1, 2, 2, 3, 0};
+        m_quad = m_SRHI.CreateMesh(quadVertices, 4, quadIndices);
+        CheckCritical(m_quad.IsValid(), "Failed to create the quad mesh!");
+        m_quadInstance = m_culling.AddInstance(m_quad, 0, glm::vec3{0.0f}, 1.0f, 0);
+        CheckCritical(m_quadInstance.IsValid(), "Failed to add the quad to the GPU culling!");
 
         return true;
     }
@@ -80,29 +85,49 @@ namespace Shift::gfx {
         uint32_t imageIndex = AquireImage(&aquireSuccess);
         if (imageIndex == UINT32_MAX) { return aquireSuccess; }
 
-        m_SRHI.TransitionSwapchainTexture(imageIndex, EResourceLayout::ColorAttachmentOptimal, EPipelineStageFlags::ColorAttachmentOutputBit);
-
-        m_SRHI.SetScissor(m_SRHI.GetSwapchain().GetScissor());
-        m_SRHI.SetViewport(m_SRHI.GetSwapchain().GetViewport());
-        RenderPassDescriptor renderPass;
-        renderPass.colorAttachments.push_back(
-            {
-                .renderTargetName = "SwapchainBackbuffer",
-                .clearValue = {.color = {0.3f, 0.3f, 0.3f, 1.0f}}
+        if (Conf::SHIFT_RECORDING_BENCHMARK_DRAWS > 0 && !m_hasRunRecordingBenchmark && m_SRHI.IsTransferReady(m_vertexToken)) {
+            if (const Pipeline* pipeline = m_SRHI.GetPipeline(m_pipeline)) {
+                RecordingBenchmark::Run(m_SRHI, *pipeline, {m_SRHI.GetBuffer(vertex), 0}, ETextureFormat::B8G8R8A8_SRGB,
+                                        Conf::SHIFT_RECORDING_BENCHMARK_DRAWS, Conf::SHIFT_RECORDING_BENCHMARK_REPEATS);
+                m_hasRunRecordingBenchmark = true;
             }
-        );
-        renderPass.extent = m_SRHI.GetSwapchain().GetExtent();
-        m_SRHI.BeginRenderPassToSwapchain(renderPass, imageIndex, std::nullopt);
+        }
+
+        //! The graph does the transitions, the render pass and the present layout
+        m_graph.Reset();
+        RGResource backbuffer = m_graph.ImportBackbuffer(imageIndex);
 
-        m_SRHI.BindGraphicsPipeline(p);
+        //! Passes drawing the culled buckets go after it and declare their reads with ReadDraws
+        if (m_culling.GetInstanceCount() > 0) {
+            m_culling.AddCullPass(m_graph, engineData.projMatrix * engineData.viewMatrix);
+        }
 
-        m_SRHI.BindVertexBuffer({&vertex, 0}, 0);
+        m_graph.AddPass("Triangle", [this](GraphRHI& rhi) {
+            //! Never stall the frame on streaming or compilation, just skip the draw until both are in
+            const Pipeline* pipeline = rhi.GetPipeline(m_pipeline);
+            if (rhi.IsTransferReady(m_vertexToken) && pipeline != nullptr) {
+                rhi.BindGraphicsPipeline(*pipeline);
 
+                rhi.BindVertexBuffer(vertex, 0);
 
-        m_SRHI.Draw({3, 1, 0, 0});
-        m_SRHI.EndRenderPass();
+                rhi.Draw({3, 1, 0, 0});
+            }
+        }).ColorAttachment(backbuffer, EAttachmentLoadOperation::Clear, {.color = {0.3f, 0.3f, 0.3f, 1.0f}});
+
+        if (m_culling.GetInstanceCount() > 0) {
+            RenderGraphPass& culledPass = m_graph.AddPass("Culled Meshes", [this](GraphRHI& rhi) {
+                const Pipeline* pipeline = rhi.GetPipeline(m_pipeline);
+                if (pipeline == nullptr) { return; }
+
+                rhi.BindGraphicsPipeline(*pipeline);
+                rhi.BindGeometryArena();
+                m_culling.DrawBucket(rhi, 0);
+            }).ColorAttachment(backbuffer, EAttachmentLoadOperation::Load);
+            m_culling.ReadDraws(culledPass);
+        }
 
-        m_SRHI.TransitionSwapchainTexture(imageIndex, EResourceLayout::Present, EPipelineStageFlags::BottomOfPipeBit);
+        CheckCritical(m_graph.Compile(), "Failed to compile the render graph!");
+        m_graph.Execute();
 
         CheckCritical(m_SRHI.EndCmds(), "Failed to end the command Buffer!");
 
@@ -120,10 +145,14 @@ namespace Shift::gfx {
 
     void Renderer::Cleanup() {
         m_SRHI.WaitForGPU();
-        p.Destroy();
-        vs.Destroy();
-        ps.Destroy();
-        vertex.Destroy();
+        //! The shaders can only go once nothing compiles with them anymore
+        m_SRHI.WaitForPipeline(m_pipeline);
+        m_SRHI.DestroyShader(vs);
+        m_SRHI.DestroyShader(ps);
+        m_SRHI.DestroyBuffer(vertex);
+        m_culling.Destroy();
+        m_SRHI.DestroyMesh(m_quad);
+        m_graph.Destroy();
         m_SRHI.Destroy();
     }
 
@@ -135,7 +164,7 @@ namespace Shift::gfx {
         if (isOld || m_window.ShouldProcessResize()) {
             m_window.ProcessResize();
             m_controller->UpdateScreenSize(static_cast<float>(m_window.GetWidth()), static_cast<float>(m_window.GetHeight()));
-            if (!m_SRHI.GetSwapchain().Recreate(m_window.GetWidth(), m_window.GetHeight())) { return false; }
+            if (!m_SRHI.SwapchainRecreate(m_window.GetWidth(), m_window.GetHeight())) { return false; }
         }
 
         return true;
@@ -147,7 +176,7 @@ namespace Shift::gfx {
         if (imageIndex == UINT32_MAX) {
             *success = false;
         } else if (changed) {
-            if (!m_SRHI.GetSwapchain().Recreate(m_window.GetWidth(), m_window.GetHeight())) {
+            if (!m_SRHI.SwapchainRecreate(m_window.GetWidth(), m_window.GetHeight())) {
                 *success = false;
             }
             return UINT32_MAX;
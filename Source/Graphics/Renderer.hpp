@@ -11,6 +11,9 @@
 #include "Input/Controllers/Camera/FlyingCameraController.hpp"
 
 #include "Graphics/RHI/RHI.hpp"
+#include "Graphics/RenderGraph/RenderGraph.hpp"
+#include "Graphics/Systems/GpuCulling.hpp"
+#include "Graphics/Systems/RecordingBenchmark.hpp"
 
 namespace Shift::gfx {
     //! A struct with data that can change per-frame
@@ -32,6 +35,10 @@ namespace Shift::gfx {
         float fps;
         float secondsSinceStart;
         float frameTimeMs;
+        /// GPU timers, a few frames behind
+        float gpuFrameTimeMs;
+        std::vector<GpuTimerResult> gpuPassTimes;
+        std::vector<PassStatistics> gpuPassStatistics;
     };
 
     class Renderer {
@@ -64,6 +71,14 @@ namespace Shift::gfx {
 
         //! Cleanup unused resources
         void Cleanup();
+
+        //! GPU time of the last resolved frame
+        [[nodiscard]] float GetGpuFrameTimeMs() const { return m_SRHI.GetGpuFrameTimeMs(); }
+        //! Swap the GPU time of every render graph pass of the last resolved frame into out, left alone if nothing new
+        void TakeGpuPassTimes(std::vector<GpuTimerResult>* out) { m_SRHI.TakeGpuTimerResults(out); }
+        //! Swap the pipeline statistics and occlusion counts of every render graph pass of the last resolved frame into
+        //! out, left alone if nothing new
+        void TakeGpuPassStatistics(std::vector<PassStatistics>* out) { m_SRHI.TakePassStatistics(out); }
     private:
         [[nodiscard]] uint32_t AquireImage(bool *success);
         [[nodiscard]] bool PresentFinalImage(uint32_t imageIndex);
@@ -71,13 +86,25 @@ namespace Shift::gfx {
         ShiftWindow& m_window;
         std::shared_ptr<ctrl::FlyingCameraController> m_controller;
 
-        Pipeline p;
+        //! Compiled in the background, nothing is drawn until it is ready
+        PipelineHandle m_pipeline;
         Shader vs;
         Shader ps;
-        Buffer vertex;
+        BufferHandle vertex;
+        //! The vertex data streams in on the transfer queue, we draw once it is there
+        TransferToken m_vertexToken;
+        //! The recording benchmark runs once, as soon as the triangle can be drawn
+        bool m_hasRunRecordingBenchmark = false;
+        //! Arena quad drawn through the GPU culling, it drops out once its bounding sphere leaves the view
+        MeshHandle m_quad;
+        CullInstanceHandle m_quadInstance;
 
 #ifdef SHIFT_VULKAN_BACKEND
         RenderHardwareInterface<RHI::Vulkan> m_SRHI;
+        //! Declared again every frame, the transients it places are kept while they don't change
+        RenderGraph m_graph;
+        //! Frustum culls the arena mesh instances on the GPU and draws them per bucket with indirect draws
+        GpuCulling m_culling;
 #endif
 
         //! Shift API
@@ -0,0 +1,218 @@
+#include "GpuCulling.hpp"
+
+#include <algorithm>
+
+#include "Utility/UtilStandard.hpp"
+
+namespace Shift::gfx {
+    bool GpuCulling::Init(GraphRHI *rhi) {
+        m_rhi = rhi;
+
+        m_shader = m_rhi->CreateShader({.type = EShaderType::Compute, .path = Util::GetShiftShaderBuildDir() + "GpuCulling.comp.spv"});
+        if (!m_shader.IsValid()) {
+            Log(Error, "Failed to create the GPU culling shader!");
+            return false;
+        }
+        //! The set layout and push constants come from the reflection
+        m_pipeline = m_rhi->RequestPipeline(PipelineDescriptor{}, {{EShaderType::Compute, &m_shader}});
+
+        auto createBuffer = [this](const char* name, EBufferType type, uint64_t size) {
+            return m_rhi->CreateBufferHandle({.size = size, .name = name, .type = type});
+        };
+        m_instanceBuffer = createBuffer("GpuCullingInstances", EBufferType::Storage, Conf::SHIFT_GPU_CULLING_MAX_INSTANCES * sizeof(CullInstance));
+        m_bucketBaseBuffer = createBuffer("GpuCullingBucketBases", EBufferType::Storage, Conf::SHIFT_GPU_CULLING_BUCKET_COUNT * sizeof(uint32_t));
+        m_drawBuffer = createBuffer("GpuCullingDraws", EBufferType::Indirect, Conf::SHIFT_GPU_CULLING_MAX_INSTANCES * sizeof(DrawIndexedConfig));
+        m_countBuffer = createBuffer("GpuCullingCounts", EBufferType::Indirect, Conf::SHIFT_GPU_CULLING_BUCKET_COUNT * sizeof(uint32_t));
+        if (!m_instanceBuffer.IsValid() || !m_bucketBaseBuffer.IsValid() || !m_drawBuffer.IsValid() || !m_countBuffer.IsValid()) {
+            Log(Error, "Failed to create the GPU culling buffers!");
+            return false;
+        }
+
+        m_useDrawCount = m_rhi->SupportsDrawIndirectCount() && m_rhi->SupportsMultiDrawIndirect();
+        if (!m_useDrawCount) {
+            Log(Warning, "No drawIndirectCount or multiDrawIndirect, GPU culled buckets draw their full range with the culled draws emptied");
+        }
+        return true;
+    }
+
+    CullInstanceHandle GpuCulling::AddInstance(MeshHandle mesh, uint32_t bucket, const glm::vec3 &center, float radius, uint32_t userIndex) {
+        const MeshRange* range = m_rhi->GetMeshRange(mesh);
+        if (range == nullptr || range->indexCount == 0 || bucket >= Conf::SHIFT_GPU_CULLING_BUCKET_COUNT) {
+            Log(Error, "GPU culling takes indexed arena meshes and buckets below {}", Conf::SHIFT_GPU_CULLING_BUCKET_COUNT);
+            return {};
+        }
+        if (m_instances.GetCount() == Conf::SHIFT_GPU_CULLING_MAX_INSTANCES) {
+            Log(Error, "GPU culling is out of instances!");
+            return {};
+        }
+
+        CullInstanceHandle handle = m_instances.Insert({
+            .sphere = glm::vec4{center, radius},
+            .indexCount = range->indexCount,
+            .firstIndex = range->firstIndex,
+            .vertexOffset = range->vertexOffset,
+            .bucket = bucket,
+            .userIndex = userIndex
+        });
+        MarkDirty(m_instances.GetCount() - 1);
+
+        ++m_bucketSizes[bucket];
+        m_areBasesDirty = true;
+        return handle;
+    }
+
+    void GpuCulling::UpdateInstance(CullInstanceHandle handle, const glm::vec3 &center, float radius) {
+        CullInstance* instance = m_instances.Get(handle);
+        if (instance == nullptr) { return; }
+
+        instance->sphere = glm::vec4{center, radius};
+        MarkDirty(static_cast<uint32_t>(instance - m_instances.GetObjects().data()));
+    }
+
+    void GpuCulling::RemoveInstance(CullInstanceHandle handle) {
+        const CullInstance* instance = m_instances.Get(handle);
+        if (instance == nullptr) { return; }
+
+        //! The last instance moves into the hole, that slot gets uploaded again
+        auto denseIdx = static_cast<uint32_t>(instance - m_instances.GetObjects().data());
+        if (auto removed = m_instances.Remove(handle)) {
+            --m_bucketSizes[removed->bucket];
+            m_areBasesDirty = true;
+        }
+        if (denseIdx < m_instances.GetCount()) {
+            MarkDirty(denseIdx);
+        }
+    }
+
+    void GpuCulling::AddCullPass(RenderGraph &graph, const glm::mat4 &viewProj) {
+        UploadChanges();
+
+        RGResource instances = graph.ImportBuffer("GpuCullingInstances", m_rhi->GetBuffer(m_instanceBuffer));
+        RGResource bucketBases = graph.ImportBuffer("GpuCullingBucketBases", m_rhi->GetBuffer(m_bucketBaseBuffer));
+        m_drawResource = graph.ImportBuffer("GpuCullingDraws", m_rhi->GetBuffer(m_drawBuffer));
+        m_countResource = graph.ImportBuffer("GpuCullingCounts", m_rhi->GetBuffer(m_countBuffer));
+
+        CullConstants constants{.planes = ExtractFrustumPlanes(viewProj), .instanceCount = m_instances.GetCount()};
+        graph.AddPass("GPU Culling", [this, constants](GraphRHI& rhi) {
+            Buffer* counts = rhi.GetBuffer(m_countBuffer);
+            Buffer* draws = rhi.GetBuffer(m_drawBuffer);
+
+            //! Cleared even while the pipeline compiles, the buckets then simply draw nothing
+            rhi.TransitionBuffer(*counts, EBufferAccess::TransferWrite, EPipelineStageFlags::TransferBit);
+            rhi.FillBuffer({counts, 0}, counts->GetSize());
+            if (!m_useDrawCount && constants.instanceCount > 0) {
+                rhi.TransitionBuffer(*draws, EBufferAccess::TransferWrite, EPipelineStageFlags::TransferBit);
+                rhi.FillBuffer({draws, 0}, constants.instanceCount * sizeof(DrawIndexedConfig));
+            }
+
+            const Pipeline* pipeline = rhi.GetPipeline(m_pipeline);
+            if (pipeline == nullptr || constants.instanceCount == 0 || !EnsureResourceSet()) { return; }
+
+            rhi.TransitionBuffer(*counts, EBufferAccess::ShaderWrite, EPipelineStageFlags::ComputeShaderBit);
+            rhi.TransitionBuffer(*draws, EBufferAccess::ShaderWrite, EPipelineStageFlags::ComputeShaderBit);
+
+            const ResourceSet* sets[] = {&m_set};
+            rhi.BindComputePipeline(*pipeline);
+            rhi.BindResourceSets(*pipeline, sets, 0);
+            rhi.PushConstants(*pipeline, constants);
+            rhi.Dispatch((constants.instanceCount + Conf::SHIFT_GPU_CULLING_GROUP_SIZE - 1) / Conf::SHIFT_GPU_CULLING_GROUP_SIZE);
+        })
+        .BufferAccess(instances, EBufferAccess::ShaderRead, EPipelineStageFlags::ComputeShaderBit)
+        .BufferAccess(bucketBases, EBufferAccess::ShaderRead, EPipelineStageFlags::ComputeShaderBit)
+        .BufferAccess(m_drawResource, EBufferAccess::ShaderWrite, EPipelineStageFlags::ComputeShaderBit)
+        .BufferAccess(m_countResource, EBufferAccess::ShaderWrite, EPipelineStageFlags::ComputeShaderBit);
+    }
+
+    void GpuCulling::ReadDraws(RenderGraphPass &pass) const {
+        pass.BufferAccess(m_drawResource, EBufferAccess::IndirectRead, EPipelineStageFlags::DrawIndirectBit)
+            .BufferAccess(m_countResource, EBufferAccess::IndirectRead, EPipelineStageFlags::DrawIndirectBit);
+    }
+
+    void GpuCulling::DrawBucket(GraphRHI &rhi, uint32_t bucket) const {
+        if (bucket >= Conf::SHIFT_GPU_CULLING_BUCKET_COUNT || m_bucketSizes[bucket] == 0) { return; }
+
+        BufferOpDescriptor draws{rhi.GetBuffer(m_drawBuffer), m_bucketBases[bucket] * static_cast<uint32_t>(sizeof(DrawIndexedConfig))};
+        if (m_useDrawCount) {
+            rhi.DrawIndexedIndirectCount(draws, {rhi.GetBuffer(m_countBuffer), bucket * static_cast<uint32_t>(sizeof(uint32_t))}, m_bucketSizes[bucket]);
+        } else {
+            rhi.DrawIndexedIndirect(draws, m_bucketSizes[bucket]);
+        }
+    }
+
+    void GpuCulling::Destroy() {
+        //! The shader can only go once nothing compiles with it anymore
+        m_rhi->WaitForPipeline(m_pipeline);
+        m_rhi->DestroyShader(m_shader);
+
+        m_rhi->DestroyBuffer(m_instanceBuffer);
+        m_rhi->DestroyBuffer(m_bucketBaseBuffer);
+        m_rhi->DestroyBuffer(m_drawBuffer);
+        m_rhi->DestroyBuffer(m_countBuffer);
+
+        m_instances.Clear();
+        m_bucketSizes.fill(0);
+        m_dirtyBegin = UINT32_MAX;
+        m_dirtyEnd = 0;
+        m_rhi = nullptr;
+    }
+
+    void GpuCulling::UploadChanges() {
+        if (m_dirtyBegin < m_dirtyEnd) {
+            std::span<const CullInstance> dirty = m_instances.GetObjects().subspan(m_dirtyBegin, m_dirtyEnd - m_dirtyBegin);
+            m_rhi->UploadToBuffer(dirty.data(), dirty.size_bytes(), {m_rhi->GetBuffer(m_instanceBuffer), m_dirtyBegin * static_cast<uint32_t>(sizeof(CullInstance))});
+        }
+        m_dirtyBegin = UINT32_MAX;
+        m_dirtyEnd = 0;
+
+        if (m_areBasesDirty) {
+            uint32_t base = 0;
+            for (uint32_t i = 0; i < Conf::SHIFT_GPU_CULLING_BUCKET_COUNT; ++i) {
+                m_bucketBases[i] = base;
+                base += m_bucketSizes[i];
+            }
+            m_rhi->UploadToBuffer(m_bucketBases.data(), sizeof(m_bucketBases), {m_rhi->GetBuffer(m_bucketBaseBuffer), 0});
+            m_areBasesDirty = false;
+        }
+    }
+
+    bool GpuCulling::EnsureResourceSet() {
+        if (m_set.IsValid()) { return true; }
+
+        const Pipeline* pipeline = m_rhi->GetPipeline(m_pipeline);
+        if (pipeline == nullptr || pipeline->GetDescriptor().descriptorLayouts.empty()) { return false; }
+
+        m_set = m_rhi->CreateResourceSet(pipeline->GetDescriptor().descriptorLayouts[0]);
+        if (!m_set.IsValid()) {
+            Log(Error, "Failed to create the GPU culling resource set!");
+            return false;
+        }
+        m_set.UpdateStorageBuffer(0, *m_rhi->GetBuffer(m_instanceBuffer));
+        m_set.UpdateStorageBuffer(1, *m_rhi->GetBuffer(m_bucketBaseBuffer));
+        m_set.UpdateStorageBuffer(2, *m_rhi->GetBuffer(m_drawBuffer));
+        m_set.UpdateStorageBuffer(3, *m_rhi->GetBuffer(m_countBuffer));
+        m_set.Apply();
+        return true;
+    }
+
+    void GpuCulling::MarkDirty(uint32_t denseIdx) {
+        m_dirtyBegin = std::min(m_dirtyBegin, denseIdx);
+        m_dirtyEnd = std::max(m_dirtyEnd, denseIdx + 1);
+    }
+
+    std::array<glm::vec4, 6> GpuCulling::ExtractFrustumPlanes(const glm::mat4 &viewProj) {
+        //! Gribb-Hartmann on the rows, near is row 2 alone as the depth goes from zero to one
+        glm::mat4 rows = glm::transpose(viewProj);
+        std::array<glm::vec4, 6> planes{
+            rows[3] + rows[0],
+            rows[3] - rows[0],
+            rows[3] + rows[1],
+            rows[3] - rows[1],
+            rows[2],
+            rows[3] - rows[2]
+        };
+        for (glm::vec4& plane: planes) {
+            plane /= glm::length(glm::vec3{plane});
+        }
+        return planes;
+    }
+} // Shift::gfx
@@ -0,0 +1,122 @@
+#ifndef SHIFT_GPUCULLING_HPP
+#define SHIFT_GPUCULLING_HPP
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+#include "Config/EngineConfig.hpp"
+
+#include "Graphics/RHI/RHI.hpp"
+#include "Graphics/RenderGraph/RenderGraph.hpp"
+
+namespace Shift::gfx {
+    //! An instance as the culling shader sees it, mirrors CullInstance in GpuCulling.comp
+    struct CullInstance {
+        //! World space bounding sphere, xyz - center, w - radius
+        glm::vec4 sphere{0.0f};
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+        uint32_t bucket = 0;
+        //! Becomes firstInstance of the draw, the vertex shader finds its per instance data with it
+        uint32_t userIndex = 0;
+        uint32_t pad[3]{};
+    };
+
+    using CullInstanceHandle = Handle<CullInstance>;
+
+    //! GPU driven drawing of geometry arena meshes. The instances live in a GPU buffer that only gets the changes
+    //! uploaded, a compute pass frustum culls all of them and appends the visible ones to the indirect draw commands of
+    //! their bucket, and each bucket is then one DrawIndexedIndirectCount. The CPU cost per frame doesn't depend on the
+    //! instance count. Without drawIndirectCount (or multiDrawIndirect) the commands are zeroed first and every bucket
+    //! draws its full range, the culled slots stay empty draws. Without multiDrawIndirect that is one draw per slot.
+    class GpuCulling {
+    public:
+        //! Create the buffers and request the culling pipeline
+        //! \param rhi the RHI the passes record with
+        //! \return false if failed
+        [[nodiscard]] bool Init(GraphRHI* rhi);
+
+        //! Add an instance of an arena mesh, it's culled and drawn every frame until removed
+        //! \param mesh indexed geometry arena mesh
+        //! \param bucket draw bucket, below Conf::SHIFT_GPU_CULLING_BUCKET_COUNT
+        //! \param center world space center of the bounding sphere
+        //! \param radius bounding sphere radius
+        //! \param userIndex firstInstance of its draw
+        //! \return invalid handle for a stale or non indexed mesh, a bad bucket or when full
+        [[nodiscard]] CullInstanceHandle AddInstance(MeshHandle mesh, uint32_t bucket, const glm::vec3& center, float radius, uint32_t userIndex);
+
+        //! Move the bounding sphere of an instance
+        void UpdateInstance(CullInstanceHandle handle, const glm::vec3& center, float radius);
+
+        void RemoveInstance(CullInstanceHandle handle);
+
+        [[nodiscard]] uint32_t GetInstanceCount() const { return m_instances.GetCount(); }
+
+        //! Upload the changed instances and add the culling pass, before the passes that draw the buckets
+        //! \param graph the graph of this frame
+        //! \param viewProj view projection matrix the frustum comes from
+        void AddCullPass(RenderGraph& graph, const glm::mat4& viewProj);
+
+        //! Declare the reads of the draw commands on a pass that draws buckets, after AddCullPass
+        void ReadDraws(RenderGraphPass& pass) const;
+
+        //! Draw every visible instance of a bucket with one indirect draw, inside a pass declared with ReadDraws.
+        //! The pipeline and the geometry arena have to be bound already
+        void DrawBucket(GraphRHI& rhi, uint32_t bucket) const;
+
+        //! Wait for the culling pipeline and destroy everything, the GPU must not use the buffers anymore
+        void Destroy();
+        ~GpuCulling() = default;
+    private:
+        //! Push constants of GpuCulling.comp
+        struct CullConstants {
+            std::array<glm::vec4, 6> planes;
+            uint32_t instanceCount;
+            uint32_t pad[3];
+        };
+
+        //! Upload the dirty instance range and the bucket bases if the bucket sizes changed
+        void UploadChanges();
+
+        //! Create the resource set once the pipeline is ready, its layout comes from the reflection
+        //! \return false if the pipeline isn't ready or the set failed
+        [[nodiscard]] bool EnsureResourceSet();
+
+        void MarkDirty(uint32_t denseIdx);
+
+        //! Normalized planes pointing inside, from a zero to one depth projection
+        [[nodiscard]] static std::array<glm::vec4, 6> ExtractFrustumPlanes(const glm::mat4& viewProj);
+
+        GraphRHI* m_rhi = nullptr;
+
+        Shader m_shader;
+        PipelineHandle m_pipeline;
+        ResourceSet m_set;
+
+        BufferHandle m_instanceBuffer;
+        BufferHandle m_bucketBaseBuffer;
+        BufferHandle m_drawBuffer;
+        BufferHandle m_countBuffer;
+
+        HandlePool<CullInstance> m_instances;
+        //! Dense range that changed since the last upload
+        uint32_t m_dirtyBegin = UINT32_MAX;
+        uint32_t m_dirtyEnd = 0;
+
+        //! DrawIndexedIndirectCount per bucket, else the full range of zeroed and rewritten commands
+        bool m_useDrawCount = false;
+
+        std::array<uint32_t, Conf::SHIFT_GPU_CULLING_BUCKET_COUNT> m_bucketSizes{};
+        //! First draw command of every bucket, the prefix sum of the sizes
+        std::array<uint32_t, Conf::SHIFT_GPU_CULLING_BUCKET_COUNT> m_bucketBases{};
+        bool m_areBasesDirty = false;
+
+        //! Graph resources of the current frame, set by AddCullPass
+        RGResource m_drawResource;
+        RGResource m_countResource;
+    };
+} // Shift::gfx
+
+#endif //SHIFT_GPUCULLING_HPP
@@ -0,0 +1,66 @@
+#include "RecordingBenchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+namespace Shift::gfx {
+    std::vector<RecordingBenchmark::Result> RecordingBenchmark::Run(GraphRHI &rhi, const Pipeline &pipeline, const BufferOpDescriptor &vertex,
+                                                                   ETextureFormat colorFormat, uint32_t drawCount, uint32_t repeats)
+    {
+        std::vector<Result> results;
+        const ETextureFormat colorFormats[] = {colorFormat};
+
+        for (uint32_t workerCount = 1; workerCount <= rhi.GetRecordingWorkerCount(); ++workerCount) {
+            Result result{.workerCount = workerCount, .ms = std::numeric_limits<double>::max()};
+
+            for (uint32_t repeat = 0; repeat < std::max(repeats, 1u); ++repeat) {
+                std::atomic<bool> failed = false;
+                std::vector<std::thread> workers;
+                workers.reserve(workerCount);
+
+                auto start = std::chrono::steady_clock::now();
+                for (uint32_t workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
+                    uint32_t first = drawCount * workerIdx / workerCount;
+                    uint32_t last = drawCount * (workerIdx + 1) / workerCount;
+                    workers.emplace_back([&, workerIdx, first, last]() {
+                        CommandBuffer* cmd = rhi.BeginSecondaryCmds(workerIdx, colorFormats, std::nullopt);
+                        if (cmd == nullptr) { failed = true; return; }
+
+                        cmd->SetViewport({.x = 0.0f, .y = 0.0f, .width = 1.0f, .height = 1.0f, .minDepth = 0.0f, .maxDepth = 1.0f});
+                        Rect2D scissor;
+                        scissor.extent = {1, 1};
+                        cmd->SetScissor(scissor);
+                        cmd->BindGraphicsPipeline(pipeline);
+                        cmd->BindVertexBuffer(vertex, 0);
+                        for (uint32_t draw = first; draw < last; ++draw) {
+                            cmd->Draw({3, 1, 0, draw});
+                        }
+                        if (!cmd->End()) { failed = true; }
+                    });
+                }
+                for (std::thread& worker: workers) {
+                    worker.join();
+                }
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                if (failed) {
+                    Log(Error, "Recording benchmark failed to record with {} workers!", workerCount);
+                    return {};
+                }
+                result.ms = std::min(result.ms, ms);
+            }
+
+            result.drawsPerSecond = drawCount / (result.ms / 1000.0);
+            results.push_back(result);
+        }
+
+        for (const Result& result: results) {
+            Log(Info, "Recording benchmark: {} draws, {} workers: {:.3f} ms, {:.2f} Mdraws/s, {:.2f}x",
+                drawCount, result.workerCount, result.ms, result.drawsPerSecond / 1e6, results.front().ms / result.ms);
+        }
+        return results;
+    }
+} // Shift::gfx
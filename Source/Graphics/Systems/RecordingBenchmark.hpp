@@ -0,0 +1,35 @@
+#ifndef SHIFT_RECORDINGBENCHMARK_HPP
+#define SHIFT_RECORDINGBENCHMARK_HPP
+
+#include "Graphics/RHI/RHI.hpp"
+#include "Graphics/RenderGraph/RenderGraph.hpp"
+
+namespace Shift::gfx {
+    //! Recording throughput of the parallel recorder against the worker count. A draw list is split evenly over 1..N
+    //! workers, each records its share into a secondary buffer on a thread of its own, and the wall time until all of
+    //! them ended is logged per worker count with the draws per second and the speedup over one worker. The secondaries
+    //! are never executed, they are recycled with the frame slot.
+    class RecordingBenchmark {
+    public:
+        //! Result of one worker count
+        struct Result {
+            uint32_t workerCount = 0;
+            //! Best of the repeats
+            double ms = 0.0;
+            double drawsPerSecond = 0.0;
+        };
+
+        //! Run every worker count and log the results, between BeginCmds and EndCmds outside of a render pass
+        //! \param rhi the RHI to record with
+        //! \param pipeline a ready graphics pipeline the draws bind
+        //! \param vertex vertex buffer the draws bind
+        //! \param colorFormat color attachment format the pipeline was made for
+        //! \param drawCount draws of the list
+        //! \param repeats runs per worker count, the fastest counts
+        //! \return results in worker count order, empty if a buffer failed to begin or end
+        static std::vector<Result> Run(GraphRHI& rhi, const Pipeline& pipeline, const BufferOpDescriptor& vertex,
+                                       ETextureFormat colorFormat, uint32_t drawCount, uint32_t repeats);
+    };
+} // Shift::gfx
+
+#endif //SHIFT_RECORDINGBENCHMARK_HPP
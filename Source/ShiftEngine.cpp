@@ -68,12 +68,25 @@ namespace Shift {
         m_engineData.fps = m_timer.GetFPSCurrent();
         m_engineData.secondsSinceStart = m_timer.GetSecondsSinceStart();
         m_engineData.frameTimeMs = m_timer.GetFrameTimeInMs();
+        m_engineData.gpuFrameTimeMs = m_renderer->GetGpuFrameTimeMs();
+        //! Swapped, the last vectors go back to be refilled
+        m_renderer->TakeGpuPassTimes(&m_engineData.gpuPassTimes);
+        m_renderer->TakeGpuPassStatistics(&m_engineData.gpuPassStatistics);
     }
 
     void ShiftEngine::HandleInput() {
         auto showFPS = m_timer.IsDebugFPSShow();
         if (showFPS.first) {
             spdlog::debug("Shift FPS: {}", showFPS.second);
+            spdlog::debug("GPU frame: {:.3f} ms", m_engineData.gpuFrameTimeMs);
+            for (const auto& pass: m_engineData.gpuPassTimes) {
+                spdlog::debug("{:>{}}{}: {:.3f} ms", "", 2 * (pass.depth + 1), pass.name, pass.ms);
+            }
+            for (const auto& pass: m_engineData.gpuPassStatistics) {
+                spdlog::debug("  {}: {} verts, {} prims ({} after clipping), {} VS / {} FS / {} CS invocations, {} samples",
+                              pass.name, pass.inputVertices, pass.inputPrimitives, pass.clippingPrimitives,
+                              pass.vertexInvocations, pass.fragmentInvocations, pass.computeInvocations, pass.samplesPassed);
+            }
         }
 
         if (inp::Mouse::GetInstance().isRightButtonPressed()) {
@@ -36,6 +36,18 @@ namespace Shift::Util {
     }
 
 
+    //! FNV-1a 64, fast and good enough for cache keys and corruption checks, not for anything adversarial
+    //! \param seed previous hash to chain multiple blocks together
+    [[nodiscard]] inline uint64_t HashFNV1a(const void* data, size_t size, uint64_t seed = 14695981039346656037ull) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
     //! TODO: Can be optimized!
     [[nodiscard]] std::vector<char> ReadFile(const std::string& filename);
 
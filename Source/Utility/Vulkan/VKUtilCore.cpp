@@ -61,10 +61,12 @@ namespace Shift::VK::Util {
             createInfo.pfnUserCallback = debugCallback;
         }
 
-        std::vector<const char*> GetRequiredExtensions() {
+        std::vector<const char*> GetRequiredExtensions(bool headless) {
             uint32_t glfwExtensionCount = 0;
-            const char** glfwExtensions;
-            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            const char** glfwExtensions = nullptr;
+            if (!headless) {
+                glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            }
 
             // Check whether the extensions are avalible in vulkan
             uint32_t vkExtensionCount = 0;
@@ -85,6 +87,14 @@ namespace Shift::VK::Util {
             return extensions;
         }
 
+        std::vector<const char*> GetDeviceExtensions(bool headless) {
+            std::vector<const char*> extensions = DEVICE_EXTENSIONS;
+            if (!headless) {
+                extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+            }
+            return extensions;
+        }
+
         //! Checks whether required GLFW extension is present in Vulkan and prints the info
         //! For now is stupid and expensive but is supposed to run at boot either way
         bool CheckForGLFWExtensionPresense(const char** glfwExtensions, uint32_t glfwExtensionCount, const std::vector<VkExtensionProperties>& vkExtensions) {
@@ -133,25 +143,34 @@ namespace Shift::VK::Util {
             vkGetPhysicalDeviceProperties(device, &deviceProperties);
             vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
 
-            int score = 0;
+            //! Anything suitable is at least 1, so a CPU device (lavapipe) is picked when there is no GPU at all
+            int score = 1;
 
             // Discrete GPUs have a significant performance advantage
             if (deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-                score += 2;
+                score += 3;
             } else if (deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) {
+                score += 2;
+            } else if (deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU) {
                 score += 1;
             }
 
+            bool headless = surface == VK_NULL_HANDLE;
+
             // TODO: Move this to separate function and add better device rating system
             if (!FindQueueFamilies(device, surface).isComplete()) {
                 return 0;
             }
 
-            if (!CheckDeviceExtensionSupport(device)) {
+            if (!CheckDeviceExtensionSupport(device, headless)) {
                 return 0;
             }
 
-            if (!QuerySwapChainSupport(device, surface).isComplete()) {
+            if (!CheckDeviceFeatureSupport(device)) {
+                return 0;
+            }
+
+            if (!headless && !QuerySwapChainSupport(device, surface).isComplete()) {
                 return 0;
             }
 
@@ -172,21 +191,34 @@ namespace Shift::VK::Util {
             // Find at least one queue that supports graphics commands
             int i = 0;
             for (const auto& queueFamily : queueFamilies) {
+                //! Compute families also have the transfer bit, they are picked here before the transfer check skips them
+                if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.computeFamily.has_value()) {
+                    indices.computeFamily = i;
+                }
                 if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
-                    indices.transferFamily = i++;
+                    //! A transfer only family wins over a compute one, so uploads and async compute get queues of their own
+                    if (!indices.transferFamily.has_value() || !(queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+                        indices.transferFamily = i;
+                    }
+                    ++i;
                     continue;
                 }
 
-                if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+                //! The loop runs on past a complete set while looking for compute, so the first ones found stay
+                if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.graphicsFamily.has_value()) {
                     indices.graphicsFamily = i;
                 }
                 // Fill presentation queue
                 VkBool32 presentSupport = false;
-                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
-                if (presentSupport) {
+                if (surface != VK_NULL_HANDLE) {
+                    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+                } else {
+                    presentSupport = indices.graphicsFamily == static_cast<uint32_t>(i);
+                }
+                if (presentSupport && !indices.presentFamily.has_value()) {
                     indices.presentFamily = i;
                 }
-                if (indices.isComplete()) {
+                if (indices.isComplete() && indices.computeFamily.has_value()) {
                     break;
                 }
                 ++i;
@@ -195,17 +227,21 @@ namespace Shift::VK::Util {
             if (!indices.transferFamily.has_value()) {
                 indices.transferFamily = indices.graphicsFamily;
             }
+            if (!indices.computeFamily.has_value()) {
+                indices.computeFamily = indices.graphicsFamily;
+            }
             return indices;
         }
 
-        bool CheckDeviceExtensionSupport(VkPhysicalDevice device) {
+        bool CheckDeviceExtensionSupport(VkPhysicalDevice device, bool headless) {
             uint32_t extensionCount;
             vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
 
             std::vector<VkExtensionProperties> availableExtensions(extensionCount);
             vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-            std::set<std::string> requiredExtensions(DEVICE_EXTENSIONS.begin(), DEVICE_EXTENSIONS.end());
+            std::vector<const char*> deviceExtensions = GetDeviceExtensions(headless);
+            std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
 
             for (const auto& extension : availableExtensions) {
                 requiredExtensions.erase(extension.extensionName);
@@ -214,6 +250,29 @@ namespace Shift::VK::Util {
             return requiredExtensions.empty();
         }
 
+        bool CheckDeviceFeatureSupport(VkPhysicalDevice device) {
+            VkPhysicalDeviceSynchronization2FeaturesKHR sync2Features{};
+            sync2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+            VkPhysicalDeviceVulkan12Features vulkan12Features{};
+            vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            vulkan12Features.pNext = &sync2Features;
+            VkPhysicalDeviceFeatures2 features{};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features.pNext = &vulkan12Features;
+            vkGetPhysicalDeviceFeatures2(device, &features);
+
+            return vulkan12Features.timelineSemaphore &&
+                   vulkan12Features.descriptorIndexing &&
+                   vulkan12Features.runtimeDescriptorArray &&
+                   vulkan12Features.descriptorBindingPartiallyBound &&
+                   vulkan12Features.descriptorBindingUpdateUnusedWhilePending &&
+                   vulkan12Features.descriptorBindingSampledImageUpdateAfterBind &&
+                   vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind &&
+                   vulkan12Features.shaderSampledImageArrayNonUniformIndexing &&
+                   vulkan12Features.shaderStorageBufferArrayNonUniformIndexing &&
+                   sync2Features.synchronization2;
+        }
+
         SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface) {
             SwapChainSupportDetails details;
             // Get surface capabilities
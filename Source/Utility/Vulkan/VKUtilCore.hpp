@@ -18,10 +18,11 @@ namespace Shift::VK::Util {
             "VK_LAYER_KHRONOS_validation"
     };
 
+    //! Required by every device, VK_KHR_swapchain comes on top unless headless
     const std::vector<const char*> DEVICE_EXTENSIONS = {
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME,
             VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
-            VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME
+            VK_EXT_HOST_QUERY_RESET_EXTENSION_NAME,
+            VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME
     };
 
     static constexpr float DEFAULT_QUEUE_PRIORITY = 1.0f;
@@ -33,6 +34,8 @@ namespace Shift::VK::Util {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
         std::optional<uint32_t> transferFamily;
+        //! A family with compute and no graphics for async compute, the graphics one when the GPU has none
+        std::optional<uint32_t> computeFamily;
 
         bool isComplete() {
             return graphicsFamily.has_value() && presentFamily.has_value() && transferFamily.has_value();
@@ -98,7 +101,12 @@ namespace Shift::VK::Util {
     }
 
     //! Get the extensions required for Vulkan Instance
-    std::vector<const char*> GetRequiredExtensions();
+    //! \param headless no window, so none of the GLFW surface extensions (GLFW isn't even initialized)
+    std::vector<const char*> GetRequiredExtensions(bool headless);
+
+    //! Get the extensions required for a device
+    //! \param headless no surface, so no swapchain
+    std::vector<const char*> GetDeviceExtensions(bool headless);
 
     //! Checks whether required GLFW extension is present in Vulkan and prints the info
     //! For now is stupid and expensive but is supposed to run at boot either way
@@ -116,12 +124,16 @@ namespace Shift::VK::Util {
 
     // TODO: Location of these functions is sus
     //! This function rates the GPU by what features it supports, for now only looks and whether it is discrete, can run graphics commands, etc.
+    //! Software devices (lavapipe) are suitable but rate below any GPU. VK_NULL_HANDLE surface for headless
     int RateDeviceSuitability(VkPhysicalDevice device, VkSurfaceKHR surface);
     //! Here we just find the queue that supports graphics commands
     //! TODO: You can add logic to prefer a single queue family that supports the most features to increase performance
+    //! Headless (VK_NULL_HANDLE surface) has the graphics family as the present one, nothing is presented on it
     QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface);
     //! Check is all the device extensiona from the vector are supported
-    bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
+    bool CheckDeviceExtensionSupport(VkPhysicalDevice device, bool headless);
+    //! Check the 1.2 features the device gets created with (timeline semaphores, descriptor indexing)
+    bool CheckDeviceFeatureSupport(VkPhysicalDevice device);
     SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface);
 
     //! UTILITY
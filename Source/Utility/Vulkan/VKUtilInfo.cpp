@@ -31,10 +31,10 @@ namespace Shift::VK::Util {
         return semaphoreInfo;
     }
 
-    VkCommandPoolCreateInfo CreateCommandPoolInfo(uint32_t queueFamilyIndex) {
+    VkCommandPoolCreateInfo CreateCommandPoolInfo(uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags) {
         VkCommandPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.flags = flags;
         poolInfo.queueFamilyIndex = queueFamilyIndex;
 
         return poolInfo;
@@ -71,7 +71,7 @@ namespace Shift::VK::Util {
         return submitInfo;
     }
 
-    VkShaderModuleCreateInfo CreateShaderModuleInfo(const std::span<char>& code) {
+    VkShaderModuleCreateInfo CreateShaderModuleInfo(std::span<const char> code) {
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
         createInfo.codeSize = code.size();
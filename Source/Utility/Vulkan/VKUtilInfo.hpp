@@ -31,8 +31,8 @@ namespace Shift::VK::Util {
     //! Create info for semaphore, basically empty struct wrapper
     VkSemaphoreCreateInfo CreateSemaphoreInfo();
 
-    //! TODO: Currently flags are hardcoded
-    VkCommandPoolCreateInfo CreateCommandPoolInfo(uint32_t queueFamilyIndex);
+    //! Create info for a command pool, by default the buffers can be reset individually
+    VkCommandPoolCreateInfo CreateCommandPoolInfo(uint32_t queueFamilyIndex, VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
 
     VkCommandBufferBeginInfo CreateBeginCommandBufferInfo(VkCommandBufferUsageFlags flags);
 
@@ -44,7 +44,7 @@ namespace Shift::VK::Util {
             const VkPipelineStageFlags* pipelineWaitStageMask
     );
 
-    VkShaderModuleCreateInfo CreateShaderModuleInfo(const std::span<char>& code);
+    VkShaderModuleCreateInfo CreateShaderModuleInfo(std::span<const char> code);
 
     VkPipelineVertexInputStateCreateInfo CreateInputStateInfo(const std::span<VkVertexInputAttributeDescription>& attDesc, const std::span<VkVertexInputBindingDescription>& bindDesc);
 
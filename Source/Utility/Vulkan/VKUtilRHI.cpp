@@ -295,6 +295,37 @@ namespace Shift::VK::Util {
         return static_cast<VkPipelineStageFlags>(static_cast<uint32_t>(flags));
     }
 
+    VkPipelineStageFlags2KHR ShiftToVKPipelineStageFlags2(EPipelineStageFlags flags) {
+        //! The lower bits are the same, top and bottom of pipe are deprecated in sync2 and mean "nothing" in a scope anyway
+        VkPipelineStageFlags2KHR stages = ShiftToVKPipelineStageFlags(flags);
+        return stages & ~(VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR | VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT_KHR);
+    }
+
+    VkAccessFlags2KHR ShiftToVKBufferAccess(EBufferAccess access) {
+        switch (access) {
+            case EBufferAccess::VertexRead:
+                return VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR;
+            case EBufferAccess::IndexRead:
+                return VK_ACCESS_2_INDEX_READ_BIT_KHR;
+            case EBufferAccess::UniformRead:
+                return VK_ACCESS_2_UNIFORM_READ_BIT_KHR;
+            case EBufferAccess::IndirectRead:
+                return VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR;
+            case EBufferAccess::ShaderRead:
+                return VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR;
+            case EBufferAccess::ShaderWrite:
+                return VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR;
+            case EBufferAccess::TransferRead:
+                return VK_ACCESS_2_TRANSFER_READ_BIT_KHR;
+            case EBufferAccess::TransferWrite:
+                return VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+            case EBufferAccess::HostRead:
+                return VK_ACCESS_2_HOST_READ_BIT_KHR;
+            default:
+                return VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+        }
+    }
+
     //! TODO [FEATURE] only float clear color is supported for now!
     VkClearValue ShiftToVKClearColor(const AttachmentClearValue &src) {
         VkClearValue dst{};
@@ -312,6 +343,56 @@ namespace Shift::VK::Util {
         return dst;
     }
 
+    uint32_t GetFormatCopySize(VkFormat format, VkImageAspectFlags aspect) {
+        //! The stencil of every combined format is copied as tightly packed bytes, the depth of D24 as 32 bits
+        if (aspect == VK_IMAGE_ASPECT_STENCIL_BIT) {
+            return (format == VK_FORMAT_S8_UINT || (format >= VK_FORMAT_D16_UNORM_S8_UINT && format <= VK_FORMAT_D32_SFLOAT_S8_UINT)) ? 1 : 0;
+        }
+        if (aspect == VK_IMAGE_ASPECT_DEPTH_BIT) {
+            switch (format) {
+                case VK_FORMAT_D16_UNORM:
+                case VK_FORMAT_D16_UNORM_S8_UINT:
+                    return 2;
+                case VK_FORMAT_X8_D24_UNORM_PACK32:
+                case VK_FORMAT_D32_SFLOAT:
+                case VK_FORMAT_D24_UNORM_S8_UINT:
+                case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                    return 4;
+                default:
+                    return 0;
+            }
+        }
+        if (aspect != VK_IMAGE_ASPECT_COLOR_BIT || format == VK_FORMAT_UNDEFINED) { return 0; }
+        if (format == VK_FORMAT_B10G11R11_UFLOAT_PACK32 || format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32) { return 4; }
+
+        //! The plain color formats are ordered by size in the core enum, R4G4 up to R64G64B64A64
+        struct SizeRange { VkFormat last; uint32_t size; };
+        static constexpr SizeRange ranges[] = {
+            {VK_FORMAT_R4G4_UNORM_PACK8, 1},
+            {VK_FORMAT_A1R5G5B5_UNORM_PACK16, 2},
+            {VK_FORMAT_R8_SRGB, 1},
+            {VK_FORMAT_R8G8_SRGB, 2},
+            {VK_FORMAT_B8G8R8_SRGB, 3},
+            {VK_FORMAT_A2B10G10R10_SINT_PACK32, 4},
+            {VK_FORMAT_R16_SFLOAT, 2},
+            {VK_FORMAT_R16G16_SFLOAT, 4},
+            {VK_FORMAT_R16G16B16_SFLOAT, 6},
+            {VK_FORMAT_R16G16B16A16_SFLOAT, 8},
+            {VK_FORMAT_R32_SFLOAT, 4},
+            {VK_FORMAT_R32G32_SFLOAT, 8},
+            {VK_FORMAT_R32G32B32_SFLOAT, 12},
+            {VK_FORMAT_R32G32B32A32_SFLOAT, 16},
+            {VK_FORMAT_R64_SFLOAT, 8},
+            {VK_FORMAT_R64G64_SFLOAT, 16},
+            {VK_FORMAT_R64G64B64_SFLOAT, 24},
+            {VK_FORMAT_R64G64B64A64_SFLOAT, 32}
+        };
+        for (const SizeRange& range: ranges) {
+            if (format <= range.last) { return range.size; }
+        }
+        return 0;
+    }
+
     //!-------------------------------------VKTOShift-------------------------------------!//
 
     ETextureType VKToShiftTextureType(VkImageType type) {
@@ -7,6 +7,7 @@
 
 #include <vulkan/vulkan.h>
 
+#include "Graphics/RHI/Buffer.hpp"
 #include "Graphics/RHI/Texture.hpp"
 #include "Graphics/RHI/TextureFormat.hpp"
 #include "Graphics/RHI/Sampler.hpp"
@@ -189,6 +190,16 @@ namespace Shift::VK::Util {
     //! @return
     VkPipelineStageFlags ShiftToVKPipelineStageFlags(EPipelineStageFlags flags);
 
+    //! Convert EPipelineStageFlags to synchronization2 stages, top and bottom of pipe become NONE
+    //! \param flags The pipeline stage flags to convert
+    //! \return The corresponding VkPipelineStageFlags2KHR
+    VkPipelineStageFlags2KHR ShiftToVKPipelineStageFlags2(EPipelineStageFlags flags);
+
+    //! Create synchronization2 access flags from EBufferAccess
+    //! \param access The buffer access to convert
+    //! \return The corresponding VkAccessFlags2KHR
+    VkAccessFlags2KHR ShiftToVKBufferAccess(EBufferAccess access);
+
     VkClearValue ShiftToVKClearColor(const AttachmentClearValue& src);
 
     VkClearValue ShiftToVKClearDepthStencil(const AttachmentClearValue& src);
@@ -196,6 +207,12 @@ namespace Shift::VK::Util {
     inline VkOffset2D ShiftToVKOffset2D(const Offset2D& src) { return { src.x, src.y }; }
     inline VkExtent2D ShiftToVKExtent2D(const Extent2D& src) { return { src.x, src.y }; }
 
+    //! Bytes a texel of one aspect takes in a buffer<->image copy, the depth and stencil of combined formats are copied apart
+    //! \param format The image format
+    //! \param aspect A single aspect of the format
+    //! \return The texel size, 0 for block compressed and other formats without a plain texel size
+    uint32_t GetFormatCopySize(VkFormat format, VkImageAspectFlags aspect);
+
     //!-------------------------------------VKTOShift-------------------------------------!//
 
     //! Create an ETextureType from a VkImageType